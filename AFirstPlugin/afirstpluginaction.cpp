@@ -34,9 +34,9 @@ Include files
 /**
 **/
 DzAFirstPluginAction::DzAFirstPluginAction() :
-DzEditAction( "Hello Action", "Test the Hello action" ) {
+DzEditAction( "Batch Scene Report", "Load every scene in a folder and write a report of their statistics" ) {
 	/**
-	Create a new action with the menu text "Hello" and description "Test the Hello action"
+	Create a new action with the menu text "Batch Scene Report"
 	**/
 }
 
@@ -44,7 +44,8 @@ DzEditAction( "Hello Action", "Test the Hello action" ) {
 **/
 void DzAFirstPluginAction::executeAction() {
 	/**
-	When the action is activated, use the DzAFirstPluginDlg class to display a dialog
+	When the action is activated, use the DzAFirstPluginDlg class to display the
+	batch dialog. The batch runs from inside the dialog.
 	**/
 
 	// Check if the main window has been created yet.
@@ -57,17 +58,9 @@ void DzAFirstPluginAction::executeAction() {
 		return;
 	}
 
-	// Create and show the dialog. If the user cancels, exit early,
-	// otherwise continue on and do the thing that required modal
-	// input from the user.
+	// Create and show the dialog. The user picks the folder and runs the
+	// batch from it, as many times as needed, then closes it.
 	DzAFirstPluginDlg *dlg = new DzAFirstPluginDlg( mw );
-	if( dlg->exec() != QDialog::Accepted ) {
-		QMessageBox::information( dzApp->getDialogParent(), tr("Information"),
-			tr("The dialog was rejected."), QMessageBox::Ok );
-
-		return;
-	}
-
-	QMessageBox::information( dzApp->getDialogParent(), tr("Information"),
-		tr("The dialog was accepted."), QMessageBox::Ok );
+	dlg->exec();
+	delete dlg;
 }
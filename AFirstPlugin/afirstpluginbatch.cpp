@@ -0,0 +1,275 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFuture>
+#include <QtCore/QRegExp>
+#include <QtCore/QTextStream>
+#include <QtCore/QUrl>
+#include <QtCore/QtConcurrentRun>
+
+#include "dzapp.h"
+#include "dzcontentmgr.h"
+#include "dzfacetmesh.h"
+#include "dzobject.h"
+#include "dzscene.h"
+#include "dzshape.h"
+
+#include "afirstpluginbatch.h"
+
+/*****************************
+Local definitions
+*****************************/
+// Size of the reads used to pull a file into the page cache
+static const int c_prefetchChunk = 1024 * 1024;
+
+/**
+	Read a whole file and throw the data away, leaving it in the OS page cache.
+	If text is not NULL it receives the contents as well.
+**/
+static bool readFile( const QString &fileName, QByteArray *text ) {
+	QFile file( fileName );
+	if( !file.open( QIODevice::ReadOnly ) ) {
+		return false;
+	}
+
+	QByteArray chunk;
+	while( !file.atEnd() ) {
+		chunk = file.read( c_prefetchChunk );
+		if( chunk.isEmpty() ) {
+			break;
+		}
+		if( text ) {
+			text->append( chunk );
+		}
+	}
+	return true;
+}
+
+/**
+	Quote a value for the CSV report
+**/
+static QString csvQuote( const QString &value ) {
+	QString quoted = value;
+	quoted.replace( "\"", "\"\"" );
+	return QString( "\"%1\"" ).arg( quoted );
+}
+
+///////////////////////////////////////////////////////////////////////
+// DzAFirstPluginBatch
+///////////////////////////////////////////////////////////////////////
+
+/**
+**/
+DzAFirstPluginBatch::DzAFirstPluginBatch( QObject *parent ) :
+QObject( parent ), m_running( false ), m_canceled( false ) {
+}
+
+/**
+	The scene files in folder, sorted by path
+**/
+QStringList DzAFirstPluginBatch::findScenes( const QString &folder, bool recursive ) {
+	QStringList filters;
+	filters << "*.duf" << "*.daz";
+
+	QStringList scenes;
+	QDirIterator it( folder, filters, QDir::Files,
+		recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags );
+	while( it.hasNext() ) {
+		scenes.append( it.next() );
+	}
+	scenes.sort();
+	return scenes;
+}
+
+/**
+	Runs on a worker thread : reads the scene file and every asset file it
+	references that is not in skip. Returns the asset files that were read.
+
+	Asset references are found by looking for "url" members in uncompressed
+	.duf files; compressed scenes and .daz files only have the scene file itself
+	read ahead.
+**/
+QStringList DzAFirstPluginBatch::prefetchScene( const QString &fileName, const QStringList &contentDirs,
+	const QSet<QString> &skip ) {
+	QStringList read;
+	QByteArray text;
+	if( !readFile( fileName, &text ) || !text.trimmed().startsWith( '{' ) ) {
+		return read;
+	}
+
+	QSet<QString> seen;
+	QRegExp urlExp( "\"url\"\\s*:\\s*\"([^\"]+)\"" );
+	QString contents = QString::fromUtf8( text.constData(), text.size() );
+	text.clear();
+
+	int pos = 0;
+	while( ( pos = urlExp.indexIn( contents, pos ) ) != -1 ) {
+		pos += urlExp.matchedLength();
+
+	  // Drop the fragment that names the item inside the asset file
+		QString path = urlExp.cap( 1 ).section( '#', 0, 0 );
+		if( path.isEmpty() ) {
+			continue;	// Reference within the scene file
+		}
+		path = QUrl::fromPercentEncoding( path.toUtf8() );
+		if( seen.contains( path ) ) {
+			continue;
+		}
+		seen.insert( path );
+
+		for( int i = 0; i < contentDirs.count(); i++ ) {
+			QString assetFile = QDir::cleanPath( contentDirs[i] + "/" + path );
+			if( skip.contains( assetFile ) ) {
+				break;
+			}
+			if( readFile( assetFile, NULL ) ) {
+				read.append( assetFile );
+				break;
+			}
+		}
+	}
+	return read;
+}
+
+/**
+**/
+void DzAFirstPluginBatch::cancel() {
+	m_canceled = true;
+}
+
+/**
+	Count what the scene that was just loaded contains
+**/
+void DzAFirstPluginBatch::analyzeScene( DzBatchSceneStats &stats ) {
+	stats.numNodes = dzScene->getNumNodes();
+	stats.numLights = dzScene->getNumLights();
+	stats.numCameras = dzScene->getNumCameras();
+
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		DzObject	*obj = node->getObject();
+		DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
+		DzGeometry	*geom = shape ? shape->getGeometry() : NULL;
+		if( geom == NULL ) {
+			continue;
+		}
+
+		stats.numVerts += geom->getNumVertices();
+		stats.numMaterials += shape->getNumMaterials();
+		DzFacetMesh *mesh = qobject_cast<DzFacetMesh*>( geom );
+		if( mesh ) {
+			stats.numFacets += mesh->getNumFacets();
+		}
+	}
+}
+
+/**
+	Process the scenes in order, writing one report row per scene as it
+	finishes, then reopen the scene that was open before. Returns false if a
+	batch is already running, the open scene has unsaved changes, the report
+	could not be written or the batch was canceled.
+**/
+bool DzAFirstPluginBatch::run( const QStringList &scenes, const QString &reportFile ) {
+	if( m_running || dzScene->needsSave() ) {
+		return false;
+	}
+	QString original = dzScene->getFilename();
+
+	QFile file( reportFile );
+	if( !file.open( QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text ) ) {
+		return false;
+	}
+	QTextStream out( &file );
+	out << "Scene,Loaded,Load ms,Analyze ms,Nodes,Lights,Cameras,Vertices,Facets,Materials\n";
+
+	// The content directories the asset references are relative to
+	QStringList contentDirs;
+	DzContentMgr *contentMgr = dzApp->getContentMgr();
+	for( int i = 0, n = contentMgr->getNumContentDirectories(); i < n; i++ ) {
+		contentDirs.append( contentMgr->getContentDirectoryPath( i ) );
+	}
+
+	m_running = true;
+	m_canceled = false;
+
+	QElapsedTimer clock;
+	clock.start();
+	QSet<QString> prefetched;
+	QFuture<QStringList> prefetch;
+	if( !scenes.isEmpty() ) {
+		prefetch = QtConcurrent::run( prefetchScene, scenes[0], contentDirs, prefetched );
+	}
+
+	int i;
+	for( i = 0; i < scenes.count() && !m_canceled; i++ ) {
+		emit sceneStarted( i, scenes[i] );
+
+		// This scene's prefetch normally finished while the previous scene was
+		// being processed. Start on the next one before loading this one.
+		prefetch.waitForFinished();
+		prefetched.unite( prefetch.result().toSet() );
+		if( i + 1 < scenes.count() ) {
+			prefetch = QtConcurrent::run( prefetchScene, scenes[i + 1], contentDirs, prefetched );
+		}
+
+		DzBatchSceneStats stats;
+		stats.fileName = scenes[i];
+		QElapsedTimer timer;
+		timer.start();
+		stats.loaded = dzScene->loadScene( scenes[i], DzScene::OpenNew ) == DZ_NO_ERROR;
+		stats.loadMsecs = timer.restart();
+		if( stats.loaded ) {
+			analyzeScene( stats );
+		}
+		stats.analyzeMsecs = timer.elapsed();
+
+		out << csvQuote( QDir::toNativeSeparators( stats.fileName ) ) << ","
+			<< ( stats.loaded ? "yes" : "no" ) << ","
+			<< stats.loadMsecs << "," << stats.analyzeMsecs << ","
+			<< stats.numNodes << "," << stats.numLights << "," << stats.numCameras << ","
+			<< stats.numVerts << "," << stats.numFacets << "," << stats.numMaterials << "\n";
+		out.flush();
+
+		double minutes = clock.elapsed() / 60000.0;
+		emit progress( i + 1, scenes.count(), minutes > 0 ? ( i + 1 ) / minutes : 0.0 );
+
+		// Let the dialog repaint and see the cancel button
+		QCoreApplication::processEvents();
+	}
+
+	prefetch.waitForFinished();
+
+	// Put back the scene the artist had open; it was saved, or never changed
+	if( original.isEmpty() ) {
+		dzScene->clear();
+	} else {
+		dzScene->loadScene( original, DzScene::OpenNew );
+	}
+	m_running = false;
+	return !m_canceled;
+}
@@ -0,0 +1,95 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef A_FIRST_PLUGIN_BATCH_H
+#define A_FIRST_PLUGIN_BATCH_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	What the batch learned about one scene file
+**/
+struct DzBatchSceneStats {
+	QString	fileName;
+	bool	loaded;
+	qint64	loadMsecs;
+	qint64	analyzeMsecs;
+	int		numNodes;
+	int		numLights;
+	int		numCameras;
+	int		numVerts;
+	int		numFacets;
+	int		numMaterials;
+
+	DzBatchSceneStats() : loaded( false ), loadMsecs( 0 ), analyzeMsecs( 0 ), numNodes( 0 ),
+		numLights( 0 ), numCameras( 0 ), numVerts( 0 ), numFacets( 0 ), numMaterials( 0 ) {}
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Loads every scene in a folder, gathers its statistics and appends them to a
+	CSV report.
+
+	Scenes have to be loaded on the GUI thread, one at a time. To keep the disk
+	busy while a scene is being loaded and analyzed, the next scene file and the
+	asset files it references are read on a background thread, so that they are
+	already in the OS page cache when their turn comes.
+
+	Each scene replaces the open one, so the batch only starts when the open
+	scene has no unsaved changes, and reopens it once the batch is done.
+**/
+class DzAFirstPluginBatch : public QObject {
+	Q_OBJECT
+public:
+
+	/** Constructor **/
+	DzAFirstPluginBatch( QObject *parent = NULL );
+
+	static QStringList	findScenes( const QString &folder, bool recursive );
+	static QStringList	prefetchScene( const QString &fileName, const QStringList &contentDirs,
+							const QSet<QString> &skip );
+
+	bool	run( const QStringList &scenes, const QString &reportFile );
+	bool	isRunning() const { return m_running; }
+
+public slots:
+
+	void	cancel();
+
+signals:
+
+	void	sceneStarted( int which, const QString &fileName );
+	void	progress( int numDone, int numScenes, double scenesPerMinute );
+
+private:
+	void	analyzeScene( DzBatchSceneStats &stats );
+
+	bool	m_running;
+	bool	m_canceled;
+};
+
+#endif // A_FIRST_PLUGIN_BATCH_H
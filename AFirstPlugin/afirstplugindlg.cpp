@@ -18,9 +18,16 @@ information about the DAZ Studio SDK.
 /*****************************
 Include files
 *****************************/
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtGui/QCheckBox>
+#include <QtGui/QFileDialog>
 #include <QtGui/QLayout>
 #include <QtGui/QLabel>
+#include <QtGui/QLineEdit>
+#include <QtGui/QMessageBox>
 #include <QtGui/QGroupBox>
+#include <QtGui/QProgressBar>
 #include <QtGui/QPushButton>
 #include <QtGui/QToolTip>
 #include <QtGui/QWhatsThis>
@@ -30,13 +37,16 @@ Include files
 #include "dzmainwindow.h"
 #include "dzactionmgr.h"
 #include "dzaction.h"
+#include "dzscene.h"
 
+#include "afirstpluginbatch.h"
 #include "afirstplugindlg.h"
 
 /*****************************
 Local definitions
 *****************************/
 #define A_FIRST_PLUGIN_NAME		"AFirstPlugin"
+#define A_FIRST_PLUGIN_REPORT	"SceneReport.csv"
 
 ///////////////////////////////////////////////////////////////////////
 // DzAFirstPluginDlg
@@ -52,19 +62,180 @@ DzBasicDialog( parent, A_FIRST_PLUGIN_NAME ) {
 	int btnMinWidth = style()->pixelMetric( DZ_PM_ButtonMinWidth );
 
 	// Set the dialog title
-	setWindowTitle( tr("A First Plugin") );
+	setWindowTitle( tr("Batch Scene Report") );
 
-	//... more widgets/layouts here
-	QLabel *lbl = new QLabel( tr("Hello, World!"), this );
-	lbl->setObjectName( QString("%1DlgHelloWorldLbl").arg( A_FIRST_PLUGIN_NAME ) );
-	lbl->setFixedHeight( wgtHeight );
-	lbl->setMinimumWidth( btnMinWidth );
+	m_batch = new DzAFirstPluginBatch( this );
+	connect( m_batch, SIGNAL(sceneStarted(int, const QString &)),
+		this, SLOT(sceneStarted(int, const QString &)) );
+	connect( m_batch, SIGNAL(progress(int, int, double)),
+		this, SLOT(updateProgress(int, int, double)) );
 
-	// Add the widget to the basic dialog
-	addWidget( lbl );
+	// The folder of scenes to process
+	QGroupBox *folderGrp = new QGroupBox( tr("Scene Folder"), this );
+	m_folderGrp = folderGrp;
+	folderGrp->setObjectName( QString("%1DlgFolderGrp").arg( A_FIRST_PLUGIN_NAME ) );
+	QGridLayout *folderLyt = new QGridLayout( folderGrp );
+	folderLyt->setMargin( margin );
+	folderLyt->setSpacing( margin );
 
-	// Make the dialog fit its contents, with a minimum width, and lock it down
-	resize( QSize( 300, 0 ).expandedTo(minimumSizeHint()) );
-	setFixedWidth( width() );
-	setFixedHeight( height() );
+	m_folderEdit = new QLineEdit( folderGrp );
+	m_folderEdit->setObjectName( QString("%1DlgFolderEdit").arg( A_FIRST_PLUGIN_NAME ) );
+	m_folderEdit->setFixedHeight( wgtHeight );
+	folderLyt->addWidget( m_folderEdit, 0, 0 );
+
+	QPushButton *browseBtn = new QPushButton( "...", folderGrp );
+	browseBtn->setObjectName( QString("%1DlgBrowseBtn").arg( A_FIRST_PLUGIN_NAME ) );
+	browseBtn->setFixedHeight( wgtHeight );
+	connect( browseBtn, SIGNAL(clicked()), this, SLOT(browse()) );
+	folderLyt->addWidget( browseBtn, 0, 1 );
+
+	m_recursiveCheck = new QCheckBox( tr("Include Subfolders"), folderGrp );
+	m_recursiveCheck->setObjectName( QString("%1DlgRecursiveChk").arg( A_FIRST_PLUGIN_NAME ) );
+	folderLyt->addWidget( m_recursiveCheck, 1, 0, 1, 2 );
+
+	m_runBtn = new QPushButton( tr("Run"), folderGrp );
+	m_runBtn->setObjectName( QString("%1DlgRunBtn").arg( A_FIRST_PLUGIN_NAME ) );
+	m_runBtn->setFixedHeight( wgtHeight );
+	m_runBtn->setMinimumWidth( btnMinWidth );
+	connect( m_runBtn, SIGNAL(clicked()), this, SLOT(runBatch()) );
+	folderLyt->addWidget( m_runBtn, 2, 0, 1, 2, Qt::AlignRight );
+
+	addWidget( folderGrp );
+
+	// Progress of the batch
+	m_progressBar = new QProgressBar( this );
+	m_progressBar->setObjectName( QString("%1DlgProgressBar").arg( A_FIRST_PLUGIN_NAME ) );
+	m_progressBar->setRange( 0, 1 );
+	m_progressBar->setValue( 0 );
+	addWidget( m_progressBar );
+
+	m_statusLbl = new QLabel( tr("Choose a folder of scenes to process."), this );
+	m_statusLbl->setObjectName( QString("%1DlgStatusLbl").arg( A_FIRST_PLUGIN_NAME ) );
+	m_statusLbl->setMinimumWidth( btnMinWidth );
+	addWidget( m_statusLbl );
+
+	m_throughputLbl = new QLabel( this );
+	m_throughputLbl->setObjectName( QString("%1DlgThroughputLbl").arg( A_FIRST_PLUGIN_NAME ) );
+	m_throughputLbl->setFixedHeight( wgtHeight );
+	addWidget( m_throughputLbl );
+
+	// Make the dialog fit its contents, with a minimum width
+	resize( QSize( 400, 0 ).expandedTo(minimumSizeHint()) );
+}
+
+/**
+**/
+void DzAFirstPluginDlg::browse() {
+	QString folder = QFileDialog::getExistingDirectory( this, tr("Select Scene Folder"),
+		m_folderEdit->text() );
+	if( !folder.isEmpty() ) {
+		m_folderEdit->setText( QDir::toNativeSeparators( folder ) );
+	}
+}
+
+/**
+	The batch loads each scene in place of the open one. If the open scene has
+	unsaved changes, ask to save it first; returns false if it is still unsaved.
+**/
+bool DzAFirstPluginDlg::saveCurrentScene() {
+	if( !dzScene->needsSave() ) {
+		return true;
+	}
+
+	int answer = QMessageBox::warning( this, windowTitle(),
+		tr("The current scene has unsaved changes. Each scene of the batch is "
+		"loaded in its place; the current scene is reopened when the batch is "
+		"done.\n\nSave the current scene and continue?"),
+		QMessageBox::Save | QMessageBox::Cancel, QMessageBox::Save );
+	if( answer != QMessageBox::Save ) {
+		return false;
+	}
+
+	DzMainWindow *mw = dzApp->getInterface();
+	DzAction *saveAction = mw ? mw->getActionMgr()->findAction( "DzSaveSceneAction" ) : NULL;
+	if( saveAction ) {
+		saveAction->trigger();
+	}
+	return !dzScene->needsSave();
+}
+
+/**
+**/
+void DzAFirstPluginDlg::runBatch() {
+	if( m_batch->isRunning() ) {
+		return;
+	}
+
+	QString folder = QDir::fromNativeSeparators( m_folderEdit->text().trimmed() );
+	if( folder.isEmpty() || !QDir( folder ).exists() ) {
+		m_statusLbl->setText( tr("The folder does not exist.") );
+		return;
+	}
+
+	QStringList scenes = DzAFirstPluginBatch::findScenes( folder, m_recursiveCheck->isChecked() );
+	if( scenes.isEmpty() ) {
+		m_statusLbl->setText( tr("No scenes were found in the folder.") );
+		return;
+	}
+
+	if( !saveCurrentScene() ) {
+		m_statusLbl->setText( tr("Canceled; the current scene has unsaved changes.") );
+		return;
+	}
+
+	// Nothing in the folder group may change while the batch runs
+	m_folderGrp->setEnabled( false );
+	m_progressBar->setRange( 0, scenes.count() );
+	m_progressBar->setValue( 0 );
+	m_throughputLbl->clear();
+
+	QString reportFile = QDir( folder ).filePath( A_FIRST_PLUGIN_REPORT );
+	bool done = m_batch->run( scenes, reportFile );
+
+	if( done ) {
+		m_statusLbl->setText( tr("Report written to %1").arg( QDir::toNativeSeparators( reportFile ) ) );
+	} else if( m_progressBar->value() == 0 ) {
+		m_statusLbl->setText( tr("Could not process the scenes or write the report.") );
+	} else {
+		m_statusLbl->setText( tr("Canceled; partial report written to %1")
+			.arg( QDir::toNativeSeparators( reportFile ) ) );
+	}
+	m_folderGrp->setEnabled( true );
+}
+
+/**
+**/
+void DzAFirstPluginDlg::sceneStarted( int which, const QString &fileName ) {
+	m_statusLbl->setText( tr("Scene %1 of %2 : %3")
+		.arg( which + 1 )
+		.arg( m_progressBar->maximum() )
+		.arg( QFileInfo( fileName ).fileName() ) );
+}
+
+/**
+**/
+void DzAFirstPluginDlg::updateProgress( int numDone, int numScenes, double scenesPerMinute ) {
+	m_progressBar->setMaximum( numScenes );
+	m_progressBar->setValue( numDone );
+	m_throughputLbl->setText( tr("%1 scenes per minute").arg( scenesPerMinute, 0, 'f', 1 ) );
+}
+
+/**
+**/
+void DzAFirstPluginDlg::accept() {
+	if( m_batch->isRunning() ) {
+		return;
+	}
+	DzBasicDialog::accept();
+}
+
+/**
+**/
+void DzAFirstPluginDlg::reject() {
+	if( m_batch->isRunning() ) {
+		m_statusLbl->setText( tr("Canceling after the current scene...") );
+		m_batch->cancel();
+		return;
+	}
+	DzBasicDialog::reject();
 }
@@ -27,18 +27,21 @@
 /****************************
    Forward declarations
 ****************************/
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QProgressBar;
+class QGroupBox;
 class QPushButton;
+class DzAFirstPluginBatch;
 
 /*****************************
    Class definitions
 *****************************/
 /**
-	Our plugin adds a new action class to DAZ Studio. Actions are menu and tool bar
-	entries that the user can click on. Creating a new action is the easiest way to 
-	extend the DAZ Studio interface from a plugin.
-	
-	Our new action inherits from DzEditAction so that it will automatically be added 
-	to the 'Edit' menu when the plugin is loaded the first time.
+	The dialog for the batch action. The user picks a folder of scenes and runs
+	the batch; the dialog shows the progress and the throughput in scenes per
+	minute while the scenes are processed.
 **/
 class DzAFirstPluginDlg : public DzBasicDialog {
 	Q_OBJECT
@@ -50,6 +53,33 @@ public:
 	/** Destructor **/
 	virtual ~DzAFirstPluginDlg(){}
 
+public slots:
+
+	/** Does nothing while a batch runs; the dialog stays open to show it **/
+	virtual void	accept();
+
+	/** Cancels a running batch instead of closing the dialog **/
+	virtual void	reject();
+
+private slots:
+
+	void	browse();
+	void	runBatch();
+	void	sceneStarted( int which, const QString &fileName );
+	void	updateProgress( int numDone, int numScenes, double scenesPerMinute );
+
+private:
+
+	bool	saveCurrentScene();
+
+	QGroupBox				*m_folderGrp;
+	QLineEdit				*m_folderEdit;
+	QCheckBox				*m_recursiveCheck;
+	QPushButton				*m_runBtn;
+	QProgressBar			*m_progressBar;
+	QLabel					*m_statusLbl;
+	QLabel					*m_throughputLbl;
+	DzAFirstPluginBatch		*m_batch;
 };
 
 #endif // A_FIRST_PLUGIN_DLG_H
\ No newline at end of file
@@ -0,0 +1,116 @@
+/****************************************************************************
+** Meta object code from reading C++ file 'afirstpluginbatch.h'
+**
+** Created: Sun Oct 18 22:03:16 2026
+**      by: The Qt Meta Object Compiler version 63 (Qt 4.8.1)
+**
+** WARNING! All changes made in this file will be lost!
+*****************************************************************************/
+
+#include "../afirstpluginbatch.h"
+#if !defined(Q_MOC_OUTPUT_REVISION)
+#error "The header file 'afirstpluginbatch.h' doesn't include <QObject>."
+#elif Q_MOC_OUTPUT_REVISION != 63
+#error "This file was generated using the moc from 4.8.1. It"
+#error "cannot be used with the include files from this version of Qt."
+#error "(The moc has changed too much.)"
+#endif
+
+QT_BEGIN_MOC_NAMESPACE
+static const uint qt_meta_data_DzAFirstPluginBatch[] = {
+
+ // content:
+       6,       // revision
+       0,       // classname
+       0,    0, // classinfo
+       3,   14, // methods
+       0,    0, // properties
+       0,    0, // enums/sets
+       0,    0, // constructors
+       0,       // flags
+       2,       // signalCount
+
+ // signals: signature, parameters, type, tag, flags
+      36,   21,   20,   20, 0x05,
+      96,   62,   20,   20, 0x05,
+
+ // slots: signature, parameters, type, tag, flags
+     121,   20,   20,   20, 0x0a,
+
+       0        // eod
+};
+
+static const char qt_meta_stringdata_DzAFirstPluginBatch[] = {
+    "DzAFirstPluginBatch\0\0which,fileName\0"
+    "sceneStarted(int,QString)\0"
+    "numDone,numScenes,scenesPerMinute\0"
+    "progress(int,int,double)\0cancel()\0"
+};
+
+void DzAFirstPluginBatch::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
+{
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        Q_ASSERT(staticMetaObject.cast(_o));
+        DzAFirstPluginBatch *_t = static_cast<DzAFirstPluginBatch *>(_o);
+        switch (_id) {
+        case 0: _t->sceneStarted((*reinterpret_cast< int(*)>(_a[1])), (*reinterpret_cast< const QString(*)>(_a[2]))); break;
+        case 1: _t->progress((*reinterpret_cast< int(*)>(_a[1])), (*reinterpret_cast< int(*)>(_a[2])), (*reinterpret_cast< double(*)>(_a[3]))); break;
+        case 2: _t->cancel(); break;
+        default: ;
+        }
+    }
+}
+
+const QMetaObjectExtraData DzAFirstPluginBatch::staticMetaObjectExtraData = {
+    0,  qt_static_metacall 
+};
+
+const QMetaObject DzAFirstPluginBatch::staticMetaObject = {
+    { &QObject::staticMetaObject, qt_meta_stringdata_DzAFirstPluginBatch,
+      qt_meta_data_DzAFirstPluginBatch, &staticMetaObjectExtraData }
+};
+
+#ifdef Q_NO_DATA_RELOCATION
+const QMetaObject &DzAFirstPluginBatch::getStaticMetaObject() { return staticMetaObject; }
+#endif //Q_NO_DATA_RELOCATION
+
+const QMetaObject *DzAFirstPluginBatch::metaObject() const
+{
+    return QObject::d_ptr->metaObject ? QObject::d_ptr->metaObject : &staticMetaObject;
+}
+
+void *DzAFirstPluginBatch::qt_metacast(const char *_clname)
+{
+    if (!_clname) return 0;
+    if (!strcmp(_clname, qt_meta_stringdata_DzAFirstPluginBatch))
+        return static_cast<void*>(const_cast< DzAFirstPluginBatch*>(this));
+    return QObject::qt_metacast(_clname);
+}
+
+int DzAFirstPluginBatch::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
+{
+    _id = QObject::qt_metacall(_c, _id, _a);
+    if (_id < 0)
+        return _id;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        if (_id < 3)
+            qt_static_metacall(this, _c, _id, _a);
+        _id -= 3;
+    }
+    return _id;
+}
+
+// SIGNAL 0
+void DzAFirstPluginBatch::sceneStarted(int _t1, const QString & _t2)
+{
+    void *_a[] = { 0, const_cast<void*>(reinterpret_cast<const void*>(&_t1)), const_cast<void*>(reinterpret_cast<const void*>(&_t2)) };
+    QMetaObject::activate(this, &staticMetaObject, 0, _a);
+}
+
+// SIGNAL 1
+void DzAFirstPluginBatch::progress(int _t1, int _t2, double _t3)
+{
+    void *_a[] = { 0, const_cast<void*>(reinterpret_cast<const void*>(&_t1)), const_cast<void*>(reinterpret_cast<const void*>(&_t2)), const_cast<void*>(reinterpret_cast<const void*>(&_t3)) };
+    QMetaObject::activate(this, &staticMetaObject, 1, _a);
+}
+QT_END_MOC_NAMESPACE
@@ -1,7 +1,7 @@
 /****************************************************************************
 ** Meta object code from reading C++ file 'afirstplugindlg.h'
 **
-** Created: Thu Mar 9 21:14:41 2017
+** Created: Sun Oct 18 20:59:14 2026
 **      by: The Qt Meta Object Compiler version 63 (Qt 4.8.1)
 **
 ** WARNING! All changes made in this file will be lost!
@@ -23,26 +23,47 @@ static const uint qt_meta_data_DzAFirstPluginDlg[] = {
        6,       // revision
        0,       // classname
        0,    0, // classinfo
-       0,    0, // methods
+       6,   14, // methods
        0,    0, // properties
        0,    0, // enums/sets
        0,    0, // constructors
        0,       // flags
        0,       // signalCount
 
+ // slots: signature, parameters, type, tag, flags
+      19,   18,   18,   18, 0x0a,
+      28,   18,   18,   18, 0x0a,
+      37,   18,   18,   18, 0x08,
+      46,   18,   18,   18, 0x08,
+      72,   57,   18,   18, 0x08,
+     132,   98,   18,   18, 0x08,
+
        0        // eod
 };
 
 static const char qt_meta_stringdata_DzAFirstPluginDlg[] = {
-    "DzAFirstPluginDlg\0"
+    "DzAFirstPluginDlg\0\0accept()\0reject()\0"
+    "browse()\0runBatch()\0which,fileName\0"
+    "sceneStarted(int,QString)\0"
+    "numDone,numScenes,scenesPerMinute\0"
+    "updateProgress(int,int,double)\0"
 };
 
 void DzAFirstPluginDlg::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
 {
-    Q_UNUSED(_o);
-    Q_UNUSED(_id);
-    Q_UNUSED(_c);
-    Q_UNUSED(_a);
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        Q_ASSERT(staticMetaObject.cast(_o));
+        DzAFirstPluginDlg *_t = static_cast<DzAFirstPluginDlg *>(_o);
+        switch (_id) {
+        case 0: _t->accept(); break;
+        case 1: _t->reject(); break;
+        case 2: _t->browse(); break;
+        case 3: _t->runBatch(); break;
+        case 4: _t->sceneStarted((*reinterpret_cast< int(*)>(_a[1])), (*reinterpret_cast< const QString(*)>(_a[2]))); break;
+        case 5: _t->updateProgress((*reinterpret_cast< int(*)>(_a[1])), (*reinterpret_cast< int(*)>(_a[2])), (*reinterpret_cast< double(*)>(_a[3]))); break;
+        default: ;
+        }
+    }
 }
 
 const QMetaObjectExtraData DzAFirstPluginDlg::staticMetaObjectExtraData = {
@@ -76,6 +97,11 @@ int DzAFirstPluginDlg::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
     _id = DzBasicDialog::qt_metacall(_c, _id, _a);
     if (_id < 0)
         return _id;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        if (_id < 6)
+            qt_static_metacall(this, _c, _id, _a);
+        _id -= 6;
+    }
     return _id;
 }
 QT_END_MOC_NAMESPACE
@@ -54,7 +54,9 @@ DZ_PLUGIN_DESCRIPTION( QString(
 					  "This plugin is a simple example provided with the DAZ Studio "
 					  "SDK. It provides developers an example of the basics with "
 					  "regard to project layout, subclassing DzAction, standard "
-					  "dialog creation and button layout."
+					  "dialog creation and button layout. The action loads every "
+					  "scene in a folder and writes a report of their statistics, "
+					  "reading the next scene's files ahead on a background thread."
 					  ).arg( dzApp->getDocumentationPath() ) );
 
 /**
@@ -0,0 +1,112 @@
+#!/usr/bin/env python
+"""
+Command line client for the Scene Info Ex stats server.
+
+Start the server from the pane's context menu (Start Stats Server), then:
+
+	sceneinfo_client.py totals
+	sceneinfo_client.py nodes materials
+	sceneinfo_client.py --subscribe
+
+Every frame is a 32-bit big-endian length followed by the payload. Requests
+are a single command word; replies and pushed deltas are JSON objects.
+"""
+
+import json
+import os
+import socket
+import struct
+import sys
+import tempfile
+
+DEFAULT_NAME = "DzSceneInfoEx"
+
+
+class Connection(object):
+	"""A connection to the server's local socket (a named pipe on Windows)"""
+
+	def __init__(self, name=DEFAULT_NAME):
+		if sys.platform == "win32":
+			self._pipe = open(r"\\.\pipe\%s" % name, "r+b", buffering=0)
+			self._sock = None
+		else:
+			self._sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+			self._sock.connect(os.path.join(tempfile.gettempdir(), name))
+			self._pipe = None
+
+	def close(self):
+		if self._sock:
+			self._sock.close()
+		if self._pipe:
+			self._pipe.close()
+
+	def _write(self, data):
+		if self._sock:
+			self._sock.sendall(data)
+		else:
+			self._pipe.write(data)
+
+	def _read(self, size):
+		data = b""
+		while len(data) < size:
+			if self._sock:
+				chunk = self._sock.recv(size - len(data))
+			else:
+				chunk = self._pipe.read(size - len(data))
+			if not chunk:
+				raise EOFError("server closed the connection")
+			data += chunk
+		return data
+
+	def send(self, command):
+		payload = command.encode("utf-8")
+		self._write(struct.pack(">I", len(payload)) + payload)
+
+	def receive(self):
+		(length,) = struct.unpack(">I", self._read(4))
+		return json.loads(self._read(length).decode("utf-8"))
+
+	def request(self, command):
+		self.send(command)
+		return self.receive()
+
+
+def main(argv):
+	args = argv[1:]
+	name = DEFAULT_NAME
+	if "--name" in args:
+		i = args.index("--name")
+		name = args[i + 1]
+		del args[i:i + 2]
+
+	conn = Connection(name)
+	try:
+		if "--subscribe" in args:
+			conn.send("subscribe")
+			while True:
+				frame = conn.receive()
+				if frame["type"] == "delta" and "totals" not in frame:
+					# A selection change only carries the selected node
+					print("%s : %s" % (frame["reason"], frame["selected"].get("label", "(none)")))
+				elif frame["type"] == "delta":
+					totals = frame["totals"]
+					print("%s : %d vertices, %d faces, +%d -%d ~%d nodes" % (
+						frame["reason"], totals["vertices"], totals["faces"],
+						len(frame["added"]), len(frame["removed"]), len(frame["changed"])))
+				else:
+					print(json.dumps(frame))
+		else:
+			for command in args or ["totals"]:
+				conn.send(command)
+				# A snapshot is the totals, nodes and materials frames in turn
+				for i in range(3 if command == "snapshot" else 1):
+					print(json.dumps(conn.receive(), indent=2, sort_keys=True))
+	except KeyboardInterrupt:
+		pass
+	finally:
+		conn.close()
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))
@@ -0,0 +1,209 @@
+#!/usr/bin/env python
+"""
+Reader for the binary geometry files written by the pane's Export Geometry
+command.
+
+	sceneinfo_geometry.py info scene.dzgeom
+	sceneinfo_geometry.py bench scene.dzgeom
+
+The file is mapped into memory and the arrays are views of the mapping, so
+nothing is copied until it is used. With numpy the arrays are numpy arrays
+(vertices are N x 3 float32, facets are N x 4 int32 with -1 as the fourth
+index of a triangle); without it they are flat memoryviews.
+
+	with GeometryFile("scene.dzgeom") as geo:
+		for node in geo.nodes:
+			print(node.label, node.vertices.shape)
+
+Arrays may be kept after the file is closed; the mapping is released once
+the last of them is gone.
+
+The bench command times a plain read and a mapped load of the file, then
+writes a file of the same size next to it the way the export does, in
+1 MB writes followed by a flush to disk, and removes it. The write rates
+compare with the two rates the Export Geometry dialog reports.
+
+The layout is documented in dzgeometryexport.h.
+"""
+
+import mmap
+import os
+import struct
+import sys
+import time
+
+try:
+	import numpy
+except ImportError:
+	numpy = None
+
+MAGIC = b"DZGEOBIN"
+VERSION = 1
+HEADER = struct.Struct("<8sIIII5Q")
+TOC_ENTRY = struct.Struct("<3Q10I")
+
+
+class Node(object):
+	"""One node's mesh; the arrays are views into the file mapping"""
+
+	def __init__(self, geo, entry):
+		(self.verts_offset, self.facets_offset, self.materials_offset,
+			self.num_verts, self.num_facets, self.num_materials,
+			label_offset, label_length, name_offset, name_length,
+			materials_offset, materials_length, _) = entry
+		self._geo = geo
+		self.label = geo._string(label_offset, label_length)
+		self.name = geo._string(name_offset, name_length)
+		names = geo._string(materials_offset, materials_length)
+		self.material_names = names.split("\0")[:-1] if names else []
+
+	@property
+	def vertices(self):
+		return self._geo._array(self.verts_offset, "f", self.num_verts, 3)
+
+	@property
+	def facets(self):
+		return self._geo._array(self.facets_offset, "i", self.num_facets, 4)
+
+	@property
+	def materials(self):
+		return self._geo._array(self.materials_offset, "i", self.num_facets, 1)
+
+
+class GeometryFile(object):
+	"""A geometry file mapped read-only into memory"""
+
+	def __init__(self, path):
+		self._file = open(path, "rb")
+		self._map = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+		self._view = memoryview(self._map)
+
+		fields = HEADER.unpack_from(self._map, 0)
+		(magic, version, header_size, toc_entry_size, num_nodes,
+			toc_offset, self.strings_offset, self.strings_size,
+			self.data_offset, self.file_size) = fields
+		if magic != MAGIC:
+			raise ValueError("%s is not a geometry file" % path)
+		if version != VERSION:
+			raise ValueError("%s has version %d, expected %d" % (path, version, VERSION))
+		if self.file_size > len(self._map):
+			raise ValueError("%s is truncated" % path)
+
+		self.nodes = []
+		for i in range(num_nodes):
+			entry = TOC_ENTRY.unpack_from(self._map, toc_offset + i * toc_entry_size)
+			self.nodes.append(Node(self, entry))
+
+	def close(self):
+		# Closing the mapping would fail while an array still uses it, so it
+		# is only dropped here and goes away with the last array
+		self.nodes = []
+		self._view = None
+		self._map = None
+		self._file.close()
+
+	def __enter__(self):
+		return self
+
+	def __exit__(self, *args):
+		self.close()
+
+	def _string(self, offset, length):
+		start = self.strings_offset + offset
+		return self._view[start:start + length].tobytes().decode("utf-8")
+
+	def _array(self, offset, code, count, width):
+		if self._map is None:
+			raise ValueError("the geometry file is closed")
+		if numpy is not None:
+			dtype = numpy.float32 if code == "f" else numpy.int32
+			array = numpy.frombuffer(self._map, dtype=dtype, count=count * width, offset=offset)
+			return array.reshape(count, width) if width > 1 else array
+		return self._view[offset:offset + count * width * 4].cast(code)
+
+
+def read_throughput(path, block=8 << 20):
+	"""Plain sequential read of the file, for comparison"""
+	buf = bytearray(block)
+	total = 0
+	start = time.time()
+	with open(path, "rb", buffering=0) as f:
+		while True:
+			n = f.readinto(buf)
+			if not n:
+				break
+			total += n
+	return total, time.time() - start
+
+
+def write_throughput(path, size, block=1 << 20):
+	"""Write size bytes to a new file in block-sized writes, then flush it to
+	disk, as the export does. Returns the seconds until the last write and
+	until the flush."""
+	buf = memoryview(bytearray(block))
+	start = time.time()
+	with open(path, "wb", buffering=0) as f:
+		left = size
+		while left > 0:
+			left -= f.write(buf[:min(block, left)])
+		written = time.time() - start
+		os.fsync(f.fileno())
+		synced = time.time() - start
+	os.remove(path)
+	return written, synced
+
+
+def _touch(array):
+	"""Read the array, and return a checksum and its size in bytes"""
+	if numpy is not None:
+		return int(array.view(numpy.int32).sum(dtype=numpy.int64)), array.nbytes
+	# Without numpy, touch one value per page
+	return sum(array[::1024]), array.nbytes
+
+
+def load_throughput(path):
+	"""Map the file and read every array once"""
+	start = time.time()
+	checksum = 0
+	total = 0
+	with GeometryFile(path) as geo:
+		for node in geo.nodes:
+			for name in ("vertices", "facets", "materials"):
+				value, size = _touch(getattr(node, name))
+				checksum += value
+				total += size
+	return total, time.time() - start, checksum
+
+
+def main(argv):
+	if len(argv) != 3 or argv[1] not in ("info", "bench"):
+		sys.stderr.write("usage: %s info|bench FILE\n" % argv[0])
+		return 2
+
+	command, path = argv[1:]
+	if command == "info":
+		with GeometryFile(path) as geo:
+			print("%d nodes, %d bytes" % (len(geo.nodes), geo.file_size))
+			for node in geo.nodes:
+				print("%s : %d vertices, %d facets, %d materials" % (
+					node.label, node.num_verts, node.num_facets, node.num_materials))
+		return 0
+
+	# Run the plain read first so both measure the same cache state; drop
+	# the OS file cache beforehand to measure the disk rather than memory
+	size, secs = read_throughput(path)
+	print("read : %.1f MB in %.3f s, %.0f MB/s" % (size / 1048576.0, secs, size / 1048576.0 / max(secs, 1e-9)))
+	size, secs, _ = load_throughput(path)
+	print("load : %.1f MB in %.3f s, %.0f MB/s%s" % (size / 1048576.0, secs, size / 1048576.0 / max(secs, 1e-9),
+		"" if numpy is not None else " (pages touched, numpy not installed)"))
+
+	# Same size and disk as the export, so its dialog's rates can be compared
+	size = os.path.getsize(path)
+	written, synced = write_throughput(path + ".bench", size)
+	print("write : %.1f MB in %.3f s, %.0f MB/s; on disk after %.3f s, %.0f MB/s" % (size / 1048576.0,
+		written, size / 1048576.0 / max(written, 1e-9), synced, size / 1048576.0 / max(synced, 1e-9)))
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))
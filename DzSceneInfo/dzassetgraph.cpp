@@ -0,0 +1,243 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzassetgraph.h"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QtConcurrentMap>
+
+#include "dzapp.h"
+#include "dzbone.h"
+#include "dzcontentmgr.h"
+#include "dzimageproperty.h"
+#include "dzmaterial.h"
+#include "dznumericproperty.h"
+#include "dzobject.h"
+#include "dzscene.h"
+#include "dzshape.h"
+#include "dztexture.h"
+
+/**
+	Orders file indices by decreasing total bytes, or by decreasing references
+**/
+class DzAssetFileCompare {
+public:
+	DzAssetFileCompare( const QList<DzAssetFile> &files, bool byRefs ) :
+		m_files( files ), m_byRefs( byRefs ) {}
+
+	bool operator()( int idx1, int idx2 ) const {
+		const DzAssetFile &file1 = m_files[idx1];
+		const DzAssetFile &file2 = m_files[idx2];
+		if( m_byRefs && file1.numRefs != file2.numRefs ) {
+			return file1.numRefs > file2.numRefs;
+		}
+		return file1.totalBytes > file2.totalBytes;
+	}
+
+private:
+	const QList<DzAssetFile>	&m_files;
+	bool						m_byRefs;
+};
+
+/**
+	Add the texture files used by a material to files : its color, opacity
+	and baked maps, and the maps of its image and numeric properties (bump,
+	normal, displacement, specular, ...)
+**/
+void DzAssetGraph::getMaterialTextures( DzMaterial *material, QSet<QString> &files ) {
+	DzTexture *maps[] = { material->getColorMap(), material->getOpacityMap(), material->getBakedMap() };
+	for( int i = 0; i < 3; i++ ) {
+		if( maps[i] ) {
+			files.insert( maps[i]->getFilename() );
+		}
+	}
+
+	DzPropertyListIterator propIter( material->propertyListIterator() );
+	DzProperty *prop = NULL;
+	while( propIter.hasNext() ) {
+		prop = propIter.next();
+		DzTexture *texture = NULL;
+		if( DzImageProperty *imgProp = qobject_cast<DzImageProperty*>( prop ) ) {
+			texture = imgProp->getValue();
+		} else if( DzNumericProperty *numProp = qobject_cast<DzNumericProperty*>( prop ) ) {
+			texture = numProp->getMapValue();
+		}
+		if( texture ) {
+			files.insert( texture->getFilename() );
+		}
+	}
+	files.remove( QString() );
+}
+
+/**
+	Runs on a worker thread
+**/
+void DzAssetGraph::statFile( StatJob &job ) {
+	QFileInfo info( job.path );
+	job.stat.exists = info.exists();
+	if( job.stat.exists ) {
+		job.stat.size = info.size();
+		job.stat.modified = info.lastModified();
+	}
+}
+
+/**
+ **/
+void DzAssetGraph::clear() {
+	m_files.clear();
+	m_index.clear();
+	m_statCache.clear();
+	m_numStatted = 0;
+}
+
+/**
+	Returns the index of the file, adding it if needed, and counts one more
+	node using it
+**/
+int DzAssetGraph::addFile( const QString &path, DzAssetFile::Kind kind ) {
+	QHash<QString, int>::const_iterator it = m_index.find( path );
+	int idx;
+	if( it == m_index.end() ) {
+		idx = m_files.count();
+		DzAssetFile file;
+		file.path = path;
+		file.kind = kind;
+		m_files.append( file );
+		m_index.insert( path, idx );
+	} else {
+		idx = it.value();
+	}
+
+	m_files[idx].numRefs++;
+	return idx;
+}
+
+/**
+ **/
+void DzAssetGraph::build() {
+	m_files.clear();
+	m_index.clear();
+	m_numStatted = 0;
+
+	DzContentMgr *contentMgr = dzApp->getContentMgr();
+	QHash<int, QSet<int> > assetTextures;
+
+  // Gather the graph on the GUI thread
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+	  // A bone comes from its figure's file and has no shape; counting each
+	  // one would report a figure's file referenced once per bone
+		if( qobject_cast<DzBone*>( node ) ) {
+			continue;
+		}
+
+		int assetIdx = -1;
+		QString relPath = node->getAssetFileInfo().getUri().getFilePath();
+		if( !relPath.isEmpty() ) {
+			QString path = contentMgr->getAbsolutePath( relPath, true );
+			assetIdx = addFile( path.isEmpty() ? relPath : path, DzAssetFile::Asset );
+		}
+
+		DzObject	*obj = node->getObject();
+		DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
+		if( shape == NULL ) {
+			continue;
+		}
+
+		QSet<QString> textures;
+		for( int i = 0, n = shape->getNumMaterials(); i < n; i++ ) {
+			DzMaterial *material = shape->getMaterial( i );
+			if( material ) {
+				getMaterialTextures( material, textures );
+			}
+		}
+		QSet<QString>::const_iterator tex;
+		for( tex = textures.constBegin(); tex != textures.constEnd(); ++tex ) {
+			int texIdx = addFile( *tex, DzAssetFile::Texture );
+			if( assetIdx >= 0 ) {
+				assetTextures[assetIdx].insert( texIdx );
+			}
+		}
+	}
+
+  // Stat the files that are not in the cache, in parallel
+	QVector<StatJob> jobs;
+	for( int i = 0; i < m_files.count(); i++ ) {
+		if( !m_statCache.contains( m_files[i].path ) ) {
+			StatJob job;
+			job.path = m_files[i].path;
+			jobs.append( job );
+		}
+	}
+	QtConcurrent::blockingMap( jobs, statFile );
+	for( int i = 0; i < jobs.count(); i++ ) {
+		m_statCache.insert( jobs[i].path, jobs[i].stat );
+	}
+	m_numStatted = jobs.count();
+
+	for( int i = 0; i < m_files.count(); i++ ) {
+		DzAssetFile &file = m_files[i];
+		const FileStat &stat = m_statCache[file.path];
+		file.exists = stat.exists;
+		file.size = stat.size;
+		file.modified = stat.modified;
+		file.totalBytes = stat.size;
+	}
+
+  // An asset costs its own size and that of each texture its nodes use
+	QHash<int, QSet<int> >::const_iterator it;
+	for( it = assetTextures.constBegin(); it != assetTextures.constEnd(); ++it ) {
+		DzAssetFile &asset = m_files[it.key()];
+		asset.textures = it.value().toList();
+		qSort( asset.textures );
+		for( int i = 0; i < asset.textures.count(); i++ ) {
+			asset.totalBytes += m_files[asset.textures[i]].size;
+		}
+	}
+}
+
+/**
+	File indices, largest total bytes first
+**/
+QList<int> DzAssetGraph::getRankedByBytes() const {
+	QList<int> ranked;
+	for( int i = 0; i < m_files.count(); i++ ) {
+		ranked.append( i );
+	}
+	qSort( ranked.begin(), ranked.end(), DzAssetFileCompare( m_files, false ) );
+	return ranked;
+}
+
+/**
+	File indices, most referenced first
+**/
+QList<int> DzAssetGraph::getRankedByRefs() const {
+	QList<int> ranked;
+	for( int i = 0; i < m_files.count(); i++ ) {
+		ranked.append( i );
+	}
+	qSort( ranked.begin(), ranked.end(), DzAssetFileCompare( m_files, true ) );
+	return ranked;
+}
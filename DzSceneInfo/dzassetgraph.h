@@ -0,0 +1,104 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_ASSET_GRAPH_H
+#define DAZ_ASSET_GRAPH_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+
+/****************************
+   Forward declarations
+****************************/
+class DzMaterial;
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	A unique file used by the scene : the asset file a node was loaded from, or
+	a texture used by a node's materials
+**/
+struct DzAssetFile {
+	enum Kind { Asset, Texture };
+
+	QString		path;
+	Kind		kind;
+	int			numRefs;		// Nodes that use the file, not counting bones
+	bool		exists;
+	qint64		size;
+	QDateTime	modified;
+	qint64		totalBytes;		// For assets, the size plus that of their textures
+	QList<int>	textures;		// Indices of the textures used by nodes from an asset
+
+	DzAssetFile() : kind( Asset ), numRefs( 0 ), exists( false ), size( 0 ), totalBytes( 0 ) {}
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	The deduplicated graph of nodes to asset files to textures.
+
+	The files are gathered from the scene on the GUI thread. Their sizes and
+	modification times are read with parallel stat calls, and kept in a cache
+	keyed by path so that a file is only looked at once until clear() is called.
+**/
+class DzAssetGraph {
+public:
+	DzAssetGraph() : m_numStatted( 0 ) {}
+
+	void	build();
+	void	clear();
+
+	const QList<DzAssetFile>&	getFiles() const { return m_files; }
+	QList<int>		getRankedByBytes() const;
+	QList<int>		getRankedByRefs() const;
+	int				getNumStatted() const { return m_numStatted; }
+
+	static void		getMaterialTextures( DzMaterial *material, QSet<QString> &files );
+
+private:
+	struct FileStat {
+		bool		exists;
+		qint64		size;
+		QDateTime	modified;
+
+		FileStat() : exists( false ), size( 0 ) {}
+	};
+	struct StatJob {
+		QString		path;
+		FileStat	stat;
+	};
+
+	static void		statFile( StatJob &job );
+
+	int		addFile( const QString &path, DzAssetFile::Kind kind );
+
+	QList<DzAssetFile>			m_files;
+	QHash<QString, int>			m_index;		// Path to index in m_files
+	QHash<QString, FileStat>	m_statCache;
+	int							m_numStatted;	// Files stat'ed by the last build
+};
+
+#endif // DAZ_ASSET_GRAPH_H
@@ -0,0 +1,137 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzboundscache.h"
+
+#include <QtCore/QList>
+
+#include "dzbone.h"
+#include "dzbox3.h"
+#include "dzskeleton.h"
+
+// Signals after which a node's bounds have to be computed again
+static const char *const c_changeSignals[] = {
+	"transformChanged()", "drawnDataChanged()"
+};
+
+/**
+ **/
+DzBoundsCache::DzBoundsCache( QObject *parent ) : QObject( parent ) {
+}
+
+/**
+ **/
+void DzBoundsCache::clear() {
+	QSet<const QObject*>::const_iterator it;
+	for( it = m_watched.constBegin(); it != m_watched.constEnd(); ++it ) {
+		disconnect( *it, 0, this, 0 );
+	}
+	m_watched.clear();
+	m_spheres.clear();
+}
+
+/**
+	The bounding sphere of the node in world space
+**/
+const DzBoundsCache::Sphere& DzBoundsCache::getSphere( DzNode *node, int &numComputed ) {
+	QHash<const DzNode*, Sphere>::iterator it = m_spheres.find( node );
+	if( it == m_spheres.end() ) {
+		watchNode( node );
+		DzBox3 box = node->getWSBoundingBox();
+		Sphere sphere;
+		sphere.center = ( box.getMin() + box.getMax() ) * 0.5f;
+		sphere.radius = ( box.getMax() - box.getMin() ).length() * 0.5f;
+		it = m_spheres.insert( node, sphere );
+		numComputed++;
+	}
+	return it.value();
+}
+
+/**
+	Watch the node, its ancestors and, for figures, their bones
+**/
+void DzBoundsCache::watchNode( DzNode *node ) {
+	QList<DzNode*> nodes;
+	for( DzNode *ancestor = node; ancestor; ancestor = ancestor->getNodeParent() ) {
+		nodes.append( ancestor );
+		if( DzSkeleton *skeleton = qobject_cast<DzSkeleton*>( ancestor ) ) {
+			DzBoneList bones;
+			skeleton->getAllBones( bones );
+			for( int i = 0, n = bones.count(); i < n; i++ ) {
+				nodes.append( bones[i] );
+			}
+		}
+	}
+
+	for( int i = 0; i < nodes.count(); i++ ) {
+		DzNode *watched = nodes[i];
+		if( m_watched.contains( watched ) ) {
+			continue;
+		}
+		m_watched.insert( watched );
+		connect( watched, SIGNAL(destroyed(QObject*)), this, SLOT(nodeDestroyed(QObject*)) );
+		const QMetaObject *meta = watched->metaObject();
+		for( int j = 0; j < int( sizeof(c_changeSignals) / sizeof(c_changeSignals[0]) ); j++ ) {
+			if( meta->indexOfSignal( c_changeSignals[j] ) >= 0 ) {
+				connect( watched, ( QByteArray( "2" ) + c_changeSignals[j] ).constData(),
+					this, SLOT(nodeChanged()) );
+			}
+		}
+	}
+}
+
+/**
+	Drop the spheres of the node and everything below it. A bone moves the
+	geometry of its figure, so the whole figure is dropped instead.
+**/
+void DzBoundsCache::invalidate( DzNode *node ) {
+	if( DzBone *bone = qobject_cast<DzBone*>( node ) ) {
+		if( DzSkeleton *skeleton = bone->getSkeleton() ) {
+			node = skeleton;
+		}
+	}
+
+	QList<DzNode*> stack;
+	stack.append( node );
+	while( !stack.isEmpty() ) {
+		node = stack.takeLast();
+		m_spheres.remove( node );
+		for( int i = 0, n = node->getNumNodeChildren(); i < n; i++ ) {
+			stack.append( node->getNodeChild( i ) );
+		}
+	}
+}
+
+/**
+ **/
+void DzBoundsCache::nodeChanged() {
+	DzNode *node = qobject_cast<DzNode*>( sender() );
+	if( node && !m_spheres.isEmpty() ) {
+		invalidate( node );
+	}
+}
+
+/**
+	The node is being destroyed and can no longer be cast
+**/
+void DzBoundsCache::nodeDestroyed( QObject *obj ) {
+	m_watched.remove( obj );
+	m_spheres.remove( (const DzNode*)obj );
+}
@@ -0,0 +1,76 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_BOUNDS_CACHE_H
+#define DAZ_BOUNDS_CACHE_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+
+#include "dzvec3.h"
+
+/****************************
+   Forward declarations
+****************************/
+class DzNode;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	The world-space bounding sphere of each node, shared by the analyses that
+	test nodes against a camera or a light.
+
+	A sphere is computed from the node's bounding box the first time it is
+	asked for, and kept until the node or anything that moves it changes : the
+	node, its ancestors, or for a figure any of its bones. Those nodes are
+	watched for transform and drawn data changes, and a change drops the
+	spheres of the changed node and everything below it; a posed bone drops
+	its whole figure.
+**/
+class DzBoundsCache : public QObject {
+	Q_OBJECT
+public:
+	struct Sphere {
+		DzVec3	center;
+		float	radius;
+	};
+
+	DzBoundsCache( QObject *parent = NULL );
+
+	// numComputed is incremented when the sphere was not cached
+	const Sphere&	getSphere( DzNode *node, int &numComputed );
+	void			clear();
+
+private slots:
+
+	void	nodeChanged();
+	void	nodeDestroyed( QObject *obj );
+
+private:
+	void	watchNode( DzNode *node );
+	void	invalidate( DzNode *node );
+
+	QHash<const DzNode*, Sphere>	m_spheres;
+	QSet<const QObject*>			m_watched;
+};
+
+#endif // DAZ_BOUNDS_CACHE_H
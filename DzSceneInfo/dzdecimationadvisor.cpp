@@ -0,0 +1,124 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzdecimationadvisor.h"
+
+#include <math.h>
+#include <QtCore/QtAlgorithms>
+
+#include "dzboundscache.h"
+#include "dzcamera.h"
+#include "dzquat.h"
+#include "dzscene.h"
+#include "dzscenetree.h"
+
+// Width of the film back the focal length is relative to, in mm
+static const double c_frameWidth = 36.0;
+static const double c_pi = 3.14159265358979323846;
+
+/**
+ **/
+static bool compareOverTarget( const DzDecimationAdvisor::Entry &entry1, const DzDecimationAdvisor::Entry &entry2 ) {
+	return entry1.overTarget > entry2.overTarget;
+}
+
+/**
+	Project every render-visible node with facets through the camera. A node's
+	coverage is the area of its projected bounding sphere, clipped to the image;
+	a node that surrounds the camera covers the whole image.
+**/
+DzDecimationAdvisor::Report DzDecimationAdvisor::analyze( DzCamera *camera, const QSize &imageSize,
+	const DzSceneTree &tree ) {
+	Report report;
+	report.imageSize = imageSize;
+	if( camera == NULL || m_bounds == NULL || imageSize.isEmpty() || m_target <= 0 ) {
+		return report;
+	}
+
+  // The camera frame : it looks down its local -Z axis
+	DzVec3 eye = camera->getWSPos();
+	DzQuat rot = camera->getWSRot();
+	DzVec3 right = rot.multVec( DzVec3( 1, 0, 0 ) );
+	DzVec3 up = rot.multVec( DzVec3( 0, 1, 0 ) );
+	DzVec3 forward = rot.multVec( DzVec3( 0, 0, -1 ) );
+
+	report.focalLength = camera->getFocalLength();
+	if( report.focalLength <= 0 ) {
+		return report;
+	}
+	double width = imageSize.width();
+	double height = imageSize.height();
+	double imageArea = width * height;
+	double tanHalfX = c_frameWidth * 0.5 / report.focalLength;
+	double tanHalfY = tanHalfX * height / width;
+	double secHalfX = sqrt( 1.0 + tanHalfX * tanHalfX );
+	double secHalfY = sqrt( 1.0 + tanHalfY * tanHalfY );
+	double pixelsPerUnit = width * 0.5 / tanHalfX;	// At unit depth
+
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		const DzSceneTree::Item *item = tree.getItem( node );
+		if( item == NULL || !item->visible ) {
+			continue;
+		}
+		qint64 numFacets = item->own.numTris + item->own.numQuads + item->own.numTessPrims;
+		if( numFacets == 0 ) {
+			continue;
+		}
+		report.numNodes++;
+
+		const DzBoundsCache::Sphere &sphere = m_bounds->getSphere( node, report.numBounded );
+		DzVec3 offset = sphere.center - eye;
+		double x = offset.dot( right );
+		double y = offset.dot( up );
+		double z = offset.dot( forward );
+		double radius = sphere.radius;
+
+	  // Cull against the near point and the four side planes of the frustum
+		if( z + radius <= 0 ||
+			fabs( x ) > z * tanHalfX + radius * secHalfX ||
+			fabs( y ) > z * tanHalfY + radius * secHalfY ) {
+			report.numOffScreen++;
+			report.offScreenFacets += numFacets;
+			continue;
+		}
+
+		double numPixels = imageArea;
+		if( z > radius ) {
+			double projected = radius / z * pixelsPerUnit;
+			numPixels = qMin( c_pi * projected * projected, imageArea );
+		}
+
+		Entry entry;
+		entry.node = node;
+		entry.numFacets = numFacets;
+		entry.numPixels = numPixels;
+		entry.facetsPerPixel = numFacets / qMax( numPixels, 1.0 );
+		entry.overTarget = entry.facetsPerPixel / m_target;
+		if( entry.overTarget > 1.0 ) {
+			report.entries.append( entry );
+		}
+	}
+
+	qSort( report.entries.begin(), report.entries.end(), compareOverTarget );
+	return report;
+}
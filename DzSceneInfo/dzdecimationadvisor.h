@@ -0,0 +1,93 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_DECIMATION_ADVISOR_H
+#define DAZ_DECIMATION_ADVISOR_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QList>
+#include <QtCore/QSize>
+
+/****************************
+   Forward declarations
+****************************/
+class DzBoundsCache;
+class DzCamera;
+class DzNode;
+class DzSceneTree;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Ranks the render-visible nodes by how densely their facets cover the image.
+
+	Each node's world-space bounds are reduced to a sphere, which is projected
+	through the camera at the render resolution to estimate the pixels the
+	node covers. The spheres come from a DzBoundsCache, which keeps them until
+	a node moves or is posed, so when only the camera moves the analysis is a
+	single projection per node and no geometry is touched.
+**/
+class DzDecimationAdvisor {
+public:
+	/**
+		A node whose facets cover fewer pixels than the density target allows
+	**/
+	struct Entry {
+		DzNode	*node;
+		qint64	numFacets;
+		double	numPixels;			// Estimated coverage at the render resolution
+		double	facetsPerPixel;
+		double	overTarget;			// facetsPerPixel / target
+
+		Entry() : node( NULL ), numFacets( 0 ), numPixels( 0 ),
+			facetsPerPixel( 0 ), overTarget( 0 ) {}
+	};
+
+	/**
+		The nodes over the target, worst first
+	**/
+	struct Report {
+		QSize			imageSize;
+		double			focalLength;
+		int				numNodes;			// Render-visible nodes with facets
+		int				numOffScreen;		// Nodes entirely outside the view
+		qint64			offScreenFacets;
+		int				numBounded;			// Nodes whose bounds were not cached
+		QList<Entry>	entries;
+
+		Report() : focalLength( 0 ), numNodes( 0 ), numOffScreen( 0 ),
+			offScreenFacets( 0 ), numBounded( 0 ) {}
+	};
+
+	DzDecimationAdvisor() : m_bounds( NULL ), m_target( getDefaultTarget() ) {}
+
+	Report	analyze( DzCamera *camera, const QSize &imageSize, const DzSceneTree &tree );
+	void	setBoundsCache( DzBoundsCache *bounds ) { m_bounds = bounds; }
+
+	double			getTarget() const { return m_target; }
+	void			setTarget( double facetsPerPixel ) { m_target = facetsPerPixel; }
+	static double	getDefaultTarget() { return 1.0; }
+
+private:
+	DzBoundsCache	*m_bounds;
+	double			m_target;	// Facets per pixel
+};
+
+#endif // DAZ_DECIMATION_ADVISOR_H
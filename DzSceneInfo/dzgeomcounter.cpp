@@ -0,0 +1,179 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzgeomcounter.h"
+
+#include <QtCore/QList>
+#include <QtCore/QMetaMethod>
+
+#include "dzfacetmesh.h"
+#include "dzscenetree.h"
+
+/**
+	The registered counters, built-in ones last so that added counters can
+	override them
+**/
+static QList<DzGeomCounter*>& getCounterList() {
+	static QList<DzGeomCounter*> counters;
+	if( counters.isEmpty() ) {
+		counters.append( new DzFacetMeshCounter() );
+		counters.append( new DzCurveCounter() );
+	}
+	return counters;
+}
+
+/**
+	The counter chosen for each geometry class, NULL if there is none
+**/
+static QHash<const QMetaObject*, const DzGeomCounter*>& getCounterCache() {
+	static QHash<const QMetaObject*, const DzGeomCounter*> cache;
+	return cache;
+}
+
+/**
+	Returns the number from an int getter, or 0
+**/
+static int callGetter( DzGeometry *geom, int methodIdx ) {
+	int value = 0;
+	if( methodIdx >= 0 ) {
+		geom->metaObject()->method( methodIdx ).invoke( geom, Qt::DirectConnection,
+			Q_RETURN_ARG( int, value ) );
+	}
+	return value;
+}
+
+/*****************************
+DzFacetMeshCounter
+*****************************/
+
+/**
+ **/
+bool DzFacetMeshCounter::accepts( const QMetaObject *geomClass ) const {
+	for( const QMetaObject *meta = geomClass; meta; meta = meta->superClass() ) {
+		if( meta == &DzFacetMesh::staticMetaObject ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ **/
+void DzFacetMeshCounter::count( DzGeometry *geom, DzGeomStats &stats ) const {
+	DzFacetMesh	*mesh = (DzFacetMesh*)geom;
+	int			i, nFacets = mesh->getNumFacets();
+	DzFacet		*facets = mesh->getFacetsPtr();
+
+	for( i = 0; i < nFacets; i++ ) {
+		if( facets[i].isQuad() )
+		  stats.numQuads++;
+		else
+		  stats.numTris++;
+	}
+}
+
+/*****************************
+DzCurveCounter
+*****************************/
+
+/**
+	Look up the getters of a geometry class once
+**/
+const DzCurveCounter::Getters& DzCurveCounter::getGetters( const QMetaObject *geomClass ) const {
+	QHash<const QMetaObject*, Getters>::const_iterator it = m_getters.find( geomClass );
+	if( it != m_getters.end() ) {
+		return it.value();
+	}
+
+	static const char *const strandGetters[] = { "getNumStrands()", "getNumCurves()", "getNumLines()" };
+	Getters getters;
+	getters.strands = -1;
+	for( int i = 0; i < 3 && getters.strands < 0; i++ ) {
+		getters.strands = geomClass->indexOfMethod( strandGetters[i] );
+	}
+	getters.segments = geomClass->indexOfMethod( "getNumSegments()" );
+	return m_getters.insert( geomClass, getters ).value();
+}
+
+/**
+ **/
+bool DzCurveCounter::accepts( const QMetaObject *geomClass ) const {
+	return getGetters( geomClass ).strands >= 0;
+}
+
+/**
+	Without a segment getter, each strand is taken to be a polyline through
+	its control points
+**/
+void DzCurveCounter::count( DzGeometry *geom, DzGeomStats &stats ) const {
+	const Getters &getters = getGetters( geom->metaObject() );
+	int nStrands = callGetter( geom, getters.strands );
+	int nSegments = getters.segments >= 0 ?
+		callGetter( geom, getters.segments ) : qMax( stats.numVerts - nStrands, 0 );
+
+	stats.numStrands += nStrands;
+	stats.numSegments += nSegments;
+	stats.numControlPoints += stats.numVerts;
+
+  // Each sub-segment is rendered as a camera facing ribbon of two triangles
+	stats.numTessPrims += (qint64)nSegments * getTessellation() * 2;
+}
+
+/*****************************
+DzGeomCounters
+*****************************/
+
+/**
+	Takes ownership of counter. Added counters are tried before the ones
+	added earlier and the built-in ones.
+**/
+void DzGeomCounters::addCounter( DzGeomCounter *counter ) {
+	getCounterList().prepend( counter );
+	getCounterCache().clear();
+}
+
+/**
+ **/
+const DzGeomCounter* DzGeomCounters::findCounter( const QMetaObject *geomClass ) {
+	QHash<const QMetaObject*, const DzGeomCounter*> &cache = getCounterCache();
+	QHash<const QMetaObject*, const DzGeomCounter*>::const_iterator it = cache.find( geomClass );
+	if( it != cache.end() ) {
+		return it.value();
+	}
+
+	const DzGeomCounter *found = NULL;
+	const QList<DzGeomCounter*> &counters = getCounterList();
+	for( int i = 0; i < counters.count() && !found; i++ ) {
+		if( counters[i]->accepts( geomClass ) ) {
+			found = counters[i];
+		}
+	}
+	cache.insert( geomClass, found );
+	return found;
+}
+
+/**
+ **/
+void DzGeomCounters::count( DzGeometry *geom, DzGeomStats &stats ) {
+	const DzGeomCounter *counter = findCounter( geom->metaObject() );
+	if( counter ) {
+		counter->count( geom, stats );
+	}
+}
@@ -0,0 +1,98 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_GEOM_COUNTER_H
+#define DAZ_GEOM_COUNTER_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+
+/****************************
+   Forward declarations
+****************************/
+class QMetaObject;
+class DzGeometry;
+struct DzGeomStats;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Adds the counts for one kind of geometry to a DzGeomStats. The vertex and
+	material counts are filled in before count() is called.
+
+	To support a new geometry type, subclass this and register an instance with
+	DzGeomCounters::addCounter().
+**/
+class DzGeomCounter {
+public:
+	virtual ~DzGeomCounter() {}
+
+	/** Returns true if this counter handles geometry of the given class **/
+	virtual bool	accepts( const QMetaObject *geomClass ) const = 0;
+	virtual void	count( DzGeometry *geom, DzGeomStats &stats ) const = 0;
+};
+
+/**
+	Counts the triangles and quads of a DzFacetMesh
+**/
+class DzFacetMeshCounter : public DzGeomCounter {
+public:
+	virtual bool	accepts( const QMetaObject *geomClass ) const;
+	virtual void	count( DzGeometry *geom, DzGeomStats &stats ) const;
+};
+
+/**
+	Counts strand and curve geometry (hair, fibers, lines). The control points
+	are the geometry's vertices; the number of strands, and of segments if
+	available, is read through the geometry's scriptable getters, so any class
+	that has a getNumStrands(), getNumCurves() or getNumLines() slot is handled.
+**/
+class DzCurveCounter : public DzGeomCounter {
+public:
+	virtual bool	accepts( const QMetaObject *geomClass ) const;
+	virtual void	count( DzGeometry *geom, DzGeomStats &stats ) const;
+
+	static int		getTessellation() { return 4; }	// Sub-segments per segment
+
+private:
+	struct Getters {
+		int		strands;	// Method indices, or -1
+		int		segments;
+	};
+	const Getters&	getGetters( const QMetaObject *geomClass ) const;
+
+	mutable QHash<const QMetaObject*, Getters>	m_getters;
+};
+
+/**
+	The registry of counters. The counter for a geometry class is looked up
+	once and then cached, so counting costs a single hash lookup on top of the
+	counter itself.
+**/
+class DzGeomCounters {
+public:
+	static void		addCounter( DzGeomCounter *counter );
+	static void		count( DzGeometry *geom, DzGeomStats &stats );
+
+private:
+	static const DzGeomCounter*	findCounter( const QMetaObject *geomClass );
+};
+
+#endif // DAZ_GEOM_COUNTER_H
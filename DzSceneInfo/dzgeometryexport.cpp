@@ -0,0 +1,270 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzgeometryexport.h"
+
+#include <string.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QVector>
+
+#include "dzfacetmesh.h"
+#include "dzmaterial.h"
+#include "dznode.h"
+#include "dzobject.h"
+#include "dzscene.h"
+#include "dzshape.h"
+
+#if defined( Q_OS_WIN )
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// Facets repacked per write; 1 MB of vertex indices
+static const int c_chunkFacets = 65536;
+
+/**
+	A node whose mesh is written
+**/
+struct DzExportMesh {
+	DzFacetMesh	*mesh;
+	QByteArray	label;
+	QByteArray	name;
+	QByteArray	materialNames;
+	int			numMaterials;
+};
+
+/**
+ **/
+static quint64 alignOffset( quint64 offset ) {
+	quint64 alignment = DzGeometryExport::getAlignment();
+	return ( offset + alignment - 1 ) / alignment * alignment;
+}
+
+/**
+	Append the string to the table, and return its offset in the table
+**/
+static quint32 addString( QByteArray &strings, const QByteArray &text ) {
+	quint32 offset = strings.size();
+	strings += text;
+	return offset;
+}
+
+/**
+	Write zeros up to the next aligned offset
+**/
+static bool writePadding( QFile &file, quint64 &offset ) {
+	static const char zeros[64] = { 0 };
+	quint64 aligned = alignOffset( offset );
+	qint64 size = aligned - offset;
+	offset = aligned;
+	return size == 0 || file.write( zeros, size ) == size;
+}
+
+/**
+ **/
+static bool writeData( QFile &file, quint64 &offset, const void *data, qint64 size ) {
+	offset += size;
+	return size == 0 || file.write( (const char*)data, size ) == size;
+}
+
+/**
+	Wait until the data written to the file is on the disk. On Windows QFile
+	has no descriptor to flush, but the cache is per file, so a second
+	handle flushes it as well.
+**/
+static bool syncFile( QFile &file ) {
+#if defined( Q_OS_WIN )
+	HANDLE handle = CreateFileW( (const wchar_t*)QDir::toNativeSeparators( file.fileName() ).utf16(), GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( handle == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+	bool ok = FlushFileBuffers( handle ) != 0;
+	CloseHandle( handle );
+	return ok;
+#else
+	return fsync( file.handle() ) == 0;
+#endif
+}
+
+/**
+	The facet meshes of the scene, in scene order
+**/
+static QList<DzExportMesh> collectMeshes() {
+	QList<DzExportMesh> meshes;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	while( nodeIter.hasNext() ) {
+		DzNode *node = nodeIter.next();
+		DzObject *obj = node->getObject();
+		DzShape *shape = obj ? obj->getCurrentShape() : NULL;
+		DzFacetMesh *mesh = shape ? qobject_cast<DzFacetMesh*>( shape->getGeometry() ) : NULL;
+		if( mesh == NULL ) {
+			continue;
+		}
+
+		DzExportMesh entry;
+		entry.mesh = mesh;
+		entry.label = node->getLabel().toUtf8();
+		entry.name = node->getName().toUtf8();
+		entry.numMaterials = shape->getNumMaterials();
+		for( int i = 0; i < entry.numMaterials; i++ ) {
+			DzMaterial *material = shape->getMaterial( i );
+			entry.materialNames += material ? material->getName().toUtf8() : QByteArray();
+			entry.materialNames += '\0';
+		}
+		meshes.append( entry );
+	}
+	return meshes;
+}
+
+/**
+	Lay out the file, then stream the header, TOC, strings and each node's
+	arrays in file order
+**/
+DzGeometryExport::Result DzGeometryExport::write( const QString &fileName ) {
+	QElapsedTimer timer;
+	timer.start();
+	Result result;
+
+	QList<DzExportMesh> meshes = collectMeshes();
+	result.numNodes = meshes.count();
+
+  // Lay out the sections
+	QVector<TocEntry> toc( meshes.count() );
+	QByteArray strings;
+	for( int i = 0; i < meshes.count(); i++ ) {
+		const DzExportMesh &mesh = meshes[i];
+		TocEntry &entry = toc[i];
+		memset( &entry, 0, sizeof(entry) );
+		entry.numVerts = mesh.mesh->getNumVertices();
+		entry.numFacets = mesh.mesh->getNumFacets();
+		entry.numMaterials = mesh.numMaterials;
+		entry.labelOffset = addString( strings, mesh.label );
+		entry.labelLength = mesh.label.size();
+		entry.nameOffset = addString( strings, mesh.name );
+		entry.nameLength = mesh.name.size();
+		entry.materialNamesOffset = addString( strings, mesh.materialNames );
+		entry.materialNamesLength = mesh.materialNames.size();
+		result.numVerts += entry.numVerts;
+		result.numFacets += entry.numFacets;
+	}
+
+	Header header;
+	memset( &header, 0, sizeof(header) );
+	memcpy( header.magic, "DZGEOBIN", sizeof(header.magic) );
+	header.version = getVersion();
+	header.headerSize = sizeof(Header);
+	header.tocEntrySize = sizeof(TocEntry);
+	header.numNodes = meshes.count();
+	header.tocOffset = alignOffset( sizeof(Header) );
+	header.stringsOffset = alignOffset( header.tocOffset + (quint64)toc.count() * sizeof(TocEntry) );
+	header.stringsSize = strings.size();
+	header.dataOffset = alignOffset( header.stringsOffset + header.stringsSize );
+
+	quint64 offset = header.dataOffset;
+	for( int i = 0; i < toc.count(); i++ ) {
+		TocEntry &entry = toc[i];
+		entry.vertsOffset = offset;
+		offset = alignOffset( offset + (quint64)entry.numVerts * sizeof(DzPnt3) );
+		entry.facetsOffset = offset;
+		offset = alignOffset( offset + (quint64)entry.numFacets * 4 * sizeof(qint32) );
+		entry.materialsOffset = offset;
+		offset = alignOffset( offset + (quint64)entry.numFacets * sizeof(qint32) );
+	}
+	header.fileSize = offset;
+
+  // Stream the sections; the OS write cache is the only buffering
+	QFile file( fileName );
+	if( !file.open( QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered ) ) {
+		result.error = file.errorString();
+		return result;
+	}
+	file.resize( header.fileSize );
+
+	bool ok = true;
+	offset = 0;
+	ok = ok && writeData( file, offset, &header, sizeof(header) );
+	ok = ok && writePadding( file, offset );
+	ok = ok && writeData( file, offset, toc.constData(), (qint64)toc.count() * sizeof(TocEntry) );
+	ok = ok && writePadding( file, offset );
+	ok = ok && writeData( file, offset, strings.constData(), strings.size() );
+	ok = ok && writePadding( file, offset );
+
+	QVector<qint32> chunk( c_chunkFacets * 4 );
+	for( int i = 0; ok && i < meshes.count(); i++ ) {
+		DzFacetMesh *mesh = meshes[i].mesh;
+		const TocEntry &entry = toc[i];
+		const DzFacet *facets = mesh->getFacetsPtr();
+
+		ok = ok && writeData( file, offset, mesh->getVerticesPtr(), (qint64)entry.numVerts * sizeof(DzPnt3) );
+		ok = ok && writePadding( file, offset );
+
+		for( int begin = 0; ok && begin < (int)entry.numFacets; begin += c_chunkFacets ) {
+			int end = qMin( begin + c_chunkFacets, (int)entry.numFacets );
+			qint32 *out = chunk.data();
+			for( int j = begin; j < end; j++, out += 4 ) {
+				out[0] = facets[j].m_vertIdx[0];
+				out[1] = facets[j].m_vertIdx[1];
+				out[2] = facets[j].m_vertIdx[2];
+				out[3] = facets[j].isQuad() ? facets[j].m_vertIdx[3] : -1;
+			}
+			ok = writeData( file, offset, chunk.constData(), (qint64)( end - begin ) * 4 * sizeof(qint32) );
+		}
+		ok = ok && writePadding( file, offset );
+
+		for( int begin = 0; ok && begin < (int)entry.numFacets; begin += c_chunkFacets ) {
+			int end = qMin( begin + c_chunkFacets, (int)entry.numFacets );
+			qint32 *out = chunk.data();
+			for( int j = begin; j < end; j++ ) {
+				*out++ = facets[j].m_materialIdx;
+			}
+			ok = writeData( file, offset, chunk.constData(), (qint64)( end - begin ) * sizeof(qint32) );
+		}
+		ok = ok && writePadding( file, offset );
+	}
+
+	if( !ok || offset != header.fileSize ) {
+		result.error = ok ? QString( "Size mismatch" ) : file.errorString();
+		file.close();
+		file.remove();
+		return result;
+	}
+	result.nsecs = timer.nsecsElapsed();
+
+  // The writes above may only have reached the OS cache; the time until the
+  // file is on disk is what compares with dd conv=fsync and with the reader's
+  // bench, which both sync
+	if( !syncFile( file ) ) {
+		result.error = "Could not flush the file to disk";
+		file.close();
+		return result;
+	}
+	result.syncedNsecs = timer.nsecsElapsed();
+	file.close();
+
+	result.ok = true;
+	result.numBytes = header.fileSize;
+	return result;
+}
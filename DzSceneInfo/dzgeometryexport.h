@@ -0,0 +1,108 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_GEOMETRY_EXPORT_H
+#define DAZ_GEOMETRY_EXPORT_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QString>
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Writes the facet mesh of every node into one binary file that other tools
+	can map into memory and read in place.
+
+	The file is little-endian and every section starts on a getAlignment()
+	byte boundary :
+
+		Header		64 bytes
+		TOC			one 64-byte TocEntry per node
+		Strings		UTF-8 node labels, names and NUL-separated material names
+		Data		per node : vertices as 3 float32, facets as 4 int32 vertex
+					indices (the fourth is -1 for triangles), and one int32
+					material index per facet
+
+	The offsets in the TOC are from the start of the file, and the offsets of
+	the strings are from the start of the string table. The vertices are
+	those of the node's current shape, as counted by the pane, before posing.
+
+	The vertex array is written straight from the mesh; the facets are
+	repacked in fixed-size chunks, so memory use does not grow with the scene.
+	The file is flushed to disk before write() returns, and the time is
+	reported both up to the last write and up to the flush.
+	client/sceneinfo_geometry.py reads the file, and its bench command
+	measures plain writes of the same size for comparison.
+**/
+class DzGeometryExport {
+public:
+	struct Header {
+		char	magic[8];			// "DZGEOBIN"
+		quint32	version;
+		quint32	headerSize;
+		quint32	tocEntrySize;
+		quint32	numNodes;
+		quint64	tocOffset;
+		quint64	stringsOffset;
+		quint64	stringsSize;
+		quint64	dataOffset;
+		quint64	fileSize;
+	};
+
+	struct TocEntry {
+		quint64	vertsOffset;
+		quint64	facetsOffset;
+		quint64	materialsOffset;
+		quint32	numVerts;
+		quint32	numFacets;
+		quint32	numMaterials;
+		quint32	labelOffset;
+		quint32	labelLength;
+		quint32	nameOffset;
+		quint32	nameLength;
+		quint32	materialNamesOffset;
+		quint32	materialNamesLength;
+		quint32	reserved;
+	};
+
+	struct Result {
+		bool	ok;
+		QString	error;
+		int		numNodes;
+		qint64	numVerts;
+		qint64	numFacets;
+		qint64	numBytes;
+		qint64	nsecs;				// Until the last write returned
+		qint64	syncedNsecs;		// Until the file was on disk
+
+		Result() : ok( false ), numNodes( 0 ), numVerts( 0 ), numFacets( 0 ), numBytes( 0 ), nsecs( 0 ),
+			syncedNsecs( 0 ) {}
+
+		double	getMBPerSec() const { return nsecs > 0 ? numBytes / 1048576.0 / ( nsecs / 1.0e9 ) : 0.0; }
+		double	getSyncedMBPerSec() const { return syncedNsecs > 0 ? numBytes / 1048576.0 / ( syncedNsecs / 1.0e9 ) : 0.0; }
+	};
+
+	static Result	write( const QString &fileName );
+
+	static quint32	getVersion() { return 1; }
+	static int		getAlignment() { return 64; }
+};
+
+#endif // DAZ_GEOMETRY_EXPORT_H
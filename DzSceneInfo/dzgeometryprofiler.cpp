@@ -0,0 +1,187 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzgeometryprofiler.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+
+#include "dzfloatproperty.h"
+#include "dzgeometry.h"
+#include "dzmodifier.h"
+#include "dzmorph.h"
+#include "dznode.h"
+#include "dzobject.h"
+#include "dzshape.h"
+
+/**
+	A node being profiled and its modifiers
+**/
+struct DzProfileJob {
+	DzNode				*node;
+	DzObject			*obj;
+	QVector<qint64>		nsecs;			// One rebuild per pass
+	QStringList			workingClasses;	// Modifiers that change the geometry
+	QStringList			allClasses;
+};
+
+/**
+ **/
+static bool compareMedian( const DzGeometryProfiler::NodeEntry &entry1, const DzGeometryProfiler::NodeEntry &entry2 ) {
+	return entry1.medianNsecs > entry2.medianNsecs;
+}
+
+/**
+ **/
+static bool compareWorking( const DzGeometryProfiler::ModifierEntry &entry1, const DzGeometryProfiler::ModifierEntry &entry2 ) {
+	if( entry1.numWorking != entry2.numWorking ) {
+		return entry1.numWorking > entry2.numWorking;
+	}
+	return entry1.numInstances > entry2.numInstances;
+}
+
+/**
+ **/
+static qint64 getMedian( QVector<qint64> values ) {
+	if( values.isEmpty() ) {
+		return 0;
+	}
+	qSort( values.begin(), values.end() );
+	return values[values.count() / 2];
+}
+
+/**
+	Count the node's modifiers by stage, and note those that change the
+	geometry. Must be called on the GUI thread, since reading a morph's value
+	can evaluate its controllers.
+**/
+static void classifyModifiers( DzProfileJob &job, DzGeometryProfiler::NodeEntry &entry ) {
+	entry.numModifiers = job.obj->getNumModifiers();
+	for( int i = 0; i < entry.numModifiers; i++ ) {
+		DzModifier *modifier = job.obj->getModifier( i );
+		QString className = modifier->metaObject()->className();
+		job.allClasses.append( className );
+		if( modifier->inherits( "DzWSModifier" ) ) {
+			entry.numWSModifiers++;
+		} else if( DzMorph *morph = qobject_cast<DzMorph*>( modifier ) ) {
+			DzFloatProperty *value = morph->getValueChannel();
+			if( !value || value->getValue() == value->getDefaultValue() ) {
+				continue;
+			}
+			entry.numDialedMorphs++;
+		}
+		job.workingClasses.append( className );
+	}
+}
+
+/**
+	Rebuild the geometry of each node with an object getNumPasses() + 1 times,
+	discarding the first pass. The rebuilds leave the geometry as it was.
+**/
+void DzGeometryProfiler::profile( const QList<DzNode*> &nodes ) {
+	QElapsedTimer totalTimer;
+	totalTimer.start();
+	m_report = Report();
+
+	QVector<DzProfileJob> jobs;
+	QList<NodeEntry> entries;
+	for( int i = 0; i < nodes.count(); i++ ) {
+		DzObject *obj = nodes[i] ? nodes[i]->getObject() : NULL;
+		if( obj == NULL ) {
+			continue;
+		}
+
+		DzProfileJob job;
+		job.node = nodes[i];
+		job.obj = obj;
+		job.nsecs.reserve( m_numPasses );
+
+		NodeEntry entry;
+		entry.node = nodes[i];
+		classifyModifiers( job, entry );
+		jobs.append( job );
+		entries.append( entry );
+	}
+
+	QElapsedTimer timer;
+	for( int pass = 0; pass <= m_numPasses; pass++ ) {
+		for( int i = 0; i < jobs.count(); i++ ) {
+			DzProfileJob &job = jobs[i];
+			timer.start();
+			job.obj->forceCacheUpdate( job.node );
+			qint64 nsecs = timer.nsecsElapsed();
+			if( pass > 0 ) {
+				job.nsecs.append( nsecs );
+			}
+		}
+	}
+
+	QHash<QString, ModifierEntry> modifiers;
+	for( int i = 0; i < jobs.count(); i++ ) {
+		const DzProfileJob &job = jobs[i];
+		NodeEntry &entry = entries[i];
+		entry.medianNsecs = getMedian( job.nsecs );
+		entry.minNsecs = entry.medianNsecs;
+		for( int j = 0; j < job.nsecs.count(); j++ ) {
+			entry.minNsecs = qMin( entry.minNsecs, job.nsecs[j] );
+		}
+
+		DzShape *shape = job.obj->getCurrentShape();
+		DzGeometry *geom = shape ? shape->getGeometry() : NULL;
+		entry.numVerts = geom ? geom->getNumVertices() : 0;
+
+	  // Count every instance, and each node once per class
+		for( int j = 0; j < job.workingClasses.count(); j++ ) {
+			modifiers[job.workingClasses[j]].numWorking++;
+		}
+		QStringList seen;
+		for( int j = 0; j < job.allClasses.count(); j++ ) {
+			ModifierEntry &modifier = modifiers[job.allClasses[j]];
+			modifier.className = job.allClasses[j];
+			modifier.numInstances++;
+			if( !seen.contains( job.allClasses[j] ) ) {
+				seen.append( job.allClasses[j] );
+				modifier.numNodes++;
+			}
+		}
+	}
+
+	qSort( entries.begin(), entries.end(), compareMedian );
+	m_report.modifiers = modifiers.values();
+	qSort( m_report.modifiers.begin(), m_report.modifiers.end(), compareWorking );
+	m_report.nodes = entries;
+	m_report.numNodes = entries.count();
+	m_report.numPasses = m_numPasses;
+	m_report.totalNsecs = totalTimer.nsecsElapsed();
+}
+
+/**
+	Forget a deleted node, so the report never refers to it
+**/
+void DzGeometryProfiler::nodeRemoved( DzNode *node ) {
+	for( int i = m_report.nodes.count() - 1; i >= 0; i-- ) {
+		if( m_report.nodes[i].node == node ) {
+			m_report.nodes.removeAt( i );
+		}
+	}
+}
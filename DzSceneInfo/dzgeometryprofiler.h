@@ -0,0 +1,103 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_GEOMETRY_PROFILER_H
+#define DAZ_GEOMETRY_PROFILER_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+/****************************
+   Forward declarations
+****************************/
+class DzNode;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Times the geometry pipeline of nodes by forcing their objects to rebuild
+	their cached geometry.
+
+	Each pass rebuilds every node once, through its whole pipeline : the
+	base shape, morphs and other modifiers, and the world-space modifiers.
+	The stages are not timed apart. A warm-up pass is run first and
+	discarded, and the median of the remaining passes is kept. The nodes
+	are interleaved within a pass so caching favors none of them.
+
+	The modifiers are not timed one at a time, since that would mean changing
+	the scene to take each one out; they are only counted per class, along
+	with how many of them do work. Morphs at their default value do none.
+
+	Profiling runs on the GUI thread and blocks it; it is only done on request.
+**/
+class DzGeometryProfiler {
+public:
+	struct NodeEntry {
+		DzNode	*node;
+		int		numVerts;
+		int		numModifiers;
+		int		numDialedMorphs;
+		int		numWSModifiers;
+		qint64	minNsecs;			// Fastest rebuild
+		qint64	medianNsecs;		// Median rebuild
+
+		NodeEntry() : node( NULL ), numVerts( 0 ), numModifiers( 0 ), numDialedMorphs( 0 ),
+			numWSModifiers( 0 ), minNsecs( 0 ), medianNsecs( 0 ) {}
+	};
+
+	struct ModifierEntry {
+		QString	className;
+		int		numInstances;
+		int		numWorking;			// Instances that change the geometry
+		int		numNodes;
+
+		ModifierEntry() : numInstances( 0 ), numWorking( 0 ), numNodes( 0 ) {}
+	};
+
+	struct Report {
+		int						numNodes;		// Nodes with an object
+		int						numPasses;
+		qint64					totalNsecs;		// Wall time of the whole profile
+		QList<NodeEntry>		nodes;			// Slowest first
+		QList<ModifierEntry>	modifiers;		// Most working instances first
+
+		Report() : numNodes( 0 ), numPasses( 0 ), totalNsecs( 0 ) {}
+	};
+
+	DzGeometryProfiler() : m_numPasses( getDefaultPasses() ) {}
+
+	void	profile( const QList<DzNode*> &nodes );
+	void	nodeRemoved( DzNode *node );
+	void	clear() { m_report = Report(); }
+
+	const Report&	getReport() const { return m_report; }
+	bool			isEmpty() const { return m_report.numPasses == 0; }
+
+	int				getNumPasses() const { return m_numPasses; }
+	void			setNumPasses( int numPasses ) { m_numPasses = numPasses; }
+	static int		getDefaultPasses() { return 5; }
+
+private:
+	Report	m_report;
+	int		m_numPasses;
+};
+
+#endif // DAZ_GEOMETRY_PROFILER_H
@@ -20,18 +20,31 @@ Include files
 *****************************/
 #include "dzinfopane.h"
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
 #include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtGui/QApplication>
+#include <QtGui/QFileDialog>
+#include <QtGui/QInputDialog>
+#include <QtGui/QLineEdit>
+#include <QtGui/QMessageBox>
 #include <QtGui/QPushButton>
+#include <QtGui/QScrollBar>
 #include <QtGui/QTextBrowser>
 #include <QtGui/QVBoxLayout>
 
+#include "dz3dviewport.h"
 #include "dzapp.h"
 #include "dzbone.h"
 #include "dzcamera.h"
 #include "dzlight.h"
 #include "dzfacetmesh.h"
 #include "dzhelpmgr.h"
+#include "dzmainwindow.h"
 #include "dzobject.h"
+#include "dzrendermgr.h"
+#include "dzrenderoptions.h"
 #include "dzscene.h"
 #include "dzshape.h"
 #include "dzskeleton.h"
@@ -39,28 +52,80 @@ Include files
 #include "dzproperty.h"
 #include "dztarray.h"
 #include "dzactionmenu.h"
+#include "dzviewport.h"
+#include "dzviewportmgr.h"
+
+#include "dzgeometryexport.h"
+#include "dzmaterialdedup.h"
+#include "dzmorphaudit.h"
+#include "dzstatsserver.h"
 
 static const int c_minWidth = 200;
 static const int c_minHeight = 150;
+static const int c_maxHygieneRows = 20;
+static const int c_maxDedupGroups = 20;
+static const int c_maxAssetRows = 20;
+static const int c_maxDecimationRows = 20;
+static const int c_maxLightRows = 20;
+static const int c_maxProfileRows = 20;
+static const int c_maxVertexCacheRows = 20;
+static const int c_maxPropertyChanges = 50;
+static const int c_maxSignalBursts = 5;
+static const int c_cameraRedrawInterval = 100;	// msec
+static const int c_filterInterval = 150;	// msec
+static const int c_maxFilterRows = 1000;
+static const int c_memorySampleInterval = 5000;	// msec
 
 // Function prototypes
 bool compareMaterials(const QObject *obj1, const QObject *obj2);
+static bool compareHygieneSavings( const DzMeshHygieneStats &stats1, const DzMeshHygieneStats &stats2 );
+static QString formatMB( qint64 bytes );
+static QString formatFacetCounts( const DzMaterialHistogram *histogram, int materialIdx );
+static QString formatTotalRow( const QString &label, qint64 total, qint64 visible, bool showVisible );
+static QString formatBudgetBadge( DzSceneBudget::Status status );
 
 /**
  **/
 DzSceneInfoPaneEx::DzSceneInfoPaneEx() :
 	DzPane( "Scene Info Ex" ),
 	m_refreshBlocked( false ), 
+	m_dirty( true ),
 	m_totalVerts( 0 ),
 	m_totalTris( 0 ),
 	m_totalQuads( 0 ),
 	m_showScene (false),
+	m_showRenderVisible( false ),
+	m_showBudgets( false ),
 	m_showNodes (true),
 	m_showSelected (false),
+	m_showSelectionTotals( false ),
 	m_showSelectedObject (false),
 	m_showSelectedProperties (false),
-	m_showMaterials( false )
+	m_showPropertyDiff( false ),
+	m_showMaterials( false ),
+	m_showMorphAudit( false ),
+	m_auditAllFigures( false ),
+	m_showMeshHygiene( false ),
+	m_showSkinning( false ),
+	m_showHierarchy( false ),
+	m_showMaterialDedup( false ),
+	m_showAssetGraph( false ),
+	m_showDecimation( false ),
+	m_showLightInfluence( false ),
+	m_showGeomProfile( false ),
+	m_showVertexCache( false ),
+	m_showMemory( false ),
+	m_showOverhead( false ),
+	m_showSignals( false ),
+	m_constructNsecs( 0 ),
+	m_numRefreshes( 0 ),
+	m_refreshNsecs( 0 ),
+	m_lastRefreshNsecs( 0 ),
+	m_sampleReason( DzMemorySample::Refresh )
 {
+	QElapsedTimer timer;
+	timer.start();
+
   // Declarations
 	int margin = style()->pixelMetric( DZ_PM_GeneralMargin );
 
@@ -73,35 +138,86 @@ DzSceneInfoPaneEx::DzSceneInfoPaneEx() :
 	m_output = new QTextBrowser();
 	m_output->setObjectName( "SceneInfoExTxtBrwsr" );
 	m_output->setMinimumSize( c_minWidth, c_minHeight );
+	clearOutput();
+
+  // Filter for the nodes section; see DzNodeIndex for the query terms
+	m_filterEdit = new QLineEdit();
+	m_filterEdit->setObjectName( "SceneInfoExFilterEdit" );
+	m_filterEdit->setPlaceholderText( "Filter nodes : text, label:, path:, class:, verts>N, faces<N" );
+	m_filterEdit->setVisible( m_showNodes );
 
   // Implement the context menu
 	m_output->setContextMenuPolicy(Qt::CustomContextMenu);
 	connect( m_output, SIGNAL(customContextMenuRequested(const QPoint &)),
 	  this, SLOT(showContextMenu(const QPoint &)) );
 
+	mainLayout->addWidget( m_filterEdit );
 	mainLayout->addWidget( m_output );
 
+  // Timer for sampling the process memory while the telemetry is shown
+	m_memoryTimer = new QTimer( this );
+	m_memoryTimer->setInterval( c_memorySampleInterval );
+	connect( m_memoryTimer, SIGNAL(timeout()), this, SLOT(sampleMemory()) );
+
+  // Camera moves arrive many times a second; redraw once they settle
+	m_cameraTimer = new QTimer( this );
+	m_cameraTimer->setSingleShot( true );
+	m_cameraTimer->setInterval( c_cameraRedrawInterval );
+	connect( m_cameraTimer, SIGNAL(timeout()), this, SLOT(cameraMoved()) );
+
+  // Redraw once typing pauses rather than on every keystroke
+	m_filterTimer = new QTimer( this );
+	m_filterTimer->setSingleShot( true );
+	m_filterTimer->setInterval( c_filterInterval );
+	connect( m_filterEdit, SIGNAL(textChanged(const QString &)), m_filterTimer, SLOT(start()) );
+	connect( m_filterTimer, SIGNAL(timeout()), this, SLOT(filterChanged()) );
+
+  // Node stats and histograms of unchanged assets are kept between sessions;
+  // the cache file is not opened until a scene is scanned
+	m_tree.setStatsCache( &m_statsCache );
+	m_histograms.setStatsCache( &m_statsCache );
+
+  // Node bounds are kept until the nodes move or are posed
+	m_decimation.setBoundsCache( &m_bounds );
+	m_lightInfluence.setBoundsCache( &m_bounds );
+
+  // Material signatures are cached between refreshes
+	m_materialDedup = new DzMaterialDedup( this );
+
+  // Local socket endpoint for external tools; only listens once started
+	m_statsServer = new DzStatsServer( this );
+
   // Set the layout for the pane
 	setLayout( mainLayout );
 
-  // Do an initial update of the scene stats
-	refresh();
+  // The scene stats are not computed here; the pane starts out dirty and
+  // is refreshed the first time it is shown, so loading the plugin with
+  // the pane closed costs nothing.
 
   // Listen for the node list in the scene to change so that we can update our information
-	connect( dzScene, SIGNAL(nodeListChanged()), this, SLOT(refresh()) );
+	connect( dzScene, SIGNAL(nodeListChanged()), this, SLOT(nodeListChanged()) );
 
   // Listen for the primary selection to change so that we can update our information
-	connect( dzScene, SIGNAL(primarySelectionChanged(DzNode*)), this, SLOT(refreshInfo(DzNode*)) );
+	connect( dzScene, SIGNAL(primarySelectionChanged(DzNode*)), this, SLOT(primarySelectionChanged(DzNode*)) );
+
+  // Listen for the rest of the selection to change so that the selection totals follow it
+	connect( dzScene, SIGNAL(nodeSelectionListChanged()), this, SLOT(selectionListChanged()) );
+
+  // Keep the node search index current; it is not built until the nodes are filtered
+	connect( dzScene, SIGNAL(nodeAdded(DzNode*)), this, SLOT(nodeAdded(DzNode*)) );
+	connect( dzScene, SIGNAL(nodeRemoved(DzNode*)), this, SLOT(nodeRemoved(DzNode*)) );
 
   // Listen for file load operations so that we can block our refresh function from executing.
   // During a scene load, the node list will change many times - we only want to refresh
   // once at the end of the load, so that we do not slow down the file load.
 	connect( dzScene, SIGNAL(sceneLoadStarting()), this, SLOT(blockRefresh()) );
 	connect( dzScene, SIGNAL(sceneClearStarting()), this, SLOT(blockRefresh()) );
-	connect( dzScene, SIGNAL(sceneLoaded()), this, SLOT(unblockRefresh()) );
-	connect( dzScene, SIGNAL(sceneCleared()), this, SLOT(unblockRefresh()) );
+	connect( dzScene, SIGNAL(sceneLoaded()), this, SLOT(unblockAfterLoad()) );
+	connect( dzScene, SIGNAL(sceneCleared()), this, SLOT(unblockAfterClear()) );
 
 	setMinimumSize( c_minWidth, c_minHeight );
+
+	m_constructNsecs = timer.nsecsElapsed();
 }
 
 /**
@@ -115,23 +231,101 @@ void DzSceneInfoPaneEx::showContextMenu(const QPoint &pos) {
 	QMenu menu;
 	QString sceneText = m_showScene ? 
 	  "Hide Scene" : "Show Scene";
+	QString renderVisibleText = m_showRenderVisible ? 
+	  "Hide Render Visible" : "Show Render Visible";
+	QString budgetsText = m_showBudgets ? 
+	  "Hide Budgets" : "Show Budgets";
 	QString nodesText = m_showNodes ? 
 	  "Hide Nodes" : "Show Nodes";
 	QString selectedText = m_showSelected ? 
 	  "Hide Selected" : "Show Selected";
+	QString selectionTotalsText = m_showSelectionTotals ? 
+	  "Hide Selection Totals" : "Show Selection Totals";
 	QString objectText = m_showSelectedObject ? 
 	  "Hide Selected Object" : "Show Selected Object";
 	QString propertiesText = m_showSelectedProperties ? 
 	  "Hide Selected Properties" : "Show Selected Properties";
+	QString propertyDiffText = m_showPropertyDiff ? 
+	  "Hide Property Diff" : "Show Property Diff";
 	QString materialsText = m_showMaterials ? 
 	  "Hide Materials" : "Show Materials";
+	QString dedupText = m_showMaterialDedup ? 
+	  "Hide Material Dedup" : "Show Material Dedup";
+	QString assetsText = m_showAssetGraph ? 
+	  "Hide Asset Graph" : "Show Asset Graph";
+	QString decimationText = m_showDecimation ? 
+	  "Hide Decimation Advisor" : "Show Decimation Advisor";
+	QString lightsText = m_showLightInfluence ? 
+	  "Hide Light Influence" : "Show Light Influence";
+	QString geomProfileText = m_showGeomProfile ? 
+	  "Hide Geometry Profile" : "Show Geometry Profile";
+	QString vertexCacheText = m_showVertexCache ? 
+	  "Hide Vertex Cache" : "Show Vertex Cache";
+	QString morphAuditText = m_showMorphAudit ? 
+	  "Hide Morph Audit" : "Show Morph Audit";
+	QString auditAllText = m_auditAllFigures ? 
+	  "Audit Selected Figure" : "Audit All Figures";
+	QString hygieneText = m_showMeshHygiene ? 
+	  "Hide Mesh Hygiene" : "Show Mesh Hygiene";
+	QString skinningText = m_showSkinning ? 
+	  "Hide Skinning" : "Show Skinning";
+	QString hierarchyText = m_showHierarchy ? 
+	  "Hide Hierarchy" : "Show Hierarchy";
+	QString memoryText = m_showMemory ? 
+	  "Hide Memory Telemetry" : "Show Memory Telemetry";
+	QString overheadText = m_showOverhead ? 
+	  "Hide Pane Overhead" : "Show Pane Overhead";
+	QString signalsText = m_showSignals ? 
+	  "Hide Signal Recorder" : "Show Signal Recorder";
+	QString serverText = m_statsServer->isRunning() ? 
+	  "Stop Stats Server" : "Start Stats Server";
 
 	QAction *sceneAction = menu.addAction(sceneText);
+	QAction *renderVisibleAction = menu.addAction(renderVisibleText);
+	renderVisibleAction->setEnabled(m_showScene);
+	QAction *budgetsAction = menu.addAction(budgetsText);
+	QMenu *budgetMenu = menu.addMenu("Set Budgets");
+	QList<QAction*> budgetActions;
+	for(int i = 0; i < DzSceneBudget::NumMetrics; i++) {
+		qint64 limit = m_budgets.getLimit(i);
+		budgetActions.append(budgetMenu->addAction(QString("%1 (%2)...")
+		  .arg(DzSceneBudget::getMetricName(i))
+		  .arg(limit > 0 ? QString::number(limit) : QString("Off"))));
+	}
 	QAction *nodesAction = menu.addAction(nodesText);
+	QAction *hierarchyAction = menu.addAction(hierarchyText);
 	QAction *selectedAction = menu.addAction(selectedText);
+	QAction *selectionTotalsAction = menu.addAction(selectionTotalsText);
 	QAction *objectAction = menu.addAction(objectText);
 	QAction *propertiesAction = menu.addAction(propertiesText);
+	QAction *propertyDiffAction = menu.addAction(propertyDiffText);
+	QAction *snapshotAction = menu.addAction("Take Property Snapshot");
+	snapshotAction->setEnabled(dzScene->getPrimarySelection() != NULL);
 	QAction *materialsAction = menu.addAction(materialsText);
+	QAction *dedupAction = menu.addAction(dedupText);
+	QAction *assetsAction = menu.addAction(assetsText);
+	QAction *decimationAction = menu.addAction(decimationText);
+	QAction *targetAction = menu.addAction(QString("Set Density Target (%1)...").arg(m_decimation.getTarget()));
+	targetAction->setEnabled(m_showDecimation);
+	QAction *lightsAction = menu.addAction(lightsText);
+	QAction *geomProfileAction = menu.addAction(geomProfileText);
+	QAction *profileSelectedAction = menu.addAction("Profile Selected Geometry");
+	profileSelectedAction->setEnabled(dzScene->getNumSelectedNodes() > 0);
+	QAction *profileSceneAction = menu.addAction("Profile Scene Geometry");
+	QAction *passesAction = menu.addAction(QString("Set Profile Passes (%1)...").arg(m_geomProfiler.getNumPasses()));
+	QAction *vertexCacheAction = menu.addAction(vertexCacheText);
+	QAction *morphAuditAction = menu.addAction(morphAuditText);
+	QAction *auditAllAction = menu.addAction(auditAllText);
+	auditAllAction->setEnabled(m_showMorphAudit);
+	QAction *hygieneAction = menu.addAction(hygieneText);
+	QAction *skinningAction = menu.addAction(skinningText);
+	QAction *memoryAction = menu.addAction(memoryText);
+	QAction *overheadAction = menu.addAction(overheadText);
+	QAction *signalsAction = menu.addAction(signalsText);
+	QAction *exportSignalsAction = menu.addAction("Export Signal Log...");
+	QAction *exportGeometryAction = menu.addAction("Export Geometry...");
+	menu.addSeparator();
+	QAction *serverAction = menu.addAction(serverText);
 	menu.addSeparator();
 	QAction *refreshAction = menu.addAction("Refresh");
 
@@ -143,29 +337,225 @@ void DzSceneInfoPaneEx::showContextMenu(const QPoint &pos) {
 	if(selectedItem == sceneAction) {
 		m_showScene = !m_showScene;
 		refresh();
+	} else if(selectedItem == renderVisibleAction) {
+		m_showRenderVisible = !m_showRenderVisible;
+		refresh();
+	} else if(selectedItem == budgetsAction) {
+		m_showBudgets = !m_showBudgets;
+		refresh();
+	} else if(budgetActions.contains(selectedItem)) {
+		int metric = budgetActions.indexOf(selectedItem);
+		bool ok = false;
+		int limit = QInputDialog::getInt(this, "Scene Budgets",
+		  QString("%1 (0 for no limit) :").arg(DzSceneBudget::getMetricName(metric)),
+		  (int)qMin(m_budgets.getLimit(metric), Q_INT64_C(0x7fffffff)), 0, 0x7fffffff, 1, &ok);
+		if(ok) {
+			m_budgets.setLimit(metric, limit);
+			refresh();
+		}
 	} else if(selectedItem == nodesAction) {
 		m_showNodes = !m_showNodes;
+		m_filterEdit->setVisible(m_showNodes);
+		refresh();
+	} else if(selectedItem == hierarchyAction) {
+		m_showHierarchy = !m_showHierarchy;
 		refresh();
 	} else if(selectedItem == selectedAction) {
 		m_showSelected = !m_showSelected;
 		refresh();
+	} else if(selectedItem == selectionTotalsAction) {
+		m_showSelectionTotals = !m_showSelectionTotals;
+		refresh();
 	} else if(selectedItem == objectAction) {
 		m_showSelectedObject = !m_showSelectedObject;
 		refresh();
 	} else if(selectedItem == propertiesAction) {
 		m_showSelectedProperties = !m_showSelectedProperties;
 		refresh();
+	} else if(selectedItem == propertyDiffAction) {
+		m_showPropertyDiff = !m_showPropertyDiff;
+		refresh();
+	} else if(selectedItem == snapshotAction) {
+		m_propSnapshot.capture(dzScene->getPrimarySelection());
+		m_showPropertyDiff = true;
+		refresh();
 	} else if(selectedItem == materialsAction) {
 		m_showMaterials = !m_showMaterials;
 		refresh();
+	} else if(selectedItem == dedupAction) {
+		m_showMaterialDedup = !m_showMaterialDedup;
+		refresh();
+	} else if(selectedItem == assetsAction) {
+		m_showAssetGraph = !m_showAssetGraph;
+		refresh();
+	} else if(selectedItem == decimationAction) {
+		m_showDecimation = !m_showDecimation;
+		refresh();
+	} else if(selectedItem == lightsAction) {
+		m_showLightInfluence = !m_showLightInfluence;
+		refresh();
+	} else if(selectedItem == geomProfileAction) {
+		m_showGeomProfile = !m_showGeomProfile;
+		refresh();
+	} else if(selectedItem == vertexCacheAction) {
+		m_showVertexCache = !m_showVertexCache;
+		refresh();
+	} else if(selectedItem == profileSelectedAction || selectedItem == profileSceneAction) {
+		QList<DzNode*> nodes;
+		if(selectedItem == profileSelectedAction) {
+			for(int i = 0; i < dzScene->getNumSelectedNodes(); i++) {
+				nodes.append(dzScene->getSelectedNode(i));
+			}
+		} else {
+			DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+			while( nodeIter.hasNext() ) {
+				nodes.append(nodeIter.next());
+			}
+		}
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		m_geomProfiler.profile(nodes);
+		QApplication::restoreOverrideCursor();
+		m_showGeomProfile = true;
+		refresh();
+	} else if(selectedItem == passesAction) {
+		bool ok = false;
+		int passes = QInputDialog::getInt(this, "Geometry Profile",
+		  "Timed passes :", m_geomProfiler.getNumPasses(), 1, 100, 1, &ok);
+		if(ok) {
+			m_geomProfiler.setNumPasses(passes);
+		}
+	} else if(selectedItem == targetAction) {
+		bool ok = false;
+		double target = QInputDialog::getDouble(this, "Decimation Advisor",
+		  "Facets per pixel :", m_decimation.getTarget(), 0.001, 1000.0, 3, &ok);
+		if(ok) {
+			m_decimation.setTarget(target);
+			refresh();
+		}
+	} else if(selectedItem == morphAuditAction) {
+		m_showMorphAudit = !m_showMorphAudit;
+		refresh();
+	} else if(selectedItem == auditAllAction) {
+		m_auditAllFigures = !m_auditAllFigures;
+		refresh();
+	} else if(selectedItem == hygieneAction) {
+		m_showMeshHygiene = !m_showMeshHygiene;
+		refresh();
+	} else if(selectedItem == skinningAction) {
+		m_showSkinning = !m_showSkinning;
+		refresh();
+	} else if(selectedItem == memoryAction) {
+		m_showMemory = !m_showMemory;
+		if(m_showMemory) {
+			m_memoryTimer->start();
+		} else {
+			m_memoryTimer->stop();
+		}
+		refresh();
+	} else if(selectedItem == overheadAction) {
+		m_showOverhead = !m_showOverhead;
+		refresh();
+	} else if(selectedItem == signalsAction) {
+		m_showSignals = !m_showSignals;
+		refresh();
+	} else if(selectedItem == exportSignalsAction) {
+		QString fileName = QFileDialog::getSaveFileName(this, "Export Signal Log",
+		  QString(), "CSV Files (*.csv)");
+		if(!fileName.isEmpty()) {
+			m_signals.exportCsv(fileName);
+		}
+	} else if(selectedItem == exportGeometryAction) {
+		QString fileName = QFileDialog::getSaveFileName(this, "Export Geometry",
+		  QString(), "Geometry Files (*.dzgeom)");
+		if(!fileName.isEmpty()) {
+			DzGeometryExport::Result result = DzGeometryExport::write(fileName);
+			if(result.ok) {
+				QMessageBox::information(this, "Export Geometry",
+				  QString("%1 nodes, %2 vertices, %3 facets\n%4 MB written in %5 ms (%6 MB/s)\n"
+				  "on disk after %7 ms (%8 MB/s)")
+				  .arg(result.numNodes)
+				  .arg(result.numVerts)
+				  .arg(result.numFacets)
+				  .arg(result.numBytes / 1048576.0, 0, 'f', 1)
+				  .arg(result.nsecs / 1000000.0, 0, 'f', 0)
+				  .arg(result.getMBPerSec(), 0, 'f', 0)
+				  .arg(result.syncedNsecs / 1000000.0, 0, 'f', 0)
+				  .arg(result.getSyncedMBPerSec(), 0, 'f', 0));
+			} else {
+				QMessageBox::warning(this, "Export Geometry", result.error);
+			}
+		}
+	} else if(selectedItem == serverAction) {
+		if(m_statsServer->isRunning()) {
+			m_statsServer->stop();
+		} else {
+			m_statsServer->start( DzStatsServer::getDefaultName() );
+		}
+		refresh();
 	} else if(selectedItem == refreshAction) {
+	  // Also picks up renamed nodes
+		m_nodeIndex.clear();
+		refresh();
+	}
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::showEvent( QShowEvent *event ) {
+	DzPane::showEvent( event );
+
+  // Catch up on whatever changed while the pane was hidden
+	if( m_dirty ) {
 		refresh();
 	}
+	if( m_showMemory ) {
+		m_memoryTimer->start();
+	}
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::hideEvent( QHideEvent *event ) {
+	DzPane::hideEvent( event );
+	m_memoryTimer->stop();
+}
+
+/**
+	While the pane is closed or on a hidden tab, only remember that the
+	output is out of date. Returns true if the caller should do nothing.
+	The signal recorder times the whole handler that was deferred.
+**/
+bool DzSceneInfoPaneEx::deferWhileHidden() {
+	if( isVisible() ) {
+		return false;
+	}
+
+	m_dirty = true;
+	m_signals.markDeferred();
+	return true;
+}
+
+/**
+	Refresh when a node is shown or hidden, so the render-visible totals follow
+	the visibility toggles. Connections that already exist are not duplicated.
+**/
+void DzSceneInfoPaneEx::watchVisibility() {
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		connect( node, SIGNAL(visibilityChanged()), this, SLOT(visibilityChanged()), Qt::UniqueConnection );
+		if( node->metaObject()->indexOfSignal( "renderVisibilityChanged()" ) >= 0 ) {
+			connect( node, SIGNAL(renderVisibilityChanged()), this, SLOT(visibilityChanged()), Qt::UniqueConnection );
+		}
+	}
 }
 
 /**
  **/
 void DzSceneInfoPaneEx::blockRefresh() {
+	DzSignalScope scope( m_signals, DzSignalRecorder::LoadOrClearStarting );
+
   // A scene file is being loaded - block the refresh functions
 	m_refreshBlocked = true;
 }
@@ -174,38 +564,71 @@ void DzSceneInfoPaneEx::blockRefresh() {
  **/
 void DzSceneInfoPaneEx::unblockRefresh() {
   // A scene file just finished loading - unblock the refresh functions, 
-  // and force an update of our data.
+  // and force an update of our data. Nodes and shapes may have been
+  // deleted, so drop the cached stats.
 	m_refreshBlocked = false;
+	m_statsCache.forgetFiles();
+	m_histograms.clear();
+	m_tree.clear();
+	m_selection.clear();
+	m_nodeIndex.clear();
+	m_budgets.clear();
+	m_propSnapshot.clear();
+	m_propCurrent.clear();
+	m_materialDedup->clear();
+	m_assets.clear();
+	m_bounds.clear();
+	m_geomProfiler.clear();
+	m_vertexCache.clear();
+	m_hygiene.clear();
+	m_skinning.clear();
 	refresh();
 }
 
 /**
  **/
-void DzSceneInfoPaneEx::getNodeInfo( const DzNode *node, int &numVerts, int &numTris, int &numQuads ) {
-  // Collect information about the node's geometry
-	DzObject	*obj = node->getObject();
-	DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
-	DzGeometry	*geom = shape ? shape->getGeometry() : NULL;
-	numVerts = 0;
-	numTris = 0;
-	numQuads = 0;
+void DzSceneInfoPaneEx::unblockAfterLoad() {
+	DzSignalScope scope( m_signals, DzSignalRecorder::SceneLoaded );
+	m_sampleReason = DzMemorySample::SceneLoaded;
+	unblockRefresh();
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::unblockAfterClear() {
+	DzSignalScope scope( m_signals, DzSignalRecorder::SceneCleared );
+	m_sampleReason = DzMemorySample::SceneCleared;
+	unblockRefresh();
+}
 
-	if( shape == NULL || geom == NULL ) {
-		return;	// No geometry for the node
+/**
+ **/
+void DzSceneInfoPaneEx::sampleMemory() {
+	if( m_refreshBlocked ) {
+		return;
 	}
+	m_telemetry.record( DzMemorySample::Timer, m_totalVerts, m_totalTris + m_totalQuads,
+	  DzMaterial::getNumMaterials(), m_tree.getTotals().getEstimatedBytes() );
+}
 
-	numVerts = geom->getNumVertices();
-	DzFacetMesh	*mesh = qobject_cast<DzFacetMesh*>( geom );
-	if( mesh ) {
-		int		i, nFacets = mesh->getNumFacets();
-		DzFacet	*facets = mesh->getFacetsPtr();
+/**
+	Only the decimation advisor depends on the camera, so only its section is
+	redrawn; the node bounds are kept so it reprojects them without touching
+	the geometry
+**/
+void DzSceneInfoPaneEx::cameraMoved() {
+	DzSignalScope scope( m_signals, DzSignalRecorder::CameraMoved );
+	if( m_showDecimation ) {
+		redrawSection( DecimationSection, &DzSceneInfoPaneEx::writeDecimation );
+	}
+}
 
-		for( i = 0; i < nFacets; i++ ) {
-			if( facets[i].isQuad() )
-			  numQuads++;
-			else
-			  numTris++;
-		}
+/**
+	Only the nodes section depends on the filter
+**/
+void DzSceneInfoPaneEx::filterChanged() {
+	if( m_showNodes ) {
+		redrawSection( NodesSection, &DzSceneInfoPaneEx::writeNodes );
 	}
 }
 
@@ -216,31 +639,98 @@ void DzSceneInfoPaneEx::refresh() {
 	  // Ignore signals during scene load
 		return;
 	}
+	if( deferWhileHidden() ) {
+		return;
+	}
 
-	int	numVerts, numTris, numQuads;
-	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	QElapsedTimer timer;
+	timer.start();
+	m_dirty = false;
 
   // Clear out any previous data
-	m_output->clear();
-	m_totalVerts = 0;
-	m_totalTris = 0;
-	m_totalQuads = 0;
+	clearOutput();
 
-  // Iterate over all the nodes in the scene and collect data for them
-	while( nodeIter.hasNext() ) {
-		getNodeInfo( nodeIter.next(), numVerts, numTris, numQuads );
-		m_totalVerts += numVerts;
-		m_totalTris += numTris;
-		m_totalQuads += numQuads;
-	}
+  // Bring the cached node stats up to date with the scene; only nodes that
+  // were added, removed, re-parented or changed geometry are rescanned
+	m_tree.sync();
 
-  // Ignore signals during scene load
-	if( m_refreshBlocked ) {
-		return;
+  // Keep the node index's counts in step with the tree here, so a filter
+  // keystroke only runs the query
+	if( m_nodeIndex.isBuilt() ) {
+		m_nodeIndex.sync( m_tree );
+	}
+	if( m_showScene && m_showRenderVisible ) {
+		watchVisibility();
 	}
+	const DzGeomStats &totals = m_tree.getTotals();
+	m_totalVerts = totals.numVerts;
+	m_totalTris = totals.numTris;
+	m_totalQuads = totals.numQuads;
+
+  // Record the process memory against the new totals
+	m_telemetry.record( m_sampleReason, m_totalVerts, m_totalTris + m_totalQuads,
+	  DzMaterial::getNumMaterials(), totals.getEstimatedBytes() );
+	m_sampleReason = DzMemorySample::Refresh;
 
   // Refresh the output
 	refreshInfo( dzScene->getPrimarySelection() );
+
+	m_lastRefreshNsecs = timer.nsecsElapsed();
+	m_refreshNsecs += m_lastRefreshNsecs;
+	m_numRefreshes++;
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::nodeListChanged() {
+	DzSignalScope scope( m_signals, DzSignalRecorder::NodeListChanged );
+	refresh();
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::primarySelectionChanged( DzNode *node ) {
+	DzSignalScope scope( m_signals, DzSignalRecorder::PrimarySelectionChanged );
+	refreshInfo( node );
+}
+
+/**
+	Only the selection totals depend on the full selection; the other sections
+	follow the primary selection
+**/
+void DzSceneInfoPaneEx::selectionListChanged() {
+	DzSignalScope scope( m_signals, DzSignalRecorder::SelectionListChanged );
+	if( m_showSelectionTotals ) {
+		refreshInfo( dzScene->getPrimarySelection() );
+	}
+}
+
+/**
+	The index only queues the node; it is read on the next filtered refresh
+**/
+void DzSceneInfoPaneEx::nodeAdded( DzNode *node ) {
+	DzSignalScope scope( m_signals, DzSignalRecorder::NodeAdded );
+	m_nodeIndex.nodeAdded( node );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::nodeRemoved( DzNode *node ) {
+	DzSignalScope scope( m_signals, DzSignalRecorder::NodeRemoved );
+	m_nodeIndex.nodeRemoved( node );
+	m_geomProfiler.nodeRemoved( node );
+	m_histograms.nodeRemoved( node );
+	if( node == m_propSnapshot.getNode() ) {
+		m_propSnapshot.clear();
+		m_propCurrent.clear();
+	}
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::visibilityChanged() {
+	DzSignalScope scope( m_signals, DzSignalRecorder::VisibilityChanged );
+	refresh();
 }
 
 /**
@@ -250,18 +740,33 @@ void DzSceneInfoPaneEx::refreshInfo( DzNode *node ) {
 	  // Ignore signals during scene load
 		return;
 	}
+	if( deferWhileHidden() ) {
+		return;
+	}
 
   // Clear out any previous data
-	m_output->clear();
+	clearOutput();
 
   // Write data for the scene
 	if(m_showScene) {
 		writeSceneInfo();
 	}
 
+  // Write the budget checks; only those whose inputs changed are recomputed
+	if(m_showBudgets) {
+		writeBudgets();
+	}
+
   // Write data for the scene nodes
 	if(m_showNodes) {
+		beginSection( NodesSection );
 		writeNodes();
+		endSection( NodesSection );
+	}
+
+  // Write the node hierarchy with subtree totals
+	if(m_showHierarchy) {
+		writeHierarchy();
 	}
 
   // Write data for the primary selection
@@ -269,6 +774,11 @@ void DzSceneInfoPaneEx::refreshInfo( DzNode *node ) {
 		writeSelectedNode( dzScene->getPrimarySelection() );
 	}
 
+  // Write the totals for every selected node
+	if(m_showSelectionTotals) {
+		writeSelectionTotals();
+	}
+
   // Write data for the object associated with the node
 	if(m_showSelectedObject) {
 		writeSelectedObjectInfo(node);
@@ -279,10 +789,151 @@ void DzSceneInfoPaneEx::refreshInfo( DzNode *node ) {
 		writeSelectedPropertyInfo(node);
 	}
 
+  // Write the properties that changed since the snapshot
+	if(m_showPropertyDiff) {
+		writePropertyDiff();
+	}
+
   // Write the materials
 	if(m_showMaterials) {
 		writeMaterialInfo();
 	}
+
+  // Write the materials that could be consolidated
+	if(m_showMaterialDedup) {
+		writeMaterialDedup();
+	}
+
+  // Write the asset files ranked by cost
+	if(m_showAssetGraph) {
+		writeAssetGraph();
+	}
+
+  // Write the nodes that are too dense for their size on screen
+	if(m_showDecimation) {
+		beginSection( DecimationSection );
+		writeDecimation();
+		endSection( DecimationSection );
+	}
+
+  // Write the nodes each light reaches
+	if(m_showLightInfluence) {
+		writeLightInfluence();
+	}
+
+  // Write the nodes and modifiers that were slowest to rebuild
+	if(m_showGeomProfile) {
+		writeGeometryProfile();
+	}
+
+  // Write the meshes whose facet order reuses the vertex cache worst
+	if(m_showVertexCache) {
+		writeVertexCache();
+	}
+
+  // Write the morph audit for the selected figure or all figures
+	if(m_showMorphAudit) {
+		writeMorphAudit(node);
+	}
+
+  // Write the mesh hygiene report for the selected node and the scene
+	if(m_showMeshHygiene) {
+		writeMeshHygiene(node);
+	}
+
+  // Write the skinning cost of the selected figure
+	if(m_showSkinning) {
+		writeSkinning(node);
+	}
+
+  // Write the process memory against the scene totals
+	if(m_showMemory) {
+		writeMemoryTelemetry();
+	}
+
+  // Write the time spent by the pane itself
+	if(m_showOverhead) {
+		writeOverhead();
+	}
+
+  // Write the scene signals received and the time spent on them
+	if(m_showSignals) {
+		writeSignals();
+	}
+
+  // Store the stats computed for new assets
+	m_statsCache.flush();
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::clearOutput() {
+	m_output->clear();
+	m_outputHtml.clear();
+	for( int i = 0; i < NumSections; i++ ) {
+		m_sections[i].begin = m_sections[i].end = -1;
+	}
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::appendOutput( const QString &html ) {
+	m_output->append( html );
+	m_outputHtml.append( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::beginSection( Section section ) {
+	m_sections[section].begin = m_outputHtml.count();
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::endSection( Section section ) {
+	m_sections[section].end = m_outputHtml.count();
+}
+
+/**
+	Write one section again and put the HTML of the others back around it,
+	so the other sections are not recomputed. Falls back to a full redraw if
+	the section is not in the output.
+**/
+void DzSceneInfoPaneEx::redrawSection( Section section, void (DzSceneInfoPaneEx::*write)() ) {
+	if( m_refreshBlocked || deferWhileHidden() ) {
+		return;
+	}
+	OutputRange &range = m_sections[section];
+	if( range.begin < 0 ) {
+		refreshInfo( dzScene->getPrimarySelection() );
+		return;
+	}
+
+	QStringList before = m_outputHtml.mid( 0, range.begin );
+	QStringList after = m_outputHtml.mid( range.end );
+	int oldEnd = range.end;
+	int scroll = m_output->verticalScrollBar()->value();
+
+	m_output->clear();
+	m_outputHtml.clear();
+	for( int i = 0; i < before.count(); i++ ) {
+		appendOutput( before[i] );
+	}
+	(this->*write)();
+	range.end = m_outputHtml.count();
+
+  // Sections after this one moved by the change in its length
+	int delta = range.end - oldEnd;
+	for( int i = 0; i < NumSections; i++ ) {
+		if( i != section && m_sections[i].begin >= oldEnd ) {
+			m_sections[i].begin += delta;
+			m_sections[i].end += delta;
+		}
+	}
+	for( int i = 0; i < after.count(); i++ ) {
+		appendOutput( after[i] );
+	}
+	m_output->verticalScrollBar()->setValue( scroll );
 }
 
 /**
@@ -326,20 +977,75 @@ void DzSceneInfoPaneEx::writeSceneInfo() {
 	  .arg( dzScene->getNumWSModifiers() );
 	html += "</table><br>";
 
-  // Generate the scene geometry table:
+  // Generate the scene geometry table, with the render-visible totals next to
+  // the scene totals if asked for
+	const DzGeomStats &totals = m_tree.getTotals();
+	const DzGeomStats &visible = m_tree.getVisibleTotals();
 	html += "<br>";
 	html += "<b>Scene Geometry : </b><br><table>";
-	html += QString( "<tr><td>Total Vertices : </td><td>%1</td></tr>" )
-	  .arg( m_totalVerts );
-	html += QString( "<tr><td>Total Triangles : </td><td>%1</td></tr>" )
-	  .arg( m_totalTris );
-	html += QString( "<tr><td>Total Quads : </td><td>%1</td></tr>" )
-	  .arg( m_totalQuads );
-	html += QString( "<tr><td>Total Faces : </td><td>%1</td></tr>" )
-	  .arg( m_totalTris + m_totalQuads );
+	if( m_showRenderVisible ) {
+		html += "<tr><td></td><td><b>Scene</b></td><td><b>Render Visible</b></td></tr>";
+	}
+	html += formatTotalRow( "Total Vertices",
+	  totals.numVerts, visible.numVerts, m_showRenderVisible );
+	html += formatTotalRow( "Total Triangles",
+	  totals.numTris, visible.numTris, m_showRenderVisible );
+	html += formatTotalRow( "Total Quads",
+	  totals.numQuads, visible.numQuads, m_showRenderVisible );
+	html += formatTotalRow( "Total Faces",
+	  totals.numTris + totals.numQuads, visible.numTris + visible.numQuads, m_showRenderVisible );
+
+  // Strand and curve geometry, if there is any
+	if( totals.numStrands > 0 ) {
+		html += formatTotalRow( "Total Strands",
+		  totals.numStrands, visible.numStrands, m_showRenderVisible );
+		html += formatTotalRow( "Total Segments",
+		  totals.numSegments, visible.numSegments, m_showRenderVisible );
+		html += formatTotalRow( "Total Control Points",
+		  totals.numControlPoints, visible.numControlPoints, m_showRenderVisible );
+		html += formatTotalRow( "Est. Tessellated Primitives",
+		  totals.numTessPrims, visible.numTessPrims, m_showRenderVisible );
+	}
 	html += "</table><br>";
 
-	m_output->append( html );
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeBudgets() {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+	m_budgets.evaluate( m_tree );
+
+	QString	html;
+	html += QString( "<b>Budgets : </b>%1, warn above %2%<br><table>" )
+	  .arg( m_budgets.getProject() )
+	  .arg( DzSceneBudget::getWarnFraction() * 100, 0, 'f', 0 );
+	for( int i = 0; i < DzSceneBudget::NumMetrics; i++ ) {
+		DzSceneBudget::Status status = m_budgets.getStatus( i );
+		if( status == DzSceneBudget::Off ) {
+			continue;
+		}
+		html += QString( "<tr><td>%1 : </td><td>%2</td><td>%3</td><td>of %4</td><td>%5</td></tr>" )
+		  .arg( formatBudgetBadge( status ) )
+		  .arg( DzSceneBudget::getMetricName( i ) )
+		  .arg( m_budgets.getValue( i ) )
+		  .arg( m_budgets.getLimit( i ) )
+		  .arg( m_budgets.getDetail( i ) );
+	}
+	html += "</table>";
+	if( m_budgets.getWorstStatus() == DzSceneBudget::Off ) {
+		html += "No budgets set<br>";
+	}
+	html += QString( "Rechecked %1 of %2 metrics<br><br>" )
+	  .arg( m_budgets.getNumChecked() )
+	  .arg( DzSceneBudget::NumMetrics );
+
+	appendOutput( html );
 }
 
 /**
@@ -349,21 +1055,52 @@ void DzSceneInfoPaneEx::writeNodes() {
 
   // Generate the nodes table
 	int nNodes = dzScene->getNumNodes();
-	html += QString( "<b>Nodes : %1</b><br><table>" )
-	  .arg( nNodes );
-
-  // Iterate over all the nodes in the scene
-	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	QString filter = m_filterEdit->text().trimmed();
 	DzNode *node = NULL;
 	DzSceneAssetFileInfo fileInfo = NULL;
-	while( nodeIter.hasNext() ) {
-		node = nodeIter.next();
-		fileInfo = node->getAssetFileInfo();
-		html += QString( "<tr><td>%1 : </td><td>%2</td></tr>" )
-		  .arg( node->getLabel() )
-		  .arg( fileInfo.getUri().getFilePath() );
+	if( filter.isEmpty() ) {
+		html += QString( "<b>Nodes : %1</b><br><table>" )
+		  .arg( nNodes );
+
+	  // Iterate over all the nodes in the scene
+		DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+		while( nodeIter.hasNext() ) {
+			node = nodeIter.next();
+			fileInfo = node->getAssetFileInfo();
+			html += QString( "<tr><td>%1 : </td><td>%2</td></tr>" )
+			  .arg( node->getLabel() )
+			  .arg( fileInfo.getUri().getFilePath() );
+		}
+		html += "</table><br>";
+	} else {
+	  // Only the matching nodes are written. The index is built by the first
+	  // filter and kept current by refresh(), so only the query is timed.
+		if( !m_nodeIndex.isBuilt() ) {
+			m_nodeIndex.sync( m_tree );
+		}
+		QElapsedTimer timer;
+		timer.start();
+		QList<DzNode*> matches;
+		int nMatches = m_nodeIndex.query( filter, c_maxFilterRows, matches );
+		qint64 nsecs = timer.nsecsElapsed();
+
+		html += QString( "<b>Nodes : %1 of %2 match</b> (%3 ms)<br><table>" )
+		  .arg( nMatches )
+		  .arg( nNodes )
+		  .arg( nsecs / 1000000.0, 0, 'f', 3 );
+		for( int i = 0; i < matches.count(); i++ ) {
+			node = matches[i];
+			fileInfo = node->getAssetFileInfo();
+			html += QString( "<tr><td>%1 : </td><td>%2</td></tr>" )
+			  .arg( node->getLabel() )
+			  .arg( fileInfo.getUri().getFilePath() );
+		}
+		html += "</table>";
+		if( nMatches > matches.count() ) {
+			html += QString( "%1 more not shown<br>" ).arg( nMatches - matches.count() );
+		}
+		html += "<br>";
 	}
-	html += "</table><br>";
 
   // Iterate over all the lights in the scene
 	int nLights = dzScene->getNumLights();
@@ -401,7 +1138,51 @@ void DzSceneInfoPaneEx::writeNodes() {
 	}
 	html += "</table><br>";
 
-	m_output->append( html );
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeHierarchy() {
+	QString	html;
+
+	html += "<b>Hierarchy : </b>Own / Subtree<br><table>";
+	html += "<tr><td></td><td>Vertices</td><td>Faces</td><td>Materials</td></tr>";
+
+  // Walk the node hierarchy depth first; the totals come from the cache
+	QList<DzNode*> stack;
+	QList<int> depths;
+	QList<DzNode*> roots = m_tree.getRoots();
+	for(int i = roots.count() - 1; i >= 0; i--) {
+		stack.append(roots[i]);
+		depths.append(0);
+	}
+	while(!stack.isEmpty()) {
+		DzNode *node = stack.takeLast();
+		int depth = depths.takeLast();
+		const DzSceneTree::Item *item = m_tree.getItem(node);
+		if(!item) {
+			continue;
+		}
+
+		html += QString( "<tr><td>%1%2 : </td><td>%3 / %4</td><td>%5 / %6</td><td>%7 / %8</td></tr>" )
+		  .arg( QString( "&nbsp;&nbsp;&nbsp;&nbsp;" ).repeated( depth ) )
+		  .arg( node->getLabel() )
+		  .arg( item->own.numVerts )
+		  .arg( item->subtree.numVerts )
+		  .arg( item->own.getNumFacets() )
+		  .arg( item->subtree.getNumFacets() )
+		  .arg( item->own.numMaterials )
+		  .arg( item->subtree.numMaterials );
+
+		for(int i = node->getNumNodeChildren() - 1; i >= 0; i--) {
+			stack.append(node->getNodeChild(i));
+			depths.append(depth + 1);
+		}
+	}
+	html += "</table><br>";
+
+	appendOutput( html );
 }
 
 /**
@@ -412,26 +1193,17 @@ void DzSceneInfoPaneEx::writeSelectedNode( DzNode *node ) {
 		return;
 	}
 
-	int		tNumVerts = 0, tNumTris = 0, tNumQuads = 0;
+	DzGeomStats	total;
 	QString	html;
 
 	if( node ) {
-	  // Get the stats for the primary selection
-		getNodeInfo( node, tNumVerts, tNumTris, tNumQuads );
-
-		if( node->inherits( "DzSkeleton" ) ) {
-		  // If the primary selection is a figure, add the stats for all the bones also
-			DzBoneList bones;
-			int	i, n, numVerts, numTris, numQuads;
-
-			((DzSkeleton*)node)->getAllBones( bones );
-			for( i = 0, n = bones.count(); i < n; i++ ) {
-				getNodeInfo( bones[i], numVerts, numTris, numQuads );
-				tNumVerts += numVerts;
-				tNumTris += numTris;
-				tNumQuads += numQuads;
-			}
-		}
+	  // Get the stats for the primary selection; for a figure, the stats of
+	  // all the bones are added also
+		total = m_tree.getFigureTotals( node );
+
+	  // The node and everything parented to it
+		const DzSceneTree::Item *item = m_tree.getItem( node );
+		DzGeomStats subtree = item ? item->subtree : total;
 
 	  // Write the html output for the primary selection stats
 		html += "<b>Primary Selection : </b><br><table>";
@@ -449,22 +1221,73 @@ void DzSceneInfoPaneEx::writeSelectedNode( DzNode *node ) {
 		  .arg( node->getSource().getFilePath() );
 		html += QString( "<tr><td>File Path : </td><td>%1</td></tr>" )
 		  .arg( node->getAssetFileInfo().getUri().getFilePath() );
-		html += QString( "<tr><td>Vertices : </td><td>%1</td></tr>" ).arg( tNumVerts );
-		html += QString( "<tr><td>Triangles : </td><td>%1</td></tr>" ).arg( tNumTris );
-		html += QString( "<tr><td>Quads : </td><td>%1</td></tr>" ).arg( tNumQuads );
-		html += QString( "<tr><td>Total Faces : </td><td>%1</td></tr>" ).arg( tNumTris + tNumQuads );
+		html += QString( "<tr><td>Vertices : </td><td>%1</td></tr>" ).arg( total.numVerts );
+		html += QString( "<tr><td>Triangles : </td><td>%1</td></tr>" ).arg( total.numTris );
+		html += QString( "<tr><td>Quads : </td><td>%1</td></tr>" ).arg( total.numQuads );
+		html += QString( "<tr><td>Total Faces : </td><td>%1</td></tr>" ).arg( total.getNumFacets() );
+		if( total.numStrands > 0 ) {
+			html += QString( "<tr><td>Strands : </td><td>%1</td></tr>" ).arg( total.numStrands );
+			html += QString( "<tr><td>Segments : </td><td>%1</td></tr>" ).arg( total.numSegments );
+			html += QString( "<tr><td>Control Points : </td><td>%1</td></tr>" ).arg( total.numControlPoints );
+			html += QString( "<tr><td>Est. Tessellated Primitives : </td><td>%1</td></tr>" ).arg( total.numTessPrims );
+		}
+		html += QString( "<tr><td>Subtree Vertices : </td><td>%1</td></tr>" ).arg( subtree.numVerts );
+		html += QString( "<tr><td>Subtree Faces : </td><td>%1</td></tr>" ).arg( subtree.getNumFacets() );
+		html += QString( "<tr><td>Subtree Materials : </td><td>%1</td></tr>" ).arg( subtree.numMaterials );
 		html += "</table><br>";
-		m_output->append( html );
+		appendOutput( html );
 	} else {
 	  // No primary selection
 		html += "<br>";
 		html += "<b>Primary Selection : </b>None<br>";
-		m_output->append( html );
+		appendOutput( html );
 	}
 }
 
 /**
- **/
+	Render counts every selected node; Memory counts each geometry once, so
+	instances and shared geometry only add to the first column
+**/
+void DzSceneInfoPaneEx::writeSelectionTotals() {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+  // Only the nodes that entered or left the selection are looked up
+	m_selection.update( m_tree );
+	const DzGeomStats &render = m_selection.getRenderTotals();
+	const DzGeomStats &unique = m_selection.getUniqueTotals();
+
+	QString	html;
+	html += "<b>Selection Totals : </b><br><table>";
+	html += QString( "<tr><td>Members : </td><td>%1</td></tr>" ).arg( m_selection.getNumMembers() );
+	html += QString( "<tr><td>Selected Nodes : </td><td>%1</td></tr>" ).arg( m_selection.getNumSelected() );
+	html += QString( "<tr><td>Bones : </td><td>%1</td></tr>" ).arg( m_selection.getNumBones() );
+	html += QString( "<tr><td>Instances : </td><td>%1</td></tr>" ).arg( m_selection.getNumInstances() );
+	html += QString( "<tr><td>Distinct Geometries : </td><td>%1</td></tr>" ).arg( m_selection.getNumGeometries() );
+	html += "</table><table>";
+	html += "<tr><td></td><td><b>Render</b></td><td><b>Memory</b></td></tr>";
+	html += formatTotalRow( "Vertices", render.numVerts, unique.numVerts, true );
+	html += formatTotalRow( "Triangles", render.numTris, unique.numTris, true );
+	html += formatTotalRow( "Quads", render.numQuads, unique.numQuads, true );
+	html += formatTotalRow( "Total Faces", render.getNumFacets(), unique.getNumFacets(), true );
+	if( render.numStrands > 0 ) {
+		html += formatTotalRow( "Strands", render.numStrands, unique.numStrands, true );
+		html += formatTotalRow( "Segments", render.numSegments, unique.numSegments, true );
+	}
+	html += QString( "<tr><td>Est. Size (MB) : </td><td>%1</td><td>%2</td></tr>" )
+	  .arg( formatMB( render.getEstimatedBytes() ) )
+	  .arg( formatMB( unique.getEstimatedBytes() ) );
+	html += "</table>";
+	html += QString( "Updated %1 of %2 members<br>" )
+	  .arg( m_selection.getNumChanged() )
+	  .arg( m_selection.getNumMembers() );
+	appendOutput( html );
+}
+
+/**
+ **/
 void DzSceneInfoPaneEx::writeSelectedObjectInfo( DzNode *node ) {
 	if( m_refreshBlocked ) {
 	  // Ignore signals during scene load
@@ -479,7 +1302,7 @@ void DzSceneInfoPaneEx::writeSelectedObjectInfo( DzNode *node ) {
 	html += QString( "<b>Primary Selection - Object : %1</b><br>" )
 	  .arg( obj ? "" : "No Object" );
 	if(obj == NULL) {
-		m_output->append( html );
+		appendOutput( html );
 		return;
 	}
 
@@ -508,6 +1331,14 @@ void DzSceneInfoPaneEx::writeSelectedObjectInfo( DzNode *node ) {
 		}
 		qSort(materialsList.begin(), materialsList.end(), compareMaterials);
 
+	  // Get the per-material facet histogram for the shape, and map each
+	  // material to the index used by the facets
+		const DzMaterialHistogram *histogram = m_histograms.getHistogram(shape);
+		QHash<const DzMaterial*, int> materialIndices;
+		for(int j = 0, n = shape->getNumMaterials(); j < n; j++) {
+			materialIndices.insert(shape->getMaterial(j), j);
+		}
+
 		html += QString( "<tr><td>Shape %1 : </td><td>Materials : %2</td></tr>" )
 		  .arg( i )
 		  .arg(nMaterials);
@@ -518,18 +1349,22 @@ void DzSceneInfoPaneEx::writeSelectedObjectInfo( DzNode *node ) {
 			if(texture) {
 				fileName = texture->getFilename();
 			}
+			QString counts = formatFacetCounts(histogram,
+			  materialIndices.value(material, -1));
 			if(fileName.isEmpty()) {
 			  // Show diffuse color
-				html += QString( "<tr><td>&nbsp;&nbsp;&nbsp;&nbsp;%1 : </td><td>Diffuse : %2 %3 %4</td></tr>" )
+				html += QString( "<tr><td>&nbsp;&nbsp;&nbsp;&nbsp;%1 : </td><td>Diffuse : %2 %3 %4</td><td>%5</td></tr>" )
 				  .arg( material->getName() )
 				  .arg(material->getDiffuseColor().red())
 				  .arg(material->getDiffuseColor().green())
-				  .arg(material->getDiffuseColor().blue());
+				  .arg(material->getDiffuseColor().blue())
+				  .arg(counts);
 			} else {
 			  // Show filename
-				html += QString( "<tr><td>&nbsp;&nbsp;&nbsp;&nbsp;%1 : </td><td>%2</td></tr>" )
+				html += QString( "<tr><td>&nbsp;&nbsp;&nbsp;&nbsp;%1 : </td><td>%2</td><td>%3</td></tr>" )
 				  .arg( material->getName() )
-				  .arg(fileName);
+				  .arg(fileName)
+				  .arg(counts);
 			}
 		}
 #else
@@ -547,7 +1382,7 @@ void DzSceneInfoPaneEx::writeSelectedObjectInfo( DzNode *node ) {
 #endif
 	}
 	html += "</table><br>";
-	m_output->append( html );
+	appendOutput( html );
 }
 
 /**
@@ -639,7 +1474,690 @@ void DzSceneInfoPaneEx::writeMaterialInfo() {
 	}
 
 	html += "</table><br>";
-	m_output->append( html );
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeMaterialDedup() {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+	DzMaterialDedup::Report report = m_materialDedup->analyze();
+
+	QString	html;
+	html += QString( "<b>Material Dedup : </b>%1 materials, %2 unique<br><table>" )
+	  .arg( report.numMaterials )
+	  .arg( report.numUnique );
+  // Each material carries its own shader, so they are redundant together
+	html += QString( "<tr><td>Redundant Materials (and Shaders) : </td><td>%1</td></tr>" )
+	  .arg( report.numRedundant );
+	html += QString( "<tr><td>Texture Bindings : </td><td>%1</td><td>Redundant %2</td></tr>" )
+	  .arg( report.numTextureBindings )
+	  .arg( report.numRedundantBindings );
+	html += QString( "<tr><td>Rehashed : </td><td>%1</td></tr>" )
+	  .arg( report.numRehashed );
+	html += "</table><br>";
+
+  // List the largest groups of identical materials
+	html += "<table>";
+	for(int i = 0; i < report.groups.count() && i < c_maxDedupGroups; i++) {
+		const DzMaterialDedup::Group &group = report.groups[i];
+		QStringList names;
+		for(int j = 0; j < group.materials.count(); j++) {
+			names.append( group.materials[j]->getName() );
+		}
+		html += QString( "<tr><td>%1 x : </td><td>%2</td></tr>" )
+		  .arg( group.materials.count() )
+		  .arg( names.join( ", " ) );
+	}
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeAssetGraph() {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+	m_assets.build();
+	const QList<DzAssetFile> &files = m_assets.getFiles();
+
+	int nAssets = 0, nTextures = 0, nMissing = 0;
+	qint64 totalBytes = 0;
+	for(int i = 0; i < files.count(); i++) {
+		if(files[i].kind == DzAssetFile::Asset) {
+			nAssets++;
+		} else {
+			nTextures++;
+		}
+		if(!files[i].exists) {
+			nMissing++;
+		}
+		totalBytes += files[i].size;
+	}
+
+	QString	html;
+	html += QString( "<b>Asset Graph : </b>%1 assets, %2 textures, %3 MB<br><table>" )
+	  .arg( nAssets )
+	  .arg( nTextures )
+	  .arg( formatMB( totalBytes ) );
+	html += QString( "<tr><td>Missing Files : </td><td>%1</td></tr>" ).arg( nMissing );
+	html += QString( "<tr><td>Files Checked : </td><td>%1</td></tr>" ).arg( m_assets.getNumStatted() );
+	html += "</table><br>";
+
+  // The same files ranked two ways
+	for(int pass = 0; pass < 2; pass++) {
+		QList<int> ranked = pass == 0 ? m_assets.getRankedByBytes() : m_assets.getRankedByRefs();
+		html += pass == 0 ? "<b>By Total Size : </b><br><table>" : "<b>By References : </b><br><table>";
+		html += "<tr><td></td><td>Refs</td><td>Own MB</td><td>Total MB</td><td>Textures</td></tr>";
+		for(int i = 0; i < ranked.count() && i < c_maxAssetRows; i++) {
+			const DzAssetFile &file = files[ranked[i]];
+			html += QString( "<tr><td>%1%2 : </td><td>%3</td><td>%4</td><td>%5</td><td>%6</td></tr>" )
+			  .arg( QFileInfo( file.path ).fileName() )
+			  .arg( file.exists ? "" : " (missing)" )
+			  .arg( file.numRefs )
+			  .arg( formatMB( file.size ) )
+			  .arg( formatMB( file.totalBytes ) )
+			  .arg( file.kind == DzAssetFile::Asset ? QString::number( file.textures.count() ) : QString() );
+		}
+		html += "</table><br>";
+	}
+
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeDecimation() {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+  // The camera of the active viewport, at the render resolution
+	DzMainWindow *mainWindow = dzApp->getInterface();
+	DzViewportMgr *viewportMgr = mainWindow ? mainWindow->getViewportMgr() : NULL;
+	DzViewport *viewport = viewportMgr ? viewportMgr->getActiveViewport() : NULL;
+	DzCamera *camera = viewport ? viewport->get3DViewport()->getCamera() : NULL;
+	QSize imageSize = dzApp->getRenderMgr()->getRenderOptions()->getImageSize();
+
+	QString	html;
+	if( camera == NULL ) {
+		html += "<b>Decimation Advisor : </b>No active camera<br><br>";
+		appendOutput( html );
+		return;
+	}
+
+  // Follow the camera as it moves
+	connect( camera, SIGNAL(transformChanged()), m_cameraTimer, SLOT(start()), Qt::UniqueConnection );
+	if( camera->metaObject()->indexOfSignal( "projectionChanged()" ) >= 0 ) {
+		connect( camera, SIGNAL(projectionChanged()), m_cameraTimer, SLOT(start()), Qt::UniqueConnection );
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	DzDecimationAdvisor::Report report = m_decimation.analyze( camera, imageSize, m_tree );
+	qint64 nsecs = timer.nsecsElapsed();
+
+	html += QString( "<b>Decimation Advisor : </b>%1, %2 x %3, %4 mm<br><table>" )
+	  .arg( camera->getLabel() )
+	  .arg( report.imageSize.width() )
+	  .arg( report.imageSize.height() )
+	  .arg( report.focalLength );
+	html += QString( "<tr><td>Target : </td><td>%1 facets per pixel</td></tr>" )
+	  .arg( m_decimation.getTarget() );
+	html += QString( "<tr><td>Visible Nodes : </td><td>%1</td></tr>" )
+	  .arg( report.numNodes );
+	html += QString( "<tr><td>Over Target : </td><td>%1</td></tr>" )
+	  .arg( report.entries.count() );
+	html += QString( "<tr><td>Off Screen : </td><td>%1</td><td>%2 facets</td></tr>" )
+	  .arg( report.numOffScreen )
+	  .arg( report.offScreenFacets );
+	html += QString( "<tr><td>Time : </td><td>%1 ms</td><td>%2 bounds computed</td></tr>" )
+	  .arg( nsecs / 1000000.0, 0, 'f', 2 )
+	  .arg( report.numBounded );
+	html += "</table><br>";
+
+  // The densest nodes first
+	html += "<table>";
+	html += "<tr><td></td><td>Facets</td><td>Pixels</td><td>Per Pixel</td><td>x Target</td></tr>";
+	for(int i = 0; i < report.entries.count() && i < c_maxDecimationRows; i++) {
+		const DzDecimationAdvisor::Entry &entry = report.entries[i];
+		html += QString( "<tr><td>%1 : </td><td>%2</td><td>%3</td><td>%4</td><td>%5</td></tr>" )
+		  .arg( entry.node->getLabel() )
+		  .arg( entry.numFacets )
+		  .arg( entry.numPixels, 0, 'f', 0 )
+		  .arg( entry.facetsPerPixel, 0, 'f', 2 )
+		  .arg( entry.overTarget, 0, 'f', 1 );
+	}
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
+/**
+	Lights by the facets they reach, then the nodes reached by the most lights
+**/
+void DzSceneInfoPaneEx::writeLightInfluence() {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	DzLightInfluence::Report report = m_lightInfluence.analyze( m_tree );
+	qint64 nsecs = timer.nsecsElapsed();
+
+	QString	html;
+	html += QString( "<b>Light Influence : </b>%1 lights, %2 visible nodes<br><table>" )
+	  .arg( report.numLights )
+	  .arg( report.numNodes );
+	html += QString( "<tr><td>Lit Pairs : </td><td>%1</td><td>%2 per node</td></tr>" )
+	  .arg( report.numPairs )
+	  .arg( report.numNodes > 0 ? (double)report.numPairs / report.numNodes : 0.0, 0, 'f', 2 );
+	html += QString( "<tr><td>Tests : </td><td>%1</td><td>of %2 pairs</td></tr>" )
+	  .arg( report.numTests )
+	  .arg( (qint64)report.numLights * report.numNodes );
+	html += QString( "<tr><td>Grid : </td><td>%1 cells</td><td>%2 large nodes</td></tr>" )
+	  .arg( report.numCells )
+	  .arg( report.numLarge );
+	html += QString( "<tr><td>Time : </td><td>%1 ms</td><td>%2 bounds computed</td></tr>" )
+	  .arg( nsecs / 1000000.0, 0, 'f', 2 )
+	  .arg( report.numBounded );
+	html += "</table><br>";
+
+  // The costliest lights first
+	html += "<table>";
+	html += "<tr><td></td><td>Type</td><td>Range</td><td>Nodes</td><td>Facets</td></tr>";
+	for(int i = 0; i < report.lights.count() && i < c_maxLightRows; i++) {
+		const DzLightInfluence::LightEntry &entry = report.lights[i];
+		html += QString( "<tr><td>%1 : </td><td>%2</td><td>%3</td><td>%4</td><td>%5</td></tr>" )
+		  .arg( entry.light->getLabel() )
+		  .arg( entry.kind )
+		  .arg( entry.range > 0 ? QString::number( entry.range, 'f', 0 ) : QString( "-" ) )
+		  .arg( entry.numNodes )
+		  .arg( entry.numFacets );
+	}
+	html += "</table><br>";
+
+  // The nodes shaded by the most lights
+	html += "<table>";
+	html += "<tr><td></td><td>Lights</td><td>Facets</td></tr>";
+	for(int i = 0; i < report.nodes.count() && i < c_maxLightRows; i++) {
+		const DzLightInfluence::NodeEntry &entry = report.nodes[i];
+		html += QString( "<tr><td>%1 : </td><td>%2</td><td>%3</td></tr>" )
+		  .arg( entry.node->getLabel() )
+		  .arg( entry.numLights )
+		  .arg( entry.numFacets );
+	}
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
+/**
+	The nodes whose geometry took longest to rebuild in the last profile,
+	then the modifier classes they use
+**/
+void DzSceneInfoPaneEx::writeGeometryProfile() {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+	if( m_geomProfiler.isEmpty() ) {
+		appendOutput( "<b>Geometry Profile : </b>Not run; use Profile Selected Geometry or Profile Scene Geometry<br>" );
+		return;
+	}
+
+	const DzGeometryProfiler::Report &report = m_geomProfiler.getReport();
+	qint64 totalNsecs = 0;
+	for(int i = 0; i < report.nodes.count(); i++) {
+		totalNsecs += report.nodes[i].medianNsecs;
+	}
+
+	QString	html;
+	html += QString( "<b>Geometry Profile : </b>%1 nodes, %2 passes<br><table>" )
+	  .arg( report.numNodes )
+	  .arg( report.numPasses );
+	html += QString( "<tr><td>Rebuild : </td><td>%1 ms</td><td>median, all nodes</td></tr>" )
+	  .arg( totalNsecs / 1000000.0, 0, 'f', 2 );
+	html += QString( "<tr><td>Time : </td><td>%1 ms</td><td>whole profile</td></tr>" )
+	  .arg( report.totalNsecs / 1000000.0, 0, 'f', 1 );
+	html += "</table><br>";
+
+  // The slowest nodes first
+	html += "<table>";
+	html += "<tr><td></td><td>Median ms</td><td>Min ms</td><td>Vertices</td>"
+	  "<td>Modifiers</td><td>Dialed</td><td>World</td></tr>";
+	for(int i = 0; i < report.nodes.count() && i < c_maxProfileRows; i++) {
+		const DzGeometryProfiler::NodeEntry &entry = report.nodes[i];
+		html += QString( "<tr><td>%1 : </td><td>%2</td><td>%3</td><td>%4</td>"
+		  "<td>%5</td><td>%6</td><td>%7</td></tr>" )
+		  .arg( entry.node->getLabel() )
+		  .arg( entry.medianNsecs / 1000000.0, 0, 'f', 3 )
+		  .arg( entry.minNsecs / 1000000.0, 0, 'f', 3 )
+		  .arg( entry.numVerts )
+		  .arg( entry.numModifiers )
+		  .arg( entry.numDialedMorphs )
+		  .arg( entry.numWSModifiers );
+	}
+	html += "</table><br>";
+
+  // The modifier classes, most working instances first; they are counted,
+  // not timed
+	html += "<table>";
+	html += "<tr><td></td><td>Working</td><td>Instances</td><td>Nodes</td></tr>";
+	for(int i = 0; i < report.modifiers.count() && i < c_maxProfileRows; i++) {
+		const DzGeometryProfiler::ModifierEntry &entry = report.modifiers[i];
+		html += QString( "<tr><td>%1 : </td><td>%2</td><td>%3</td><td>%4</td></tr>" )
+		  .arg( entry.className )
+		  .arg( entry.numWorking )
+		  .arg( entry.numInstances )
+		  .arg( entry.numNodes );
+	}
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
+/**
+	The meshes whose facet order wastes the most vertex transforms
+**/
+void DzSceneInfoPaneEx::writeVertexCache() {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	DzVertexCacheAnalysis::Report report = m_vertexCache.analyze( m_tree );
+	qint64 nsecs = timer.nsecsElapsed();
+
+	double acmr = report.numTris > 0 ? (double)report.fifoMisses / report.numTris : 0.0;
+	double optimized = report.numTris > 0 ? (double)report.optimizedMisses / report.numTris : 0.0;
+
+	QString	html;
+	html += QString( "<b>Vertex Cache : </b>%1 meshes, %2 triangles<br><table>" )
+	  .arg( report.numNodes )
+	  .arg( report.numTris );
+	html += QString( "<tr><td>ACMR : </td><td>%1</td><td>%2 after reordering</td></tr>" )
+	  .arg( acmr, 0, 'f', 3 )
+	  .arg( optimized, 0, 'f', 3 );
+	html += QString( "<tr><td>Transforms : </td><td>%1</td><td>%2 saved by reordering</td></tr>" )
+	  .arg( report.fifoMisses )
+	  .arg( report.fifoMisses - report.optimizedMisses );
+	html += QString( "<tr><td>Time : </td><td>%1 ms</td><td>%2 meshes analyzed</td></tr>" )
+	  .arg( nsecs / 1000000.0, 0, 'f', 2 )
+	  .arg( report.numAnalyzed );
+	html += "</table><br>";
+
+  // The worst offenders first
+	html += "<table>";
+	html += QString( "<tr><td></td><td>Triangles</td><td>ACMR</td><td>LRU %1</td><td>ATVR</td>"
+	  "<td>Reordered</td><td>Gain</td></tr>" ).arg( DzVertexCacheAnalysis::getLruSize() );
+	for(int i = 0; i < report.entries.count() && i < c_maxVertexCacheRows; i++) {
+		const DzVertexCacheAnalysis::Entry &entry = report.entries[i];
+		html += QString( "<tr><td>%1 : </td><td>%2</td><td>%3</td><td>%4</td><td>%5</td>"
+		  "<td>%6</td><td>%7%</td></tr>" )
+		  .arg( entry.node->getLabel() )
+		  .arg( entry.stats.numTris )
+		  .arg( entry.stats.getAcmr(), 0, 'f', 3 )
+		  .arg( entry.stats.getLruAcmr(), 0, 'f', 3 )
+		  .arg( entry.stats.getAtvr(), 0, 'f', 2 )
+		  .arg( entry.stats.getOptimizedAcmr(), 0, 'f', 3 )
+		  .arg( entry.stats.getGain() * 100.0, 0, 'f', 0 );
+	}
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeMorphAudit( DzNode *node ) {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+  // Audit every figure in the scene, or the figure the selection belongs to
+	QList<DzNode*> figures;
+	if(m_auditAllFigures) {
+		figures = DzMorphAudit::getSceneFigures();
+	} else if(node) {
+		DzNode *figure = node->getSkeleton();
+		figures.append(figure ? figure : node);
+	}
+
+	QString	html;
+	html += QString( "<b>Morph Audit : %1</b><br>" )
+	  .arg( m_auditAllFigures ? "All Figures" : "Selected Figure" );
+	if(figures.isEmpty()) {
+		html += "No Figure<br><br>";
+		appendOutput( html );
+		return;
+	}
+
+	QList<DzMorphAuditFigure> results = DzMorphAudit::auditFigures( figures );
+
+	int totalMorphs = 0;
+	qint64 totalBytes = 0, unusedBytes = 0;
+	html += "<table>";
+	for(int i = 0; i < results.count(); i++) {
+		const DzMorphAuditFigure &figure = results[i];
+		totalMorphs += figure.morphs.count();
+		totalBytes += figure.totalBytes;
+		unusedBytes += figure.unusedBytes;
+
+		html += QString( "<tr><td><b>%1</b> : </td><td>Morphs : %2</td><td>Deltas : %3</td>"
+		  "<td>%4 MB</td></tr>" )
+		  .arg( figure.label )
+		  .arg( figure.morphs.count() )
+		  .arg( figure.totalDeltas )
+		  .arg( formatMB( figure.totalBytes ) );
+		html += QString( "<tr><td></td><td>Empty : %1</td><td>Undialed : %2</td>"
+		  "<td>Reclaimable : %3 MB</td></tr>" )
+		  .arg( figure.numEmpty )
+		  .arg( figure.numUndialed )
+		  .arg( formatMB( figure.unusedBytes ) );
+
+	  // Only list the individual morphs when looking at a single figure
+		if(m_auditAllFigures) {
+			continue;
+		}
+		for(int j = 0; j < figure.morphs.count(); j++) {
+			const DzMorphAuditEntry &entry = figure.morphs[j];
+			html += QString( "<tr><td>&nbsp;&nbsp;&nbsp;&nbsp;%1 : </td><td>%2</td>"
+			  "<td>Deltas : %3</td><td>%4 MB %5</td></tr>" )
+			  .arg( entry.name )
+			  .arg( entry.owner )
+			  .arg( entry.numDeltas )
+			  .arg( formatMB( entry.bytes ) )
+			  .arg( entry.isEmpty() ? "Empty" : ( entry.dialed ? "" : "Undialed" ) );
+		}
+	}
+	html += "</table><br>";
+
+	html += "<table>";
+	html += QString( "<tr><td>Total Morphs : </td><td>%1</td></tr>" ).arg( totalMorphs );
+	html += QString( "<tr><td>Total Delta Memory : </td><td>%1 MB</td></tr>" )
+	  .arg( formatMB( totalBytes ) );
+	html += QString( "<tr><td>Reclaimable (Empty or Undialed) : </td><td>%1 MB</td></tr>" )
+	  .arg( formatMB( unusedBytes ) );
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeMeshHygiene( DzNode *node ) {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+	float tolerance = DzMeshHygiene::getDefaultTolerance();
+	QList<DzMeshHygieneStats> results = m_hygiene.analyzeScene( tolerance );
+
+  // Sum the scene, and pick out the primary selection
+	DzMeshHygieneStats total;
+	const DzMeshHygieneStats *selected = NULL;
+	qint64 totalSavings = 0;
+	for(int i = 0; i < results.count(); i++) {
+		const DzMeshHygieneStats &stats = results[i];
+		total.numVerts += stats.numVerts;
+		total.numFacets += stats.numFacets;
+		total.numDuplicateVerts += stats.numDuplicateVerts;
+		total.numOrphanVerts += stats.numOrphanVerts;
+		total.numDegenerateFacets += stats.numDegenerateFacets;
+		total.numDuplicateFacets += stats.numDuplicateFacets;
+		totalSavings += stats.getSavingsBytes();
+		if(stats.node == node) {
+			selected = &stats;
+		}
+	}
+
+	QString	html;
+	html += QString( "<b>Mesh Hygiene : </b>Tolerance %1, %2 meshes scanned<br><table>" )
+	  .arg( tolerance )
+	  .arg( m_hygiene.getNumAnalyzed() );
+	if(selected) {
+		html += QString( "<tr><td>%1 : </td><td>Duplicate Vertices : %2</td>"
+		  "<td>Orphan Vertices : %3</td></tr>" )
+		  .arg( selected->label )
+		  .arg( selected->numDuplicateVerts )
+		  .arg( selected->numOrphanVerts );
+		html += QString( "<tr><td></td><td>Degenerate Facets : %1</td>"
+		  "<td>Duplicate Facets : %2</td><td>Savings : %3 MB</td></tr>" )
+		  .arg( selected->numDegenerateFacets )
+		  .arg( selected->numDuplicateFacets )
+		  .arg( formatMB( selected->getSavingsBytes() ) );
+	}
+	html += QString( "<tr><td>Scene : </td><td>Duplicate Vertices : %1</td>"
+	  "<td>Orphan Vertices : %2</td></tr>" )
+	  .arg( total.numDuplicateVerts )
+	  .arg( total.numOrphanVerts );
+	html += QString( "<tr><td></td><td>Degenerate Facets : %1</td>"
+	  "<td>Duplicate Facets : %2</td><td>Savings : %3 MB</td></tr>" )
+	  .arg( total.numDegenerateFacets )
+	  .arg( total.numDuplicateFacets )
+	  .arg( formatMB( totalSavings ) );
+	html += "</table><br>";
+
+  // List the nodes with the most to gain
+	qSort(results.begin(), results.end(), compareHygieneSavings);
+	html += "<table>";
+	for(int i = 0; i < results.count() && i < c_maxHygieneRows; i++) {
+		const DzMeshHygieneStats &stats = results[i];
+		if(!stats.hasProblems()) {
+			break;
+		}
+		html += QString( "<tr><td>%1 : </td><td>Dup V %2</td><td>Orphan V %3</td>"
+		  "<td>Degen F %4</td><td>Dup F %5</td><td>%6 MB</td></tr>" )
+		  .arg( stats.label )
+		  .arg( stats.numDuplicateVerts )
+		  .arg( stats.numOrphanVerts )
+		  .arg( stats.numDegenerateFacets )
+		  .arg( stats.numDuplicateFacets )
+		  .arg( formatMB( stats.getSavingsBytes() ) );
+	}
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeSkinning( DzNode *node ) {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+  // The figure the selection belongs to
+	DzSkeleton *figure = qobject_cast<DzSkeleton*>( node );
+	DzBone *bone = qobject_cast<DzBone*>( node );
+	if( figure == NULL && bone ) {
+		figure = bone->getSkeleton();
+	}
+
+	QString	html;
+	const DzSkinStats *stats = m_skinning.analyze( figure );
+	if( stats == NULL ) {
+		html += "<b>Skinning : </b>No skinned figure selected<br><br>";
+		appendOutput( html );
+		return;
+	}
+
+	html += QString( "<b>Skinning : </b>%1<br><table>" ).arg( figure->getLabel() );
+	html += QString( "<tr><td>Vertices : </td><td>%1</td></tr>" ).arg( stats->numVerts );
+	html += QString( "<tr><td>Bound Bones : </td><td>%1</td></tr>" ).arg( stats->numBindings );
+	html += QString( "<tr><td>Weight Map Values : </td><td>%1</td><td>%2 MB</td></tr>" )
+	  .arg( stats->numWeights )
+	  .arg( formatMB( stats->weightBytes ) );
+	html += QString( "<tr><td>Non-Zero Weights : </td><td>%1</td></tr>" ).arg( stats->numEntries );
+	html += QString( "<tr><td>Influences Per Vertex : </td><td>Mean %1</td><td>Max %2</td></tr>" )
+	  .arg( stats->getMeanInfluences(), 0, 'f', 2 )
+	  .arg( stats->maxInfluences );
+	html += QString( "<tr><td>Weights Below %1 : </td><td>%2</td><td>%3 vertices</td></tr>" )
+	  .arg( DzSkinAnalysis::getPruneWeight() )
+	  .arg( stats->numNegligible )
+	  .arg( stats->numPrunableVerts );
+	html += QString( "<tr><td>Unweighted Bones : </td><td>%1</td></tr>" )
+	  .arg( stats->unweightedBones.count() );
+	html += "</table><br>";
+
+  // Vertices by the number of bones that move them
+	html += "<b>Influences : </b><br><table>";
+	for(int i = 0; i < stats->influences.count(); i++) {
+		if(stats->influences[i] == 0) {
+			continue;
+		}
+		html += QString( "<tr><td>%1%2 : </td><td>%3</td></tr>" )
+		  .arg( i )
+		  .arg( i == DzSkinAnalysis::getMaxBucket() ? "+" : "" )
+		  .arg( stats->influences[i] );
+	}
+	html += "</table><br>";
+
+	if(!stats->unweightedBones.isEmpty()) {
+		html += QString( "<b>Unweighted Bones : </b>%1<br><br>" )
+		  .arg( stats->unweightedBones.join( ", " ) );
+	}
+
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeMemoryTelemetry() {
+	const DzMemorySample *sample = m_telemetry.getLatest();
+	if(!sample) {
+		return;
+	}
+
+	QString	html;
+	html += "<b>Memory Telemetry : </b><br><table>";
+	html += QString( "<tr><td>Resident : </td><td>%1 MB</td></tr>" )
+	  .arg( formatMB( sample->rssBytes ) );
+	html += QString( "<tr><td>Peak : </td><td>%1 MB</td></tr>" )
+	  .arg( formatMB( sample->peakBytes ) );
+	html += QString( "<tr><td>Estimated Geometry : </td><td>%1 MB</td></tr>" )
+	  .arg( formatMB( sample->estimatedBytes ) );
+	html += QString( "<tr><td>Unexplained : </td><td>%1 MB</td></tr>" )
+	  .arg( formatMB( sample->getUnexplainedBytes() ) );
+	html += QString( "<tr><td>Samples : </td><td>%1</td></tr>" )
+	  .arg( m_telemetry.getNumSamples() );
+	html += QString( "<tr><td>History : </td><td>%1</td></tr>" )
+	  .arg( m_telemetry.getSparkline() );
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
+/**
+ **/
+void DzSceneInfoPaneEx::writeOverhead() {
+	int numDeferred = m_signals.getNumDeferred();
+	qint64 deferredNsecs = m_signals.getDeferredNsecs();
+
+	QString	html;
+	html += "<b>Pane Overhead : </b><br><table>";
+	html += QString( "<tr><td>Construction : </td><td>%1 ms</td></tr>" )
+	  .arg( m_constructNsecs / 1.0e6, 0, 'f', 3 );
+	html += QString( "<tr><td>Refreshes : </td><td>%1</td><td>Total %2 ms</td><td>Last %3 ms</td></tr>" )
+	  .arg( m_numRefreshes )
+	  .arg( m_refreshNsecs / 1.0e6, 0, 'f', 3 )
+	  .arg( m_lastRefreshNsecs / 1.0e6, 0, 'f', 3 );
+	html += QString( "<tr><td>Deferred While Hidden : </td><td>%1</td><td>Total %2 ms</td><td>Each %3 us</td></tr>" )
+	  .arg( numDeferred )
+	  .arg( deferredNsecs / 1.0e6, 0, 'f', 3 )
+	  .arg( numDeferred ? deferredNsecs / 1.0e3 / numDeferred : 0.0, 0, 'f', 3 );
+	if( m_statsServer->isRunning() ) {
+		html += QString( "<tr><td>Stats Server : </td><td>%1</td><td>Clients %2</td></tr>" )
+		  .arg( m_statsServer->getName() )
+		  .arg( m_statsServer->getNumClients() );
+	}
+	html += QString( "<tr><td>Stats Cache : </td><td>%1 records, %2 MB</td><td>Hits %3</td><td>Misses %4</td></tr>" )
+	  .arg( m_statsCache.getNumRecords() )
+	  .arg( formatMB( m_statsCache.getFileSize() ) )
+	  .arg( m_statsCache.getNumHits() )
+	  .arg( m_statsCache.getNumMisses() );
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
+/**
+	Sort mesh hygiene results by decreasing savings
+**/
+static bool compareHygieneSavings( const DzMeshHygieneStats &stats1, const DzMeshHygieneStats &stats2 ) {
+	return stats1.getSavingsBytes() > stats2.getSavingsBytes();
+}
+
+/**
+	Format the geometry covered by a material for a material row
+**/
+static QString formatFacetCounts( const DzMaterialHistogram *histogram, int materialIdx ) {
+	if( histogram == NULL || materialIdx < 0 || materialIdx >= histogram->getNumMaterials() ) {
+		return QString();
+	}
+	const DzMaterialFacetCounts &counts = histogram->getCounts( materialIdx );
+	return QString( "Facets : %1 (Tris %2, Quads %3) Verts : %4" )
+	  .arg( counts.numFacets )
+	  .arg( counts.numTris )
+	  .arg( counts.numQuads )
+	  .arg( counts.numVerts );
+}
+
+/**
+	Format a byte count as megabytes with two decimals
+**/
+static QString formatMB( qint64 bytes ) {
+	return QString::number( bytes / ( 1024.0 * 1024.0 ), 'f', 2 );
+}
+
+/**
+	A row of the scene geometry table, with the render-visible count in a
+	second column if showVisible is set
+**/
+static QString formatTotalRow( const QString &label, qint64 total, qint64 visible, bool showVisible ) {
+	if( !showVisible ) {
+		return QString( "<tr><td>%1 : </td><td>%2</td></tr>" )
+		  .arg( label )
+		  .arg( total );
+	}
+	return QString( "<tr><td>%1 : </td><td>%2</td><td>%3</td></tr>" )
+	  .arg( label )
+	  .arg( total )
+	  .arg( visible );
+}
+
+/**
+	The status as a colored badge
+**/
+static QString formatBudgetBadge( DzSceneBudget::Status status ) {
+	const char *color = "gray";
+	switch( status ) {
+	case DzSceneBudget::Pass:	color = "green"; break;
+	case DzSceneBudget::Warn:	color = "orange"; break;
+	case DzSceneBudget::Fail:	color = "red"; break;
+	default:					break;
+	}
+	return QString( "<b><font color=\"%1\">[%2]</font></b>" )
+	  .arg( color )
+	  .arg( DzSceneBudget::getStatusName( status ) );
 }
 
 bool compareMaterials(const QObject *obj1, const QObject *obj2) {
@@ -650,6 +2168,59 @@ bool compareMaterials(const QObject *obj1, const QObject *obj2) {
 	return material1->getName() < material2->getName();
 }
 
+/**
+ **/
+void DzSceneInfoPaneEx::writeSignals() {
+	DzSignalRecorder::Report report = m_signals.analyze( c_maxSignalBursts );
+
+	QString	html;
+	html += QString( "<b>Scene Signals : </b>%1 recorded, %2 overwritten<br><table>" )
+	  .arg( report.numRecords )
+	  .arg( report.numOverwritten );
+	html += QString( "<tr><td>Rate : </td><td>%1 per second</td><td>Peak %2 in one second</td></tr>" )
+	  .arg( report.perSecond, 0, 'f', 2 )
+	  .arg( report.peakPerSecond );
+	html += "</table><br>";
+
+  // Handler time by signal type
+	html += "<table>";
+	html += "<tr><td></td><td>Count</td><td>Total ms</td><td>Mean ms</td><td>Max ms</td></tr>";
+	for(int i = 0; i < DzSignalRecorder::NumTypes; i++) {
+		const DzSignalRecorder::TypeStats &type = report.types[i];
+		if(type.count == 0) {
+			continue;
+		}
+		html += QString( "<tr><td>%1 : </td><td>%2</td><td>%3</td><td>%4</td><td>%5</td></tr>" )
+		  .arg( DzSignalRecorder::getTypeName( i ) )
+		  .arg( type.count )
+		  .arg( type.totalNsecs / 1.0e6, 0, 'f', 3 )
+		  .arg( type.totalNsecs / 1.0e6 / type.count, 0, 'f', 3 )
+		  .arg( type.maxNsecs / 1.0e6, 0, 'f', 3 );
+	}
+	html += "</table><br>";
+
+  // The largest runs of signals with no long gap
+	html += "<b>Worst Bursts : </b><br><table>";
+	for(int i = 0; i < report.bursts.count(); i++) {
+		const DzSignalRecorder::Burst &burst = report.bursts[i];
+		QStringList types;
+		for(int j = 0; j < DzSignalRecorder::NumTypes; j++) {
+			if(burst.counts[j]) {
+				types.append( QString( "%1 %2" ).arg( DzSignalRecorder::getTypeName( j ) ).arg( burst.counts[j] ) );
+			}
+		}
+		html += QString( "<tr><td>%1 s : </td><td>%2 signals in %3 ms</td><td>Handled in %4 ms</td><td>%5</td></tr>" )
+		  .arg( burst.start / 1.0e9, 0, 'f', 1 )
+		  .arg( burst.count )
+		  .arg( ( burst.end - burst.start ) / 1.0e6, 0, 'f', 1 )
+		  .arg( burst.handlerNsecs / 1.0e6, 0, 'f', 1 )
+		  .arg( types.join( ", " ) );
+	}
+	html += "</table><br>";
+
+	appendOutput( html );
+}
+
 /**
  **/
 void DzSceneInfoPaneEx::writeSelectedPropertyInfo( DzNode *node )
@@ -693,6 +2264,70 @@ void DzSceneInfoPaneEx::writeSelectedPropertyInfo( DzNode *node )
 	}
 	html += "</table><br>";
 
-	m_output->append( html );
+	appendOutput( html );
+
+}
+
+/**
+	The properties of the snapshot's node that changed since it was taken
+**/
+void DzSceneInfoPaneEx::writePropertyDiff() {
+	if( m_refreshBlocked ) {
+	  // Ignore signals during scene load
+		return;
+	}
+
+	DzNode *node = m_propSnapshot.getNode();
+	if( !node ) {
+		appendOutput( "<b>Property Diff : </b>No snapshot; use Take Property Snapshot<br>" );
+		return;
+	}
+
+	m_propCurrent.capture( node );
+	QElapsedTimer timer;
+	timer.start();
+	DzPropertyDiff diff = DzPropertySnapshot::diff( m_propSnapshot, m_propCurrent, c_maxPropertyChanges );
+	qint64 nsecs = timer.nsecsElapsed();
+
+	QString	html;
+	html += QString( "<b>Property Diff : </b>%1<br><table>" ).arg( node->getLabel() );
+	html += QString( "<tr><td>Changes : </td><td>%1 changed</td><td>%2 added</td><td>%3 removed</td></tr>" )
+	  .arg( diff.numChanged )
+	  .arg( diff.numAdded )
+	  .arg( diff.numRemoved );
+	html += QString( "<tr><td>Groups : </td><td>%1</td><td>%2 unchanged</td><td></td></tr>" )
+	  .arg( diff.numGroups )
+	  .arg( diff.numGroupsSkipped );
+	html += QString( "<tr><td>Properties : </td><td>%1</td><td>%2 KB</td><td></td></tr>" )
+	  .arg( m_propCurrent.getNumProperties() )
+	  .arg( m_propCurrent.getBytes() / 1024.0, 0, 'f', 1 );
+	html += QString( "<tr><td>Time : </td><td>%1 ms capture</td><td>%2 ms diff</td><td></td></tr>" )
+	  .arg( m_propCurrent.getCaptureNsecs() / 1000000.0, 0, 'f', 2 )
+	  .arg( nsecs / 1000000.0, 0, 'f', 3 );
+	html += "</table><br>";
+
+	if( diff.changes.isEmpty() ) {
+		appendOutput( html );
+		return;
+	}
+
+	html += "<table>";
+	html += "<tr><td>Group</td><td>Property</td><td>Before</td><td>After</td><td>Keys</td></tr>";
+	for( int i = 0; i < diff.changes.count(); i++ ) {
+		const DzPropertyChange &change = diff.changes[i];
+		html += QString( "<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td></tr>" )
+		  .arg( change.group )
+		  .arg( change.name )
+		  .arg( change.kind == DzPropertyChange::Added ? QString( "-" ) : change.oldValue )
+		  .arg( change.kind == DzPropertyChange::Removed ? QString( "-" ) : change.newValue )
+		  .arg( change.oldKeys == change.newKeys ? QString::number( change.newKeys )
+		    : QString( "%1 -> %2" ).arg( change.oldKeys ).arg( change.newKeys ) );
+	}
+	if( diff.getNumChanges() > diff.changes.count() ) {
+		html += QString( "<tr><td>...</td><td>%1 more</td></tr>" )
+		  .arg( diff.getNumChanges() - diff.changes.count() );
+	}
+	html += "</table><br>";
 
+	appendOutput( html );
 }
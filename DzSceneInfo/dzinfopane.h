@@ -21,14 +21,40 @@
 /*****************************
    Include files
 *****************************/
+#include <QtCore/QStringList>
+
 #include "dzpane.h"
 #include "dzaction.h"
 
+#include "dzassetgraph.h"
+#include "dzboundscache.h"
+#include "dzdecimationadvisor.h"
+#include "dzgeometryprofiler.h"
+#include "dzlightinfluence.h"
+#include "dzmaterialhistogram.h"
+#include "dzmemorytelemetry.h"
+#include "dzmeshhygiene.h"
+#include "dznodeindex.h"
+#include "dzpropertysnapshot.h"
+#include "dzscenebudget.h"
+#include "dzscenetree.h"
+#include "dzselectionstats.h"
+#include "dzsignalrecorder.h"
+#include "dzskinanalysis.h"
+#include "dzstatscache.h"
+#include "dzvertexcache.h"
+
 /****************************
    Forward declarations
 ****************************/
+class QHideEvent;
+class QLineEdit;
+class QShowEvent;
 class QTextBrowser;
+class QTimer;
+class DzMaterialDedup;
 class DzNode;
+class DzStatsServer;
 
 /*****************************
    Class definitions
@@ -63,40 +89,157 @@ public slots:
 
 	virtual void	refresh();
 
+protected:
+
+	/////////////////////////////
+	// from QWidget
+
+	virtual void	showEvent( QShowEvent *event );
+	virtual void	hideEvent( QHideEvent *event );
+
 private slots:
 
 	// slots for refreshing/redrawing our data
 	void			refreshInfo( DzNode *node );
 
+	// slots for the scene signals; each is recorded before it is handled
+	void			nodeListChanged();
+	void			primarySelectionChanged( DzNode *node );
+	void			selectionListChanged();
+	void			visibilityChanged();
+	void			nodeAdded( DzNode *node );
+	void			nodeRemoved( DzNode *node );
+
 	// slots for blocking/unblocking our refresh functions during file load operations
 	void			blockRefresh();
 	void			unblockRefresh();
+	void			unblockAfterLoad();
+	void			unblockAfterClear();
+
+	// slot for the periodic memory sample
+	void			sampleMemory();
+
+	// slot for redrawing after the camera moved
+	void			cameraMoved();
+
+	// slot for redrawing after the node filter was edited
+	void			filterChanged();
 
 	void			showContextMenu(const QPoint &);
 
 private:
+	// Sections of the output that can be redrawn on their own
+	enum Section {
+		NodesSection,
+		DecimationSection,
+		NumSections
+	};
+
+	// The appends to the output that a section made; begin is -1 if the
+	// section was not written
+	struct OutputRange {
+		int		begin;
+		int		end;
+	};
+
 	//
 	// DATA MEMBERS
 	//
 
 	bool			m_refreshBlocked;
+	bool			m_dirty;			// The scene changed while the pane was hidden
 	QTextBrowser	*m_output;
+	QLineEdit		*m_filterEdit;		// Node filter, shown with the nodes
+	QStringList		m_outputHtml;		// Each append to the output since it was cleared
+	OutputRange		m_sections[NumSections];
 	int				m_totalVerts, m_totalTris, m_totalQuads;
 
 	bool			m_showScene;
+	bool			m_showRenderVisible;	// Scene totals next to render-visible totals
+	bool			m_showBudgets;
 	bool			m_showNodes;
 	bool			m_showSelected;
+	bool			m_showSelectionTotals;
 	bool			m_showSelectedObject;
 	bool			m_showSelectedProperties;
+	bool			m_showPropertyDiff;
 	bool			m_showMaterials;
+	bool			m_showMorphAudit;
+	bool			m_auditAllFigures;
+	bool			m_showMeshHygiene;
+	bool			m_showSkinning;
+	bool			m_showHierarchy;
+	bool			m_showMaterialDedup;
+	bool			m_showAssetGraph;
+	bool			m_showDecimation;
+	bool			m_showLightInfluence;
+	bool			m_showGeomProfile;
+	bool			m_showVertexCache;
+	bool			m_showMemory;
+	bool			m_showOverhead;
+	bool			m_showSignals;
+
+	// Cost of the pane, to verify that it is near zero while hidden
+	qint64			m_constructNsecs;
+	int				m_numRefreshes;
+	qint64			m_refreshNsecs;
+	qint64			m_lastRefreshNsecs;
+
+	DzStatsCache				m_statsCache;	// Declared first, the caches below use it
+	DzMaterialHistogramCache	m_histograms;
+	DzSceneTree					m_tree;
+	DzSelectionStats			m_selection;
+	DzNodeIndex					m_nodeIndex;
+	DzSceneBudget				m_budgets;
+	DzPropertySnapshot			m_propSnapshot;		// Taken from the menu
+	DzPropertySnapshot			m_propCurrent;		// Reused by each diff
+	DzAssetGraph				m_assets;
+	DzBoundsCache				m_bounds;			// Shared by the camera and light analyses
+	DzDecimationAdvisor			m_decimation;
+	DzLightInfluence			m_lightInfluence;
+	DzGeometryProfiler			m_geomProfiler;
+	DzVertexCacheAnalysis		m_vertexCache;
+	DzMeshHygieneCache			m_hygiene;
+	DzSkinAnalysis				m_skinning;
+	DzSignalRecorder			m_signals;
+	DzMemoryTelemetry			m_telemetry;
+	DzMemorySample::Reason		m_sampleReason;
+	QTimer						*m_memoryTimer;
+	QTimer						*m_cameraTimer;		// Coalesces camera moves
+	QTimer						*m_filterTimer;		// Coalesces filter keystrokes
+	DzMaterialDedup				*m_materialDedup;
+	DzStatsServer				*m_statsServer;
+
+	void			clearOutput();
+	void			appendOutput( const QString &html );
+	void			beginSection( Section section );
+	void			endSection( Section section );
+	void			redrawSection( Section section, void (DzSceneInfoPaneEx::*write)() );
 
 	void			writeSceneInfo();
+	void			writeBudgets();
 	void			writeNodes();
 	void			writeSelectedNode( DzNode *node );
+	void			writeSelectionTotals();
 	void			writeSelectedObjectInfo( DzNode *node );
 	void			writeSelectedPropertyInfo( DzNode *node );
+	void			writePropertyDiff();
 	void			writeMaterialInfo();
-	void			getNodeInfo( const DzNode *node, int &numVerts, int &numTris, int &numQuads );
+	void			writeMaterialDedup();
+	void			writeAssetGraph();
+	void			writeDecimation();
+	void			writeLightInfluence();
+	void			writeGeometryProfile();
+	void			writeVertexCache();
+	void			writeMorphAudit( DzNode *node );
+	void			writeMeshHygiene( DzNode *node );
+	void			writeSkinning( DzNode *node );
+	void			writeHierarchy();
+	void			writeMemoryTelemetry();
+	void			writeOverhead();
+	void			writeSignals();
+	bool			deferWhileHidden();
+	void			watchVisibility();
 };
 
 #endif // DAZ_INFO_PANE_H
@@ -0,0 +1,379 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzlightinfluence.h"
+
+#include <math.h>
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QtConcurrentMap>
+#include <QtCore/QVector>
+
+#include "dzboundscache.h"
+#include "dzfloatproperty.h"
+#include "dzlight.h"
+#include "dzquat.h"
+#include "dzscene.h"
+#include "dzscenetree.h"
+
+// Scene units are centimeters
+static const double c_unitsPerMeter = 100.0;
+static const double c_pi = 3.14159265358979323846;
+// Nodes spanning more cells than this are tested against every light
+static const int c_maxCellsPerNode = 512;
+// Cell coordinates are packed into 21 bits each
+static const int c_cellBias = 1 << 20;
+
+/**
+	A render-visible node, as seen by the worker threads
+**/
+struct DzInfluenceTarget {
+	DzVec3	center;
+	float	radius;
+};
+
+/**
+	The targets binned by the cells their bounding boxes overlap
+**/
+struct DzInfluenceGrid {
+	float							cellSize;
+	QHash<quint64, QVector<int> >	cells;
+	QVector<int>					large;
+};
+
+/**
+	One light's influence volume and the targets found inside it
+**/
+struct DzInfluenceJob {
+	DzVec3								pos;
+	DzVec3								axis;		// Spot lights shine down their local -Z axis
+	float								range;
+	bool								spot;
+	float								cosHalf;
+	float								sinHalf;
+	const QVector<DzInfluenceTarget>	*targets;
+	const DzInfluenceGrid				*grid;
+	QVector<int>						hits;
+	qint64								numTests;
+};
+
+/**
+ **/
+static int getCell( float value, float cellSize ) {
+	double cell = floor( value / cellSize );
+	return (int)qBound( (double)( 1 - c_cellBias ), cell, (double)( c_cellBias - 1 ) );
+}
+
+/**
+ **/
+static quint64 getCellKey( int x, int y, int z ) {
+	return ( (quint64)( x + c_cellBias ) << 42 ) |
+		( (quint64)( y + c_cellBias ) << 21 ) |
+		(quint64)( z + c_cellBias );
+}
+
+/**
+ **/
+static void getCellCoords( quint64 key, int &x, int &y, int &z ) {
+	const quint64 mask = ( Q_UINT64_C( 1 ) << 21 ) - 1;
+	x = (int)( ( key >> 42 ) & mask ) - c_cellBias;
+	y = (int)( ( key >> 21 ) & mask ) - c_cellBias;
+	z = (int)( key & mask ) - c_cellBias;
+}
+
+/**
+	Whether the sphere reaches into the light's range and, for a spot light,
+	its cone. The cone test moves the apex back so that the cone is widened
+	by the sphere's radius, then rejects spheres behind the real apex that do
+	not contain it.
+**/
+static bool isInfluenced( const DzInfluenceJob &job, const DzInfluenceTarget &target ) {
+	DzVec3 offset = target.center - job.pos;
+	float reach = job.range + target.radius;
+	float distSqr = offset.dot( offset );
+	if( distSqr > reach * reach ) {
+		return false;
+	}
+	if( !job.spot ) {
+		return true;
+	}
+
+	DzVec3 apex = job.pos - job.axis * ( target.radius / job.sinHalf );
+	DzVec3 widened = target.center - apex;
+	float along = job.axis.dot( widened );
+	if( along <= 0 || along * along < widened.dot( widened ) * job.cosHalf * job.cosHalf ) {
+		return false;
+	}
+	along = -job.axis.dot( offset );
+	if( along > 0 && along * along >= distSqr * job.sinHalf * job.sinHalf ) {
+		return distSqr <= target.radius * target.radius;
+	}
+	return true;
+}
+
+/**
+	The pair is only tested in the cell holding the low corner of the overlap
+	of the light's box and the target's box
+**/
+static void testCell( DzInfluenceJob &job, const QVector<int> &cell, int x, int y, int z ) {
+	const float size = job.grid->cellSize;
+	for( int i = 0; i < cell.count(); i++ ) {
+		const DzInfluenceTarget &target = job.targets->at( cell[i] );
+		if( getCell( qMax( job.pos.m_x - job.range, target.center.m_x - target.radius ), size ) != x ||
+			getCell( qMax( job.pos.m_y - job.range, target.center.m_y - target.radius ), size ) != y ||
+			getCell( qMax( job.pos.m_z - job.range, target.center.m_z - target.radius ), size ) != z ) {
+			continue;
+		}
+		job.numTests++;
+		if( isInfluenced( job, target ) ) {
+			job.hits.append( cell[i] );
+		}
+	}
+}
+
+/**
+	Runs on a worker thread. Walks the cells the light's box overlaps, or the
+	occupied cells if there are fewer of them.
+**/
+static void findTargets( DzInfluenceJob &job ) {
+	const DzInfluenceGrid &grid = *job.grid;
+	for( int i = 0; i < grid.large.count(); i++ ) {
+		job.numTests++;
+		if( isInfluenced( job, job.targets->at( grid.large[i] ) ) ) {
+			job.hits.append( grid.large[i] );
+		}
+	}
+
+	int minX = getCell( job.pos.m_x - job.range, grid.cellSize );
+	int minY = getCell( job.pos.m_y - job.range, grid.cellSize );
+	int minZ = getCell( job.pos.m_z - job.range, grid.cellSize );
+	int maxX = getCell( job.pos.m_x + job.range, grid.cellSize );
+	int maxY = getCell( job.pos.m_y + job.range, grid.cellSize );
+	int maxZ = getCell( job.pos.m_z + job.range, grid.cellSize );
+	double span = ( maxX - minX + 1.0 ) * ( maxY - minY + 1.0 ) * ( maxZ - minZ + 1.0 );
+
+	if( span > grid.cells.count() ) {
+		int x, y, z;
+		QHash<quint64, QVector<int> >::const_iterator it;
+		for( it = grid.cells.constBegin(); it != grid.cells.constEnd(); ++it ) {
+			getCellCoords( it.key(), x, y, z );
+			if( x >= minX && x <= maxX && y >= minY && y <= maxY && z >= minZ && z <= maxZ ) {
+				testCell( job, it.value(), x, y, z );
+			}
+		}
+		return;
+	}
+
+	for( int x = minX; x <= maxX; x++ ) {
+		for( int y = minY; y <= maxY; y++ ) {
+			for( int z = minZ; z <= maxZ; z++ ) {
+				QHash<quint64, QVector<int> >::const_iterator it = grid.cells.constFind( getCellKey( x, y, z ) );
+				if( it != grid.cells.constEnd() ) {
+					testCell( job, it.value(), x, y, z );
+				}
+			}
+		}
+	}
+}
+
+/**
+ **/
+static float getFloatProperty( DzLight *light, const QString &name, float defaultValue ) {
+	DzFloatProperty *prop = qobject_cast<DzFloatProperty*>( light->findProperty( name ) );
+	return prop ? prop->getValue() : defaultValue;
+}
+
+/**
+ **/
+static bool compareLightFacets( const DzLightInfluence::LightEntry &entry1, const DzLightInfluence::LightEntry &entry2 ) {
+	return entry1.numFacets > entry2.numFacets;
+}
+
+/**
+ **/
+static bool compareNodeLights( const DzLightInfluence::NodeEntry &entry1, const DzLightInfluence::NodeEntry &entry2 ) {
+	if( entry1.numLights != entry2.numLights ) {
+		return entry1.numLights > entry2.numLights;
+	}
+	return entry1.numFacets > entry2.numFacets;
+}
+
+/**
+	tree should have been synced with the scene
+**/
+DzLightInfluence::Report DzLightInfluence::analyze( const DzSceneTree &tree ) {
+	Report report;
+	if( m_bounds == NULL ) {
+		return report;
+	}
+
+  // The render-visible nodes with facets
+	QVector<DzInfluenceTarget> targets;
+	QVector<NodeEntry> nodes;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		const DzSceneTree::Item *item = tree.getItem( node );
+		if( item == NULL || !item->visible ) {
+			continue;
+		}
+		qint64 numFacets = item->own.numTris + item->own.numQuads + item->own.numTessPrims;
+		if( numFacets == 0 ) {
+			continue;
+		}
+
+		const DzBoundsCache::Sphere &sphere = m_bounds->getSphere( node, report.numBounded );
+		DzInfluenceTarget target;
+		target.center = sphere.center;
+		target.radius = sphere.radius;
+		targets.append( target );
+
+		NodeEntry entry;
+		entry.node = node;
+		entry.numFacets = numFacets;
+		nodes.append( entry );
+	}
+	report.numNodes = targets.count();
+
+  // The lights that are on, and the volume of each one
+	QList<DzInfluenceJob> jobs;
+	QList<int> jobLights;			// Index in report.lights of each job
+	QList<float> ranges;
+	DzLightListIterator lightIter( dzScene->lightListIterator() );
+	DzLight *light = NULL;
+	while( lightIter.hasNext() ) {
+		light = lightIter.next();
+		if( !light->isVisible() ) {
+			continue;
+		}
+
+		LightEntry entry;
+		entry.light = light;
+		bool spot = light->inherits( "DzSpotLight" );
+		if( spot ) {
+			entry.kind = "Spot";
+		} else if( light->inherits( "DzPointLight" ) ) {
+			entry.kind = "Point";
+		} else if( light->isAreaLight() ) {
+			entry.kind = "Area";
+		} else if( light->isDirectional() ) {
+			entry.kind = "Distant";
+		} else {
+			entry.kind = "Point";
+		}
+		report.lights.append( entry );
+
+		if( entry.kind == "Distant" ) {
+			continue;
+		}
+
+		float intensity = getFloatProperty( light, "Intensity", 1.0f );
+		float spread = getFloatProperty( light, "Spread Angle", 180.0f );
+
+		DzInfluenceJob job;
+		job.pos = light->getWSPos();
+		job.axis = light->getWSRot().multVec( DzVec3( 0, 0, -1 ) );
+		job.range = intensity > 0 ? c_unitsPerMeter * sqrt( intensity / getCutoff() ) : 0;
+		job.spot = spot && spread > 0 && spread < 180;
+		job.cosHalf = (float)cos( spread * 0.5 * c_pi / 180.0 );
+		job.sinHalf = (float)sin( spread * 0.5 * c_pi / 180.0 );
+		job.numTests = 0;
+		report.lights.last().range = job.range;
+		if( job.range > 0 ) {
+			jobs.append( job );
+			jobLights.append( report.lights.count() - 1 );
+			ranges.append( job.range );
+		}
+	}
+	report.numLights = report.lights.count();
+
+  // Cells half the median range keep a light's box to a few cells across
+	DzInfluenceGrid grid;
+	grid.cellSize = 1.0f;
+	if( !ranges.isEmpty() ) {
+		qSort( ranges );
+		grid.cellSize = qMax( ranges[ranges.count() / 2] * 0.5f, 1.0f );
+	}
+	if( !jobs.isEmpty() ) {
+		for( int i = 0; i < targets.count(); i++ ) {
+			const DzInfluenceTarget &target = targets[i];
+			int minX = getCell( target.center.m_x - target.radius, grid.cellSize );
+			int minY = getCell( target.center.m_y - target.radius, grid.cellSize );
+			int minZ = getCell( target.center.m_z - target.radius, grid.cellSize );
+			int maxX = getCell( target.center.m_x + target.radius, grid.cellSize );
+			int maxY = getCell( target.center.m_y + target.radius, grid.cellSize );
+			int maxZ = getCell( target.center.m_z + target.radius, grid.cellSize );
+			double span = ( maxX - minX + 1.0 ) * ( maxY - minY + 1.0 ) * ( maxZ - minZ + 1.0 );
+			if( span > c_maxCellsPerNode ) {
+				grid.large.append( i );
+				continue;
+			}
+			for( int x = minX; x <= maxX; x++ ) {
+				for( int y = minY; y <= maxY; y++ ) {
+					for( int z = minZ; z <= maxZ; z++ ) {
+						grid.cells[getCellKey( x, y, z )].append( i );
+					}
+				}
+			}
+		}
+	}
+	report.numCells = grid.cells.count();
+	report.numLarge = grid.large.count();
+
+	for( int i = 0; i < jobs.count(); i++ ) {
+		jobs[i].targets = &targets;
+		jobs[i].grid = &grid;
+	}
+	QtConcurrent::blockingMap( jobs, findTargets );
+
+  // Gather the counts per light and per node
+	for( int i = 0; i < jobs.count(); i++ ) {
+		LightEntry &entry = report.lights[jobLights[i]];
+		const QVector<int> &hits = jobs[i].hits;
+		for( int j = 0; j < hits.count(); j++ ) {
+			entry.numFacets += nodes[hits[j]].numFacets;
+			nodes[hits[j]].numLights++;
+		}
+		entry.numNodes = hits.count();
+		report.numPairs += hits.count();
+		report.numTests += jobs[i].numTests;
+	}
+	for( int i = 0; i < report.lights.count(); i++ ) {
+		LightEntry &entry = report.lights[i];
+		if( entry.kind != "Distant" ) {
+			continue;
+		}
+		for( int j = 0; j < nodes.count(); j++ ) {
+			entry.numFacets += nodes[j].numFacets;
+			nodes[j].numLights++;
+		}
+		entry.numNodes = nodes.count();
+		report.numPairs += nodes.count();
+	}
+
+	for( int i = 0; i < nodes.count(); i++ ) {
+		if( nodes[i].numLights > 0 ) {
+			report.nodes.append( nodes[i] );
+		}
+	}
+	qSort( report.lights.begin(), report.lights.end(), compareLightFacets );
+	qSort( report.nodes.begin(), report.nodes.end(), compareNodeLights );
+	return report;
+}
@@ -0,0 +1,100 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_LIGHT_INFLUENCE_H
+#define DAZ_LIGHT_INFLUENCE_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+/****************************
+   Forward declarations
+****************************/
+class DzBoundsCache;
+class DzLight;
+class DzNode;
+class DzSceneTree;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Which render-visible nodes each light reaches.
+
+	The lights have no hard range, so a light's influence volume is the sphere
+	within which its inverse-square falloff stays above getCutoff() of its
+	intensity at one meter; a spot light is further limited to its cone, and a
+	distant light reaches every node.
+
+	The node bounds are spheres from a DzBoundsCache, shared with the
+	decimation advisor, and are binned into a uniform grid
+	sized from the light ranges, so each light only tests the nodes in the
+	cells its volume overlaps. A pair found in several cells is only counted
+	in the cell holding the low corner of the two boxes' overlap. Nodes too
+	large for the grid are tested against every light directly. The lights
+	are processed in parallel; the DAZ objects are only read on the GUI thread.
+**/
+class DzLightInfluence {
+public:
+	struct LightEntry {
+		DzLight	*light;
+		QString	kind;
+		double	range;			// 0 for distant lights
+		int		numNodes;
+		qint64	numFacets;
+
+		LightEntry() : light( NULL ), range( 0 ), numNodes( 0 ), numFacets( 0 ) {}
+	};
+
+	struct NodeEntry {
+		DzNode	*node;
+		int		numLights;
+		qint64	numFacets;
+
+		NodeEntry() : node( NULL ), numLights( 0 ), numFacets( 0 ) {}
+	};
+
+	struct Report {
+		int					numLights;		// Lights that are on
+		int					numNodes;		// Render-visible nodes with facets
+		int					numBounded;		// Nodes whose bounds were not cached
+		int					numCells;
+		int					numLarge;		// Nodes tested against every light
+		qint64				numPairs;		// Light and node pairs in range
+		qint64				numTests;		// Sphere tests made
+		QList<LightEntry>	lights;			// Most facets first
+		QList<NodeEntry>	nodes;			// Most lights first; lit nodes only
+
+		Report() : numLights( 0 ), numNodes( 0 ), numBounded( 0 ), numCells( 0 ),
+			numLarge( 0 ), numPairs( 0 ), numTests( 0 ) {}
+	};
+
+	DzLightInfluence() : m_bounds( NULL ) {}
+
+	Report	analyze( const DzSceneTree &tree );
+	void	setBoundsCache( DzBoundsCache *bounds ) { m_bounds = bounds; }
+
+	static double	getCutoff() { return 1.0 / 256.0; }
+
+private:
+	DzBoundsCache	*m_bounds;
+};
+
+#endif // DAZ_LIGHT_INFLUENCE_H
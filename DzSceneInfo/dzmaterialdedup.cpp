@@ -0,0 +1,260 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzmaterialdedup.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QMap>
+#include <QtCore/QSet>
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QVector>
+#include <QtCore/QtConcurrentMap>
+
+#include "dzboolproperty.h"
+#include "dzcolorproperty.h"
+#include "dzfloatproperty.h"
+#include "dzimageproperty.h"
+#include "dzintproperty.h"
+#include "dzmaterial.h"
+#include "dzstringproperty.h"
+#include "dztexture.h"
+
+static const quint64 c_fnvOffset = Q_UINT64_C( 0xcbf29ce484222325 );
+static const quint64 c_fnvPrime = Q_UINT64_C( 0x100000001b3 );
+
+/**
+	Write a texture reference to the signature. Returns 1 if there is a
+	texture not already bound elsewhere on the material; the common channels
+	are usually also exposed as mapped properties, and are counted once.
+**/
+static int writeTexture( QDataStream &stream, DzTexture *texture, QSet<DzTexture*> &bound ) {
+	QString fileName = texture ? texture->getFilename() : QString();
+	stream << fileName;
+	if( fileName.isEmpty() || bound.contains( texture ) ) {
+		return 0;
+	}
+	bound.insert( texture );
+	return 1;
+}
+
+/**
+	Sort groups by decreasing size
+**/
+static bool compareGroupSize( const DzMaterialDedup::Group &group1, const DzMaterialDedup::Group &group2 ) {
+	return group1.materials.count() > group2.materials.count();
+}
+
+/**
+ **/
+DzMaterialDedup::DzMaterialDedup( QObject *parent ) :
+	QObject( parent )
+{
+}
+
+/**
+ **/
+void DzMaterialDedup::clear() {
+	QHash<QObject*, QObject*>::iterator it;
+	for( it = m_owners.begin(); it != m_owners.end(); ++it ) {
+		disconnect( it.key(), 0, this, 0 );
+	}
+	QHash<QObject*, Entry>::iterator mt;
+	for( mt = m_entries.begin(); mt != m_entries.end(); ++mt ) {
+		disconnect( mt.key(), 0, this, 0 );
+	}
+	m_owners.clear();
+	m_entries.clear();
+}
+
+/**
+	Invalidate the signature of the material that owns the changed property
+**/
+void DzMaterialDedup::propertyChanged() {
+	QObject *material = m_owners.value( sender() );
+	QHash<QObject*, Entry>::iterator it = m_entries.find( material );
+	if( it != m_entries.end() ) {
+		it->valid = false;
+	}
+}
+
+/**
+ **/
+void DzMaterialDedup::materialDestroyed( QObject *obj ) {
+	m_entries.remove( obj );
+
+	QHash<QObject*, QObject*>::iterator it = m_owners.begin();
+	while( it != m_owners.end() ) {
+		if( it.value() == obj ) {
+			it = m_owners.erase( it );
+		} else {
+			++it;
+		}
+	}
+}
+
+/**
+	Listen for changes to any of the material's properties, including a map
+	being set or cleared on a numeric property
+**/
+void DzMaterialDedup::watchMaterial( DzMaterial *material ) {
+	connect( material, SIGNAL(destroyed(QObject*)), this, SLOT(materialDestroyed(QObject*)) );
+
+	DzPropertyListIterator propIter( material->propertyListIterator() );
+	DzProperty *prop = NULL;
+	while( propIter.hasNext() ) {
+		prop = propIter.next();
+		m_owners.insert( prop, material );
+		connect( prop, SIGNAL(currentValueChanged()), this, SLOT(propertyChanged()) );
+		if( qobject_cast<DzNumericProperty*>( prop ) ) {
+			connect( prop, SIGNAL(mapChanged()), this, SLOT(propertyChanged()) );
+		}
+	}
+}
+
+/**
+	Build the canonical signature of a material : the common channels first,
+	then every property value sorted by property name. The material name is
+	deliberately left out. Reading property values can evaluate controllers,
+	so this runs on the GUI thread.
+**/
+void DzMaterialDedup::serialize( DzMaterial *material, Entry &entry ) {
+	entry.signature.clear();
+	entry.numTextures = 0;
+
+	QSet<DzTexture*> bound;
+	QDataStream stream( &entry.signature, QIODevice::WriteOnly );
+	stream << QString( material->className() );
+	stream << material->getDiffuseColor();
+	entry.numTextures += writeTexture( stream, material->getColorMap(), bound );
+	entry.numTextures += writeTexture( stream, material->getOpacityMap(), bound );
+	entry.numTextures += writeTexture( stream, material->getBakedMap(), bound );
+
+	QMap<QString, DzProperty*> props;
+	DzPropertyListIterator propIter( material->propertyListIterator() );
+	DzProperty *prop = NULL;
+	while( propIter.hasNext() ) {
+		prop = propIter.next();
+		props.insert( prop->getName(), prop );
+	}
+
+	QMap<QString, DzProperty*>::const_iterator it;
+	for( it = props.constBegin(); it != props.constEnd(); ++it ) {
+		prop = it.value();
+		stream << it.key();
+		if( DzFloatProperty *fprop = qobject_cast<DzFloatProperty*>( prop ) ) {
+			stream << fprop->getValue();
+		} else if( DzColorProperty *cprop = qobject_cast<DzColorProperty*>( prop ) ) {
+			stream << cprop->getColorValue();
+		} else if( DzIntProperty *iprop = qobject_cast<DzIntProperty*>( prop ) ) {
+			stream << iprop->getValue();
+		} else if( DzBoolProperty *bprop = qobject_cast<DzBoolProperty*>( prop ) ) {
+			stream << bprop->getBoolValue();
+		} else if( DzImageProperty *mprop = qobject_cast<DzImageProperty*>( prop ) ) {
+			entry.numTextures += writeTexture( stream, mprop->getValue(), bound );
+		} else if( DzStringProperty *sprop = qobject_cast<DzStringProperty*>( prop ) ) {
+			stream << sprop->getValue();
+		}
+
+	  // Numeric channels can also be mapped
+		if( DzNumericProperty *nprop = qobject_cast<DzNumericProperty*>( prop ) ) {
+			entry.numTextures += writeTexture( stream, nprop->getMapValue(), bound );
+		}
+	}
+}
+
+/**
+	64-bit FNV-1a hash of the signature; runs on a worker thread
+**/
+void DzMaterialDedup::hashEntry( Entry *&entry ) {
+	quint64 hash = c_fnvOffset;
+	const uchar *data = (const uchar*)entry->signature.constData();
+	for( int i = 0, n = entry->signature.size(); i < n; i++ ) {
+		hash = ( hash ^ data[i] ) * c_fnvPrime;
+	}
+	entry->hash = hash;
+	entry->valid = true;
+}
+
+/**
+ **/
+DzMaterialDedup::Report DzMaterialDedup::analyze() {
+	Report report;
+	QVector<Entry*> stale;
+	QList<DzMaterial*> materials;
+
+  // Rebuild the signatures of new and changed materials only
+	int i, n = DzMaterial::getNumMaterials();
+	for( i = 0; i < n; i++ ) {
+		DzMaterial *material = DzMaterial::getMaterial( i );
+		if( material == NULL ) {
+			continue;
+		}
+		materials.append( material );
+
+		QHash<QObject*, Entry>::iterator it = m_entries.find( material );
+		if( it == m_entries.end() ) {
+			it = m_entries.insert( material, Entry() );
+			watchMaterial( material );
+		}
+		if( !it->valid ) {
+			serialize( material, *it );
+			stale.append( &(*it) );
+		}
+	}
+	report.numRehashed = stale.count();
+	QtConcurrent::blockingMap( stale, hashEntry );
+
+  // Group by hash, then by exact signature in case of a collision
+	QHash<quint64, QList<Group> > buckets;
+	for( i = 0; i < materials.count(); i++ ) {
+		const Entry &entry = m_entries[materials[i]];
+		report.numTextureBindings += entry.numTextures;
+
+		QList<Group> &bucket = buckets[entry.hash];
+		int j;
+		for( j = 0; j < bucket.count(); j++ ) {
+			if( m_entries[bucket[j].materials.first()].signature == entry.signature ) {
+				break;
+			}
+		}
+		if( j == bucket.count() ) {
+			Group group;
+			group.numTextures = entry.numTextures;
+			bucket.append( group );
+		}
+		bucket[j].materials.append( materials[i] );
+	}
+
+	QHash<quint64, QList<Group> >::const_iterator it;
+	for( it = buckets.constBegin(); it != buckets.constEnd(); ++it ) {
+		for( i = 0; i < it.value().count(); i++ ) {
+			const Group &group = it.value()[i];
+			report.numUnique++;
+			if( group.materials.count() > 1 ) {
+				report.numRedundant += group.materials.count() - 1;
+				report.numRedundantBindings += ( group.materials.count() - 1 ) * group.numTextures;
+				report.groups.append( group );
+			}
+		}
+	}
+	qSort( report.groups.begin(), report.groups.end(), compareGroupSize );
+	report.numMaterials = materials.count();
+	return report;
+}
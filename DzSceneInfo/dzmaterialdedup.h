@@ -0,0 +1,102 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_MATERIAL_DEDUP_H
+#define DAZ_MATERIAL_DEDUP_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+
+/****************************
+   Forward declarations
+****************************/
+class DzMaterial;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Finds materials with identical settings under different names.
+
+	Each material is reduced to a canonical signature of its parameter values
+	and texture references, which is then hashed. Signatures are cached per
+	material and only rebuilt after one of the material's property values or
+	maps changes; the hashing is done in parallel. A texture bound to several
+	channels of one material counts as one binding.
+**/
+class DzMaterialDedup : public QObject {
+	Q_OBJECT
+public:
+	/**
+		Materials that share the same settings
+	**/
+	struct Group {
+		QList<DzMaterial*>	materials;
+		int					numTextures;	// Texture bindings of one member
+	};
+
+	/**
+		The consolidation opportunity for the whole material set
+	**/
+	struct Report {
+		int				numMaterials;
+		int				numUnique;
+		int				numRedundant;			// Materials that could be removed; each has its own shader
+		int				numTextureBindings;
+		int				numRedundantBindings;	// Texture bindings that could be removed
+		int				numRehashed;			// Materials whose signature was rebuilt
+		QList<Group>	groups;					// Groups with more than one member
+
+		Report() : numMaterials( 0 ), numUnique( 0 ), numRedundant( 0 ),
+			numTextureBindings( 0 ), numRedundantBindings( 0 ), numRehashed( 0 ) {}
+	};
+
+	DzMaterialDedup( QObject *parent = NULL );
+
+	Report	analyze();
+	void	clear();
+
+private slots:
+
+	void	propertyChanged();
+	void	materialDestroyed( QObject *obj );
+
+private:
+	struct Entry {
+		QByteArray	signature;
+		quint64		hash;
+		int			numTextures;
+		bool		valid;
+
+		Entry() : hash( 0 ), numTextures( 0 ), valid( false ) {}
+	};
+
+	void	watchMaterial( DzMaterial *material );
+	void	serialize( DzMaterial *material, Entry &entry );
+
+	static void	hashEntry( Entry *&entry );
+
+	QHash<QObject*, Entry>			m_entries;	// Keyed by material
+	QHash<QObject*, QObject*>		m_owners;	// Property to material
+};
+
+#endif // DAZ_MATERIAL_DEDUP_H
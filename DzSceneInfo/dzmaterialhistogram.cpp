@@ -0,0 +1,276 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzmaterialhistogram.h"
+
+#include "dzfacetmesh.h"
+#include "dznode.h"
+#include "dzobject.h"
+#include "dzshape.h"
+#include "dzstatscache.h"
+
+// Number of materials whose vertex coverage is tracked per pass
+static const int c_maskBits = 64;
+
+// Change signals, probed since not every shape and geometry class has them
+static const char *const c_shapeSignals[] = {
+	"materialListChanged()", "materialSelectionChanged()", "facetGroupListChanged()"
+};
+static const char *const c_geomSignals[] = {
+	"facetListChanged()", "facetsChanged()", "materialGroupListChanged()",
+	"topologyChanged()", "vertexListChanged()"
+};
+
+/**
+	Connect each of the signals the object has to the slot
+**/
+static void connectSignals( QObject *obj, const char *const *signatures, int count,
+	QObject *receiver, const char *slot ) {
+	const QMetaObject *meta = obj->metaObject();
+	for( int i = 0; i < count; i++ ) {
+		if( meta->indexOfSignal( signatures[i] ) >= 0 ) {
+			QObject::connect( obj, ( QByteArray( "2" ) + signatures[i] ).constData(), receiver, slot, Qt::UniqueConnection );
+		}
+	}
+}
+
+/**
+	Index of the lowest set bit of a non-zero mask (de Bruijn multiply)
+**/
+static inline int lowestBit( quint64 bits ) {
+	static const int c_table[64] = {
+		 0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+		62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+		63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+		46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+	};
+	return c_table[( ( bits & ( 0 - bits ) ) * Q_UINT64_C( 0x03F79D71B4CB0A89 ) ) >> 58];
+}
+
+/**
+ **/
+void DzMaterialHistogram::compute( DzFacetMesh *mesh, int numMaterials ) {
+	int		i, v, base;
+	int		nFacets = mesh->getNumFacets();
+	int		nVerts = mesh->getNumVertices();
+	DzFacet	*facets = mesh->getFacetsPtr();
+
+	m_counts.fill( DzMaterialFacetCounts(), numMaterials );
+
+	QVector<quint64> masks( nVerts );
+	quint64 *mask = masks.data();
+
+	for( base = 0; ; base += c_maskBits ) {
+		if( base > 0 ) {
+			masks.fill( 0 );
+		}
+
+		for( i = 0; i < nFacets; i++ ) {
+			const DzFacet &facet = facets[i];
+			int m = facet.m_materialIdx;
+			if( m < 0 ) {
+				continue;
+			}
+
+		  // The facet counts are only gathered on the first pass
+			bool quad = facet.isQuad();
+			if( base == 0 ) {
+				if( m >= m_counts.count() ) {
+					m_counts.resize( m + 1 );
+				}
+				DzMaterialFacetCounts &counts = m_counts[m];
+				counts.numFacets++;
+				if( quad )
+				  counts.numQuads++;
+				else
+				  counts.numTris++;
+			}
+
+			m -= base;
+			if( m < 0 || m >= c_maskBits ) {
+				continue;
+			}
+			quint64 bit = Q_UINT64_C( 1 ) << m;
+			mask[facet.m_vertIdx[0]] |= bit;
+			mask[facet.m_vertIdx[1]] |= bit;
+			mask[facet.m_vertIdx[2]] |= bit;
+			if( quad ) {
+				mask[facet.m_vertIdx[3]] |= bit;
+			}
+		}
+
+	  // Each set bit is one vertex covered by that material
+		DzMaterialFacetCounts *counts = m_counts.data() + base;
+		for( v = 0; v < nVerts; v++ ) {
+			quint64 bits = mask[v];
+			while( bits ) {
+				counts[lowestBit( bits )].numVerts++;
+				bits &= bits - 1;
+			}
+		}
+
+		if( base + c_maskBits >= m_counts.count() ) {
+			break;
+		}
+	}
+}
+
+/**
+ **/
+DzMaterialHistogramCache::DzMaterialHistogramCache( QObject *parent ) : QObject( parent ),
+	m_cache( NULL ) {
+}
+
+/**
+ **/
+void DzMaterialHistogramCache::invalidate( const DzShape *shape ) {
+	m_entries.remove( shape );
+}
+
+/**
+	Drop the entries of every shape of the node's object
+**/
+void DzMaterialHistogramCache::nodeRemoved( DzNode *node ) {
+	DzObject *obj = node ? node->getObject() : NULL;
+	if( obj == NULL ) {
+		return;
+	}
+	for( int i = 0, n = obj->getNumShapes(); i < n; i++ ) {
+		invalidate( obj->getShape( i ) );
+	}
+}
+
+/**
+ **/
+void DzMaterialHistogramCache::clear() {
+	m_entries.clear();
+	m_geomShapes.clear();
+}
+
+/**
+ **/
+void DzMaterialHistogramCache::shapeChanged() {
+	invalidate( (const DzShape*)sender() );
+}
+
+/**
+ **/
+void DzMaterialHistogramCache::geometryChanged() {
+	QHash<const QObject*, const DzShape*>::iterator it = m_geomShapes.find( sender() );
+	if( it != m_geomShapes.end() ) {
+		invalidate( it.value() );
+	}
+}
+
+/**
+	The object is a shape or a geometry being destroyed, so it can no longer
+	be cast; only its address is used
+**/
+void DzMaterialHistogramCache::shapeDestroyed( QObject *obj ) {
+	m_entries.remove( (const DzShape*)obj );
+	m_geomShapes.remove( obj );
+	QHash<const QObject*, const DzShape*>::iterator it = m_geomShapes.begin();
+	while( it != m_geomShapes.end() ) {
+		if( it.value() == (const DzShape*)obj ) {
+			it = m_geomShapes.erase( it );
+		} else {
+			++it;
+		}
+	}
+}
+
+/**
+	Listen for the shape and its geometry changing or going away
+**/
+void DzMaterialHistogramCache::watchShape( DzShape *shape, DzGeometry *geom ) {
+	connect( shape, SIGNAL(destroyed(QObject*)), this, SLOT(shapeDestroyed(QObject*)), Qt::UniqueConnection );
+	connect( geom, SIGNAL(destroyed(QObject*)), this, SLOT(shapeDestroyed(QObject*)), Qt::UniqueConnection );
+	connectSignals( shape, c_shapeSignals, sizeof(c_shapeSignals) / sizeof(c_shapeSignals[0]),
+		this, SLOT(shapeChanged()) );
+	connectSignals( geom, c_geomSignals, sizeof(c_geomSignals) / sizeof(c_geomSignals[0]),
+		this, SLOT(geometryChanged()) );
+	m_geomShapes.insert( geom, shape );
+}
+
+/**
+ **/
+const DzMaterialHistogram* DzMaterialHistogramCache::getHistogram( DzShape *shape ) {
+	DzGeometry	*geom = shape ? shape->getGeometry() : NULL;
+	DzFacetMesh	*mesh = qobject_cast<DzFacetMesh*>( geom );
+	if( mesh == NULL ) {
+		m_entries.remove( shape );
+		return NULL;
+	}
+
+  // Reuse the cached histogram if the geometry has not changed
+	int numMaterials = shape->getNumMaterials();
+	QHash<const DzShape*, Entry>::iterator it = m_entries.find( shape );
+	if( it != m_entries.end() &&
+		it->geom == geom &&
+		it->facets == mesh->getFacetsPtr() &&
+		it->numVerts == mesh->getNumVertices() &&
+		it->numFacets == mesh->getNumFacets() &&
+		it->numMaterials == numMaterials ) {
+		return &it->histogram;
+	}
+
+	Entry &entry = m_entries[shape];
+	entry.geom = geom;
+	entry.facets = mesh->getFacetsPtr();
+	entry.numVerts = mesh->getNumVertices();
+	entry.numFacets = mesh->getNumFacets();
+	entry.numMaterials = numMaterials;
+	watchShape( shape, geom );
+	computeHistogram( shape, mesh, entry );
+	return &entry.histogram;
+}
+
+/**
+	Compute the histogram for the entry, or read it from the stats cache when
+	the shape is the current shape of a node from an unchanged asset
+**/
+void DzMaterialHistogramCache::computeHistogram( DzShape *shape, DzFacetMesh *mesh, Entry &entry ) {
+	DzNode		*node = m_cache ? shape->getNode() : NULL;
+	DzObject	*obj = node ? node->getObject() : NULL;
+	if( obj == NULL || obj->getCurrentShape() != shape ) {
+		entry.histogram.compute( mesh, entry.numMaterials );
+		return;
+	}
+
+	DzStatsCache::Entry stored;
+	bool found = m_cache->find( node, stored ) &&
+		stored.matches( entry.numVerts, entry.numFacets, entry.numMaterials );
+	if( found && stored.hasHistogram ) {
+		entry.histogram.setAllCounts( stored.histogram );
+		return;
+	}
+
+	entry.histogram.compute( mesh, entry.numMaterials );
+	if( !found ) {
+		stored = DzStatsCache::Entry();
+		DzSceneTree::getNodeInfo( node, stored.stats );
+		stored.geomVerts = entry.numVerts;
+		stored.geomFacets = entry.numFacets;
+		stored.geomMaterials = entry.numMaterials;
+	}
+	stored.hasHistogram = true;
+	stored.histogram = entry.histogram.getAllCounts();
+	m_cache->insert( node, stored );
+}
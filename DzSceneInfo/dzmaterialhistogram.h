@@ -0,0 +1,123 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_MATERIAL_HISTOGRAM_H
+#define DAZ_MATERIAL_HISTOGRAM_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+/****************************
+   Forward declarations
+****************************/
+class DzFacetMesh;
+class DzGeometry;
+class DzNode;
+class DzShape;
+class DzStatsCache;
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	The geometry covered by a single material index of a mesh
+**/
+struct DzMaterialFacetCounts {
+	int		numFacets;
+	int		numTris;
+	int		numQuads;
+	int		numVerts;		// Distinct vertices referenced by the material's facets
+
+	DzMaterialFacetCounts() : numFacets( 0 ), numTris( 0 ), numQuads( 0 ), numVerts( 0 ) {}
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Per-material facet histogram of a facet mesh, indexed by the facet
+	material index. Counts are gathered in a single pass over the facet
+	array; vertex coverage is tracked with a per-vertex material bit mask,
+	so meshes with more than 64 materials take one extra pass per 64.
+**/
+class DzMaterialHistogram {
+public:
+	DzMaterialHistogram() {}
+
+	void	compute( DzFacetMesh *mesh, int numMaterials );
+
+	int								getNumMaterials() const { return m_counts.count(); }
+	const DzMaterialFacetCounts&	getCounts( int materialIdx ) const { return m_counts[materialIdx]; }
+
+	const QVector<DzMaterialFacetCounts>&	getAllCounts() const { return m_counts; }
+	void	setAllCounts( const QVector<DzMaterialFacetCounts> &counts ) { m_counts = counts; }
+
+private:
+	QVector<DzMaterialFacetCounts>	m_counts;
+};
+
+/**
+	Caches a histogram per shape. An entry is recomputed whenever the shape's
+	geometry is replaced or its vertex or facet arrays change, and dropped
+	when the shape or its geometry signals a change to its materials or
+	facets, when the shape is destroyed, or when its node is removed.
+
+	If a DzStatsCache is set, the histogram of a node's current shape is also
+	stored with the node's asset, and read back instead of being computed when
+	the same asset is loaded again.
+**/
+class DzMaterialHistogramCache : public QObject {
+	Q_OBJECT
+public:
+	DzMaterialHistogramCache( QObject *parent = NULL );
+
+	const DzMaterialHistogram*	getHistogram( DzShape *shape );
+	void	setStatsCache( DzStatsCache *cache ) { m_cache = cache; }
+
+	void	invalidate( const DzShape *shape );
+	void	nodeRemoved( DzNode *node );
+	void	clear();
+
+private slots:
+
+	void	shapeChanged();
+	void	geometryChanged();
+	void	shapeDestroyed( QObject *obj );
+
+private:
+	struct Entry {
+		const DzGeometry	*geom;
+		const void			*facets;
+		int					numVerts;
+		int					numFacets;
+		int					numMaterials;
+		DzMaterialHistogram	histogram;
+	};
+
+	void	computeHistogram( DzShape *shape, DzFacetMesh *mesh, Entry &entry );
+	void	watchShape( DzShape *shape, DzGeometry *geom );
+
+	QHash<const DzShape*, Entry>			m_entries;
+	QHash<const QObject*, const DzShape*>	m_geomShapes;	// Watched geometry to its shape
+	DzStatsCache							*m_cache;
+};
+
+#endif // DAZ_MATERIAL_HISTOGRAM_H
@@ -0,0 +1,170 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzmemorytelemetry.h"
+
+#include <QtCore/QFile>
+
+#if defined( Q_OS_WIN )
+#include <windows.h>
+#include <psapi.h>
+#elif defined( Q_OS_MAC )
+#include <mach/mach.h>
+#include <sys/resource.h>
+#endif
+
+// Unicode block elements used to draw the sparkline, lowest to highest
+static const ushort c_sparkBase = 0x2581;
+static const int c_sparkLevels = 8;
+
+/*****************************
+DzProcessMemory
+*****************************/
+
+/**
+	Returns false if the memory usage could not be read on this platform
+**/
+bool DzProcessMemory::read( qint64 &rssBytes, qint64 &peakBytes ) {
+	rssBytes = 0;
+	peakBytes = 0;
+
+#if defined( Q_OS_WIN )
+	PROCESS_MEMORY_COUNTERS counters;
+	if( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof(counters) ) ) {
+		return false;
+	}
+	rssBytes = counters.WorkingSetSize;
+	peakBytes = counters.PeakWorkingSetSize;
+	return true;
+#elif defined( Q_OS_MAC )
+	mach_task_basic_info_data_t info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if( task_info( mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count ) != KERN_SUCCESS ) {
+		return false;
+	}
+	rssBytes = info.resident_size;
+	peakBytes = info.resident_size_max;
+	return true;
+#else
+  // The values in /proc/self/status are in kB
+	QFile file( "/proc/self/status" );
+	if( !file.open( QIODevice::ReadOnly ) ) {
+		return false;
+	}
+
+	bool found = false;
+	QList<QByteArray> lines = file.readAll().split( '\n' );
+	for( int i = 0; i < lines.count(); i++ ) {
+		const QByteArray &line = lines[i];
+		qint64 *value = NULL;
+		if( line.startsWith( "VmRSS:" ) ) {
+			value = &rssBytes;
+		} else if( line.startsWith( "VmHWM:" ) ) {
+			value = &peakBytes;
+		}
+		if( value ) {
+			*value = line.mid( 6 ).trimmed().split( ' ' ).first().toLongLong() * 1024;
+			found = true;
+		}
+	}
+	return found;
+#endif
+}
+
+/*****************************
+DzMemoryTelemetry
+*****************************/
+
+/**
+ **/
+DzMemoryTelemetry::DzMemoryTelemetry( int capacity ) :
+	m_samples( capacity ),
+	m_next( 0 ),
+	m_count( 0 )
+{
+	m_clock.start();
+}
+
+/**
+ **/
+void DzMemoryTelemetry::clear() {
+	m_next = 0;
+	m_count = 0;
+}
+
+/**
+	Measure the process memory now and store it with the given scene totals,
+	overwriting the oldest sample once the buffer is full
+**/
+void DzMemoryTelemetry::record( DzMemorySample::Reason reason, int numVerts, int numFacets,
+	int numMaterials, qint64 estimatedBytes ) {
+	DzMemorySample &sample = m_samples[m_next];
+	DzProcessMemory::read( sample.rssBytes, sample.peakBytes );
+	sample.time = m_clock.elapsed();
+	sample.reason = reason;
+	sample.estimatedBytes = estimatedBytes;
+	sample.numVerts = numVerts;
+	sample.numFacets = numFacets;
+	sample.numMaterials = numMaterials;
+
+	m_next = ( m_next + 1 ) % m_samples.count();
+	if( m_count < m_samples.count() ) {
+		m_count++;
+	}
+}
+
+/**
+ **/
+const DzMemorySample& DzMemoryTelemetry::getSample( int which ) const {
+	int capacity = m_samples.count();
+	return m_samples[( m_next - m_count + which + capacity ) % capacity];
+}
+
+/**
+ **/
+const DzMemorySample* DzMemoryTelemetry::getLatest() const {
+	return m_count > 0 ? &getSample( m_count - 1 ) : NULL;
+}
+
+/**
+	The resident memory of the samples, oldest first, scaled between the
+	smallest and largest sample
+**/
+QString DzMemoryTelemetry::getSparkline() const {
+	QString line;
+	if( m_count == 0 ) {
+		return line;
+	}
+
+	qint64 lo = getSample( 0 ).rssBytes, hi = lo;
+	for( int i = 1; i < m_count; i++ ) {
+		lo = qMin( lo, getSample( i ).rssBytes );
+		hi = qMax( hi, getSample( i ).rssBytes );
+	}
+
+	for( int i = 0; i < m_count; i++ ) {
+		int level = 0;
+		if( hi > lo ) {
+			level = (int)( ( getSample( i ).rssBytes - lo ) * ( c_sparkLevels - 1 ) / ( hi - lo ) );
+		}
+		line += QChar( c_sparkBase + level );
+	}
+	return line;
+}
@@ -0,0 +1,90 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_MEMORY_TELEMETRY_H
+#define DAZ_MEMORY_TELEMETRY_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QString>
+#include <QtCore/QTime>
+#include <QtCore/QVector>
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	Process memory measured alongside the pane's scene totals
+**/
+struct DzMemorySample {
+	enum Reason {
+		Timer,
+		Refresh,
+		SceneLoaded,
+		SceneCleared
+	};
+
+	int		time;				// Milliseconds since the telemetry was started
+	Reason	reason;
+	qint64	rssBytes;			// Resident set size (working set on Windows)
+	qint64	peakBytes;			// Peak resident set size
+	qint64	estimatedBytes;		// Memory explained by the scene geometry
+	int		numVerts;
+	int		numFacets;
+	int		numMaterials;
+
+	qint64	getUnexplainedBytes() const { return rssBytes - estimatedBytes; }
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Reads the memory usage of the current process. Uses /proc/self/status on
+	Linux, GetProcessMemoryInfo() on Windows and the Mach task info on Mac OS X.
+**/
+class DzProcessMemory {
+public:
+	static bool		read( qint64 &rssBytes, qint64 &peakBytes );
+};
+
+/**
+	Keeps the most recent memory samples in a fixed size ring buffer
+**/
+class DzMemoryTelemetry {
+public:
+	DzMemoryTelemetry( int capacity = 120 );
+
+	void	record( DzMemorySample::Reason reason, int numVerts, int numFacets,
+				int numMaterials, qint64 estimatedBytes );
+	void	clear();
+
+	int						getNumSamples() const { return m_count; }
+	const DzMemorySample&	getSample( int which ) const;	// 0 is the oldest
+	const DzMemorySample*	getLatest() const;
+
+	QString		getSparkline() const;
+
+private:
+	QVector<DzMemorySample>	m_samples;
+	int						m_next;
+	int						m_count;
+	QTime					m_clock;
+};
+
+#endif // DAZ_MEMORY_TELEMETRY_H
@@ -0,0 +1,604 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzmeshhygiene.h"
+
+#include <math.h>
+
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QtConcurrentMap>
+
+#include "dzfacetmesh.h"
+#include "dzobject.h"
+#include "dzscene.h"
+#include "dzshape.h"
+
+static const float c_defaultTolerance = 1.0e-3f;
+static const int c_cellScale = 8;				// Grid cell size, in multiples of the tolerance
+static const int c_largeMesh = 200000;			// Meshes with more verts or facets are split into chunks
+static const int c_chunkSize = 65536;
+static const float c_zeroAreaSq = 1.0e-14f;		// Squared cross product length of a zero-area facet
+static const float c_maxCellCoord = 1.0e9f;
+static const quint64 c_emptyCell = ~Q_UINT64_C( 0 );
+
+// Estimated memory of a vertex (position and normal)
+static const int c_vertexBytes = 2 * sizeof(DzPnt3);
+
+/*****************************
+Local definitions
+*****************************/
+
+/**
+	A vertex and the grid cell it falls in; sorted by cell, then by vertex index
+**/
+struct CellEntry {
+	quint64	key;
+	int		index;
+};
+
+static inline bool operator<( const CellEntry &a, const CellEntry &b ) {
+	return a.key < b.key || ( a.key == b.key && a.index < b.index );
+}
+
+/**
+	The vertices of a facet in ascending order; tris have -1 in the last slot
+**/
+struct FacetKey {
+	int		v[4];
+};
+
+static inline bool operator<( const FacetKey &a, const FacetKey &b ) {
+	for( int i = 0; i < 4; i++ ) {
+		if( a.v[i] != b.v[i] ) {
+			return a.v[i] < b.v[i];
+		}
+	}
+	return false;
+}
+
+static inline bool operator==( const FacetKey &a, const FacetKey &b ) {
+	return a.v[0] == b.v[0] && a.v[1] == b.v[1] && a.v[2] == b.v[2] && a.v[3] == b.v[3];
+}
+
+/**
+	A run of sorted cell entries that share the same cell
+**/
+struct CellRun {
+	quint64	key;
+	int		start;
+	int		count;
+};
+
+/**
+	Open addressing hash table from a cell key to its run of cell entries
+**/
+class CellTable {
+public:
+	void	build( const CellEntry *entries, int numEntries );
+	const CellRun*	find( quint64 key ) const;
+
+private:
+	static inline quint64	hash( quint64 key ) { return key * Q_UINT64_C( 0x9E3779B97F4A7C15 ); }
+
+	QVector<CellRun>	m_slots;
+	quint64				m_mask;
+};
+
+/**
+	The data shared by all the chunks of one mesh
+**/
+struct MeshContext {
+	const DzPnt3	*verts;
+	const DzFacet	*facets;
+	int				numVerts;
+	int				numFacets;
+	float			tolerance;
+	float			invCell;
+	CellEntry		*entries;
+	FacetKey		*facetKeys;
+	CellTable		table;
+};
+
+/**
+	A range of vertices or facets processed by one job
+**/
+struct Chunk {
+	MeshContext	*ctx;
+	int			begin;
+	int			end;
+	int			result;
+};
+
+/**
+	A mesh to analyze, gathered on the GUI thread
+**/
+struct MeshJob {
+	const DzFacetMesh	*mesh;
+	DzMeshHygieneStats	stats;
+	const DzPnt3		*verts;
+	const DzFacet		*facets;
+	float				tolerance;
+};
+
+/*****************************
+Local functions
+*****************************/
+
+/**
+ **/
+static inline int cellCoord( float v, float invCell ) {
+	float f = v * invCell;
+	if( !( f > -c_maxCellCoord ) ) {
+		f = -c_maxCellCoord;	// Also catches NaN
+	} else if( f > c_maxCellCoord ) {
+		f = c_maxCellCoord;
+	}
+	return (int)floorf( f );
+}
+
+/**
+	Pack three cell coordinates into a key. Coordinates wrap at 21 bits, which
+	can only put distant vertices in the same bucket, never miss a neighbor.
+**/
+static inline quint64 packCell( int x, int y, int z ) {
+	return ( (quint64)( x & 0x1FFFFF ) << 42 ) |
+		( (quint64)( y & 0x1FFFFF ) << 21 ) |
+		(quint64)( z & 0x1FFFFF );
+}
+
+/**
+ **/
+void CellTable::build( const CellEntry *entries, int numEntries ) {
+	int i, numRuns = 0;
+	for( i = 0; i < numEntries; i++ ) {
+		if( i == 0 || entries[i].key != entries[i - 1].key ) {
+			numRuns++;
+		}
+	}
+
+	int size = 16;
+	while( size < numRuns * 2 ) {
+		size <<= 1;
+	}
+	CellRun empty = { c_emptyCell, 0, 0 };
+	m_slots.fill( empty, size );
+	m_mask = size - 1;
+
+	CellRun *slots = m_slots.data();
+	for( i = 0; i < numEntries; ) {
+		CellRun run = { entries[i].key, i, 0 };
+		while( i < numEntries && entries[i].key == run.key ) {
+			run.count++;
+			i++;
+		}
+
+		quint64 slot = ( hash( run.key ) >> 32 ) & m_mask;
+		while( slots[slot].key != c_emptyCell ) {
+			slot = ( slot + 1 ) & m_mask;
+		}
+		slots[slot] = run;
+	}
+}
+
+/**
+ **/
+const CellRun* CellTable::find( quint64 key ) const {
+	const CellRun *slots = m_slots.constData();
+	quint64 slot = ( hash( key ) >> 32 ) & m_mask;
+	while( slots[slot].key != c_emptyCell ) {
+		if( slots[slot].key == key ) {
+			return &slots[slot];
+		}
+		slot = ( slot + 1 ) & m_mask;
+	}
+	return NULL;
+}
+
+/**
+	Bucket each vertex of the chunk into its grid cell
+**/
+static void computeCellKeys( Chunk &chunk ) {
+	MeshContext *ctx = chunk.ctx;
+	for( int i = chunk.begin; i < chunk.end; i++ ) {
+		const float *p = ctx->verts[i];
+		ctx->entries[i].key = packCell( cellCoord( p[0], ctx->invCell ),
+			cellCoord( p[1], ctx->invCell ), cellCoord( p[2], ctx->invCell ) );
+		ctx->entries[i].index = i;
+	}
+}
+
+/**
+	Count the vertices of the chunk that lie within tolerance of a vertex with a
+	lower index. Neighbor cells are only searched along the axes where the vertex
+	is within tolerance of the cell boundary.
+**/
+static void findDuplicateVerts( Chunk &chunk ) {
+	MeshContext *ctx = chunk.ctx;
+	float tolSq = ctx->tolerance * ctx->tolerance;
+	float tolCell = ctx->tolerance * ctx->invCell;
+	int lo[3], hi[3], c[3];
+
+	for( int i = chunk.begin; i < chunk.end; i++ ) {
+		const float *p = ctx->verts[i];
+		for( int a = 0; a < 3; a++ ) {
+			c[a] = cellCoord( p[a], ctx->invCell );
+			float frac = p[a] * ctx->invCell - (float)c[a];
+			lo[a] = frac < tolCell ? -1 : 0;
+			hi[a] = frac > 1.0f - tolCell ? 1 : 0;
+		}
+
+		bool found = false;
+		for( int dx = lo[0]; dx <= hi[0] && !found; dx++ ) {
+			for( int dy = lo[1]; dy <= hi[1] && !found; dy++ ) {
+				for( int dz = lo[2]; dz <= hi[2] && !found; dz++ ) {
+					const CellRun *run = ctx->table.find( packCell( c[0] + dx, c[1] + dy, c[2] + dz ) );
+					if( run == NULL ) {
+						continue;
+					}
+
+				  // Entries in a run are sorted by index, so stop at this vertex
+					const CellEntry *entry = ctx->entries + run->start;
+					for( int k = 0; k < run->count && entry[k].index < i; k++ ) {
+						const float *q = ctx->verts[entry[k].index];
+						float x = q[0] - p[0], y = q[1] - p[1], z = q[2] - p[2];
+						if( x * x + y * y + z * z <= tolSq ) {
+							found = true;
+							break;
+						}
+					}
+				}
+			}
+		}
+		if( found ) {
+			chunk.result++;
+		}
+	}
+}
+
+/**
+	Count the degenerate facets of the chunk, and build the sorted vertex key
+	of each valid facet for the duplicate search
+**/
+static void checkFacets( Chunk &chunk ) {
+	MeshContext *ctx = chunk.ctx;
+	for( int i = chunk.begin; i < chunk.end; i++ ) {
+		const DzFacet &facet = ctx->facets[i];
+		FacetKey &key = ctx->facetKeys[i];
+		int n = facet.isQuad() ? 4 : 3;
+		bool degenerate = false;
+
+		key.v[3] = -1;
+		for( int j = 0; j < n; j++ ) {
+			key.v[j] = facet.m_vertIdx[j];
+			if( key.v[j] < 0 || key.v[j] >= ctx->numVerts ) {
+				degenerate = true;
+			}
+		}
+		qSort( key.v, key.v + n );
+		for( int j = 1; j < n && !degenerate; j++ ) {
+			degenerate = key.v[j] == key.v[j - 1];
+		}
+
+		if( !degenerate ) {
+		  // Twice the area is the length of the cross product of the diagonals
+		  // for a quad, or of two edges for a triangle
+			const float *a = ctx->verts[facet.m_vertIdx[0]];
+			const float *b = ctx->verts[facet.m_vertIdx[1]];
+			const float *c = ctx->verts[facet.m_vertIdx[2]];
+			const float *d = n == 4 ? ctx->verts[facet.m_vertIdx[3]] : a;
+			float u[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			float v[3] = { d[0] - b[0], d[1] - b[1], d[2] - b[2] };
+			if( n == 3 ) {
+				v[0] = b[0] - a[0]; v[1] = b[1] - a[1]; v[2] = b[2] - a[2];
+			}
+			float x = u[1] * v[2] - u[2] * v[1];
+			float y = u[2] * v[0] - u[0] * v[2];
+			float z = u[0] * v[1] - u[1] * v[0];
+			degenerate = x * x + y * y + z * z < c_zeroAreaSq;
+		}
+
+		if( degenerate ) {
+		  // Degenerate facets are not also reported as duplicates
+			key.v[0] = key.v[1] = key.v[2] = key.v[3] = -1;
+			chunk.result++;
+		}
+	}
+}
+
+/**
+	Run the function over the range [0, n), split into chunks when parallel
+	is set. Returns the sum of the chunk results.
+**/
+static int runChunks( MeshContext *ctx, int n, bool parallel, void (*func)( Chunk& ) ) {
+	QVector<Chunk> chunks;
+	int step = parallel ? c_chunkSize : qMax( n, 1 );
+	for( int begin = 0; begin < n; begin += step ) {
+		Chunk chunk = { ctx, begin, qMin( n, begin + step ), 0 };
+		chunks.append( chunk );
+	}
+
+	if( chunks.count() > 1 ) {
+		QtConcurrent::blockingMap( chunks, func );
+	} else if( chunks.count() == 1 ) {
+		func( chunks[0] );
+	}
+
+	int result = 0;
+	for( int i = 0; i < chunks.count(); i++ ) {
+		result += chunks[i].result;
+	}
+	return result;
+}
+
+/**
+ **/
+static void analyzeMesh( MeshJob &job, bool parallel ) {
+	DzMeshHygieneStats &stats = job.stats;
+	MeshContext ctx;
+	ctx.verts = job.verts;
+	ctx.facets = job.facets;
+	ctx.numVerts = stats.numVerts;
+	ctx.numFacets = stats.numFacets;
+	ctx.tolerance = job.tolerance;
+	ctx.invCell = 1.0f / ( job.tolerance * c_cellScale );
+
+  // Near-duplicate vertices : bucket, sort by cell, then search the neighborhood
+	QVector<CellEntry> entries( ctx.numVerts );
+	ctx.entries = entries.data();
+	runChunks( &ctx, ctx.numVerts, parallel, computeCellKeys );
+	qSort( entries.begin(), entries.end() );
+	ctx.table.build( ctx.entries, ctx.numVerts );
+	stats.numDuplicateVerts = runChunks( &ctx, ctx.numVerts, parallel, findDuplicateVerts );
+	entries.clear();
+
+  // Degenerate facets
+	QVector<FacetKey> facetKeys( ctx.numFacets );
+	ctx.facetKeys = facetKeys.data();
+	stats.numDegenerateFacets = runChunks( &ctx, ctx.numFacets, parallel, checkFacets );
+
+  // Duplicate facets : equal keys are adjacent once sorted
+	qSort( facetKeys.begin(), facetKeys.end() );
+	stats.numDuplicateFacets = 0;
+	for( int i = 1; i < ctx.numFacets; i++ ) {
+		if( ctx.facetKeys[i].v[0] >= 0 && ctx.facetKeys[i] == ctx.facetKeys[i - 1] ) {
+			stats.numDuplicateFacets++;
+		}
+	}
+	facetKeys.clear();
+
+  // Orphan vertices
+	QVector<char> used( ctx.numVerts, 0 );
+	char *usedData = used.data();
+	for( int i = 0; i < ctx.numFacets; i++ ) {
+		const DzFacet &facet = ctx.facets[i];
+		int n = facet.isQuad() ? 4 : 3;
+		for( int j = 0; j < n; j++ ) {
+			int v = facet.m_vertIdx[j];
+			if( v >= 0 && v < ctx.numVerts ) {
+				usedData[v] = 1;
+			}
+		}
+	}
+	stats.numOrphanVerts = 0;
+	for( int i = 0; i < ctx.numVerts; i++ ) {
+		if( !usedData[i] ) {
+			stats.numOrphanVerts++;
+		}
+	}
+}
+
+/**
+ **/
+static void analyzeSmallMesh( MeshJob &job ) {
+	analyzeMesh( job, false );
+}
+
+/**
+	The facet mesh of the node's current shape, the same way getNodeInfo()
+	finds it
+**/
+static DzFacetMesh* getNodeMesh( DzNode *node ) {
+	DzObject	*obj = node ? node->getObject() : NULL;
+	DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
+	return shape ? qobject_cast<DzFacetMesh*>( shape->getGeometry() ) : NULL;
+}
+
+/**
+ **/
+static MeshJob makeJob( DzNode *node, DzFacetMesh *mesh, float tolerance ) {
+	MeshJob job;
+	job.mesh = mesh;
+	job.stats.node = node;
+	job.stats.label = node->getLabel();
+	job.stats.numVerts = mesh->getNumVertices();
+	job.stats.numFacets = mesh->getNumFacets();
+	job.verts = mesh->getVerticesPtr();
+	job.facets = mesh->getFacetsPtr();
+	job.tolerance = tolerance;
+	return job;
+}
+
+/**
+	Small meshes run one per thread; large meshes are chunked one at a time
+**/
+static void runJobs( QList<MeshJob> &jobs ) {
+	QList<MeshJob> smallJobs;
+	QList<MeshJob> largeJobs;
+	for( int i = 0; i < jobs.count(); i++ ) {
+		if( jobs[i].stats.numVerts > c_largeMesh || jobs[i].stats.numFacets > c_largeMesh ) {
+			largeJobs.append( jobs[i] );
+		} else {
+			smallJobs.append( jobs[i] );
+		}
+	}
+
+	QtConcurrent::blockingMap( smallJobs, analyzeSmallMesh );
+	for( int i = 0; i < largeJobs.count(); i++ ) {
+		analyzeMesh( largeJobs[i], true );
+	}
+	jobs = smallJobs + largeJobs;
+}
+
+/*****************************
+DzMeshHygieneStats
+*****************************/
+
+/**
+	Estimated memory that welding duplicates and deleting bad facets and
+	orphan vertices would free
+**/
+qint64 DzMeshHygieneStats::getSavingsBytes() const {
+	return (qint64)( numDuplicateVerts + numOrphanVerts ) * c_vertexBytes +
+		(qint64)( numDegenerateFacets + numDuplicateFacets ) * sizeof(DzFacet);
+}
+
+/*****************************
+DzMeshHygiene
+*****************************/
+
+/**
+ **/
+float DzMeshHygiene::getDefaultTolerance() {
+	return c_defaultTolerance;
+}
+
+/**
+ **/
+DzMeshHygieneStats DzMeshHygiene::analyzeNode( DzNode *node, float tolerance ) {
+	QList<DzNode*> nodes;
+	nodes.append( node );
+	QList<DzMeshHygieneStats> results = analyzeNodes( nodes, tolerance );
+	if( results.isEmpty() ) {
+		DzMeshHygieneStats stats;
+		stats.node = node;
+		stats.label = node ? node->getLabel() : QString();
+		return stats;
+	}
+	return results.first();
+}
+
+/**
+ **/
+QList<DzMeshHygieneStats> DzMeshHygiene::analyzeScene( float tolerance ) {
+	QList<DzNode*> nodes;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	while( nodeIter.hasNext() ) {
+		nodes.append( nodeIter.next() );
+	}
+	return analyzeNodes( nodes, tolerance );
+}
+
+/**
+ **/
+QList<DzMeshHygieneStats> DzMeshHygiene::analyzeNodes( const QList<DzNode*> &nodes, float tolerance ) {
+	if( tolerance <= 0.0f ) {
+		tolerance = c_defaultTolerance;
+	}
+
+  // Collect the facet meshes on this thread
+	QList<MeshJob> jobs;
+	for( int i = 0; i < nodes.count(); i++ ) {
+		DzFacetMesh *mesh = getNodeMesh( nodes[i] );
+		if( mesh ) {
+			jobs.append( makeJob( nodes[i], mesh, tolerance ) );
+		}
+	}
+
+	runJobs( jobs );
+
+	QList<DzMeshHygieneStats> results;
+	for( int i = 0; i < jobs.count(); i++ ) {
+		results.append( jobs[i].stats );
+	}
+	return results;
+}
+
+/*****************************
+DzMeshHygieneCache
+*****************************/
+
+/**
+	Only the meshes that are new or changed since the last call are scanned;
+	meshes no longer in the scene are dropped from the cache
+**/
+QList<DzMeshHygieneStats> DzMeshHygieneCache::analyzeScene( float tolerance ) {
+	if( tolerance <= 0.0f ) {
+		tolerance = c_defaultTolerance;
+	}
+
+  // Reuse the stats of unchanged meshes; a mesh shared by several nodes is
+  // scanned once and reported for each node
+	QList<DzMeshHygieneStats> results;
+	QList<const DzFacetMesh*> resultMeshes;
+	QList<MeshJob> jobs;
+	QHash<const DzFacetMesh*, Entry> entries;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	while( nodeIter.hasNext() ) {
+		DzNode *node = nodeIter.next();
+		DzFacetMesh *mesh = getNodeMesh( node );
+		if( mesh == NULL ) {
+			continue;
+		}
+
+		MeshJob job = makeJob( node, mesh, tolerance );
+		results.append( job.stats );
+		resultMeshes.append( mesh );
+		if( entries.contains( mesh ) ) {
+			continue;
+		}
+
+		QHash<const DzFacetMesh*, Entry>::const_iterator cached = m_entries.constFind( mesh );
+		if( cached != m_entries.constEnd() &&
+			cached->verts == job.verts &&
+			cached->facets == job.facets &&
+			cached->stats.numVerts == job.stats.numVerts &&
+			cached->stats.numFacets == job.stats.numFacets &&
+			cached->tolerance == tolerance ) {
+			entries.insert( mesh, cached.value() );
+		} else {
+			Entry entry;
+			entry.verts = job.verts;
+			entry.facets = job.facets;
+			entry.tolerance = tolerance;
+			entries.insert( mesh, entry );
+			jobs.append( job );
+		}
+	}
+
+	runJobs( jobs );
+
+	for( int i = 0; i < jobs.count(); i++ ) {
+		entries[jobs[i].mesh].stats = jobs[i].stats;
+	}
+	for( int i = 0; i < results.count(); i++ ) {
+		DzMeshHygieneStats &stats = results[i];
+		DzNode *node = stats.node;
+		QString label = stats.label;
+		stats = entries.value( resultMeshes[i] ).stats;
+		stats.node = node;
+		stats.label = label;
+	}
+
+  // Meshes no longer in the scene are dropped
+	m_entries = entries;
+	m_numAnalyzed = jobs.count();
+	return results;
+}
@@ -0,0 +1,109 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_MESH_HYGIENE_H
+#define DAZ_MESH_HYGIENE_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+/****************************
+   Forward declarations
+****************************/
+class DzFacetMesh;
+class DzNode;
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	The problems found in the geometry of a single node
+**/
+struct DzMeshHygieneStats {
+	DzNode	*node;
+	QString	label;
+	int		numVerts;
+	int		numFacets;
+	int		numDuplicateVerts;		// Vertices within tolerance of an earlier vertex
+	int		numOrphanVerts;			// Vertices not referenced by any facet
+	int		numDegenerateFacets;	// Facets with repeated vertices or zero area
+	int		numDuplicateFacets;		// Facets using the same vertices as an earlier facet
+
+	DzMeshHygieneStats() : node( NULL ), numVerts( 0 ), numFacets( 0 ),
+		numDuplicateVerts( 0 ), numOrphanVerts( 0 ), numDegenerateFacets( 0 ),
+		numDuplicateFacets( 0 ) {}
+
+	bool	hasProblems() const {
+		return numDuplicateVerts || numOrphanVerts || numDegenerateFacets || numDuplicateFacets;
+	}
+	qint64	getSavingsBytes() const;
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Finds near-duplicate vertices, degenerate and duplicate facets and
+	unused vertices in the facet meshes of scene nodes.
+
+	Near-duplicate vertices are found with a spatial hash grid: the vertices
+	are bucketed by cell and sorted, and each vertex is only compared against
+	the cells within the tolerance. Small meshes are analyzed one node per
+	thread; large meshes are split into chunks that are processed in parallel.
+**/
+class DzMeshHygiene {
+public:
+	static DzMeshHygieneStats			analyzeNode( DzNode *node, float tolerance );
+	static QList<DzMeshHygieneStats>	analyzeNodes( const QList<DzNode*> &nodes, float tolerance );
+	static QList<DzMeshHygieneStats>	analyzeScene( float tolerance );
+
+	static float	getDefaultTolerance();
+};
+
+/**
+	Keeps the hygiene stats of each facet mesh between scene analyses. A mesh
+	is analyzed again only when its vertex or facet array is replaced, its
+	counts change or the tolerance changes, so a refresh rescans only the
+	meshes that were edited.
+**/
+class DzMeshHygieneCache {
+public:
+	DzMeshHygieneCache() : m_numAnalyzed( 0 ) {}
+
+	QList<DzMeshHygieneStats>	analyzeScene( float tolerance );
+	void	clear() { m_entries.clear(); }
+
+	// Meshes scanned by the last analyzeScene(), not read from the cache
+	int		getNumAnalyzed() const { return m_numAnalyzed; }
+
+private:
+	struct Entry {
+		const void			*verts;
+		const void			*facets;
+		float				tolerance;
+		DzMeshHygieneStats	stats;
+	};
+
+	QHash<const DzFacetMesh*, Entry>	m_entries;
+	int									m_numAnalyzed;
+};
+
+#endif // DAZ_MESH_HYGIENE_H
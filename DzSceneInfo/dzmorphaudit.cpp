@@ -0,0 +1,158 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzmorphaudit.h"
+
+#include <QtCore/QtConcurrentMap>
+
+#include "dzbone.h"
+#include "dzfloatproperty.h"
+#include "dzmorph.h"
+#include "dzmorphdeltas.h"
+#include "dzobject.h"
+#include "dzscene.h"
+#include "dzskeleton.h"
+#include "dzvec3.h"
+
+// Deltas closer to zero than this do not move the vertex
+static const float c_zeroDeltaSq = 1.0e-12f;
+
+/**
+	Appends an entry for every morph modifier on the node's object.
+	Must be called on the GUI thread, since reading the value channel
+	can evaluate the property's controllers.
+**/
+static void collectMorphs( DzNode *node, DzMorphAuditFigure &figure ) {
+	DzObject *obj = node ? node->getObject() : NULL;
+	if( obj == NULL ) {
+		return;
+	}
+
+	int i, n = obj->getNumModifiers();
+	for( i = 0; i < n; i++ ) {
+		DzMorph *morph = qobject_cast<DzMorph*>( obj->getModifier( i ) );
+		if( morph == NULL ) {
+			continue;
+		}
+
+		DzMorphAuditEntry entry;
+		entry.morph = morph;
+		entry.name = morph->getLabel();
+		entry.owner = node->getLabel();
+
+		DzFloatProperty *value = morph->getValueChannel();
+		entry.dialed = value && value->getValue() != value->getDefaultValue();
+		entry.deltas = morph->getDeltas();
+		figure.morphs.append( entry );
+	}
+}
+
+/**
+	Scans the deltas of every morph of one figure. Runs on a worker thread,
+	so only the delta arrays are read here.
+**/
+static void scanFigure( DzMorphAuditFigure &figure ) {
+	int i, j, n = figure.morphs.count();
+	for( i = 0; i < n; i++ ) {
+		DzMorphAuditEntry &entry = figure.morphs[i];
+		DzMorphDeltas *deltas = entry.deltas;
+		entry.numDeltas = deltas ? deltas->getNumDeltas() : 0;
+		entry.numZeroDeltas = 0;
+		for( j = 0; j < entry.numDeltas; j++ ) {
+			DzVec3 d = deltas->getDeltaVec( j );
+			if( d.m_x * d.m_x + d.m_y * d.m_y + d.m_z * d.m_z < c_zeroDeltaSq ) {
+				entry.numZeroDeltas++;
+			}
+		}
+		entry.bytes = DzMorphAudit::estimateDeltaBytes( entry.numDeltas );
+
+		figure.totalDeltas += entry.numDeltas;
+		figure.totalBytes += entry.bytes;
+		if( entry.isEmpty() ) {
+			figure.numEmpty++;
+		} else if( !entry.dialed ) {
+			figure.numUndialed++;
+		}
+		if( entry.isUnused() ) {
+			figure.unusedBytes += entry.bytes;
+		}
+	}
+}
+
+/**
+	Estimated memory for a morph with the given number of deltas : each delta
+	stores a vertex index and an offset vector.
+**/
+qint64 DzMorphAudit::estimateDeltaBytes( int numDeltas ) {
+	return (qint64)numDeltas * ( sizeof(int) + sizeof(DzVec3) );
+}
+
+/**
+	Returns all of the figures (skeletons) in the scene
+**/
+QList<DzNode*> DzMorphAudit::getSceneFigures() {
+	QList<DzNode*> figures;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		if( node->inherits( "DzSkeleton" ) ) {
+			figures.append( node );
+		}
+	}
+	return figures;
+}
+
+/**
+ **/
+DzMorphAuditFigure DzMorphAudit::auditFigure( DzNode *figure ) {
+	QList<DzNode*> figures;
+	figures.append( figure );
+	return auditFigures( figures ).first();
+}
+
+/**
+ **/
+QList<DzMorphAuditFigure> DzMorphAudit::auditFigures( const QList<DzNode*> &figures ) {
+	QList<DzMorphAuditFigure> results;
+
+  // Gather the morphs for each figure and its bones on this thread
+	int i, j, n;
+	for( i = 0; i < figures.count(); i++ ) {
+		DzMorphAuditFigure figure;
+		figure.figure = figures[i];
+		figure.label = figures[i]->getLabel();
+		collectMorphs( figures[i], figure );
+
+		if( figures[i]->inherits( "DzSkeleton" ) ) {
+			DzBoneList bones;
+			((DzSkeleton*)figures[i])->getAllBones( bones );
+			for( j = 0, n = bones.count(); j < n; j++ ) {
+				collectMorphs( bones[j], figure );
+			}
+		}
+		results.append( figure );
+	}
+
+  // Scan the deltas, one job per figure
+	QtConcurrent::blockingMap( results, scanFigure );
+
+	return results;
+}
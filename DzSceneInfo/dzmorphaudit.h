@@ -0,0 +1,94 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_MORPH_AUDIT_H
+#define DAZ_MORPH_AUDIT_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+/****************************
+   Forward declarations
+****************************/
+class DzNode;
+class DzMorph;
+class DzMorphDeltas;
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	The audit results for a single morph modifier
+**/
+struct DzMorphAuditEntry {
+	DzMorph			*morph;			// Only dereferenced on the GUI thread
+	DzMorphDeltas	*deltas;		// Looked up on the GUI thread, scanned by the workers
+	QString			name;
+	QString			owner;			// Label of the node the morph is attached to
+	int				numDeltas;		// Delta entries stored by the morph
+	int				numZeroDeltas;	// Delta entries that do not move the vertex
+	qint64			bytes;			// Estimated memory used by the deltas
+	bool			dialed;			// The value differs from the default
+
+	DzMorphAuditEntry() : morph( NULL ), deltas( NULL ), numDeltas( 0 ), numZeroDeltas( 0 ),
+		bytes( 0 ), dialed( false ) {}
+
+	bool	isEmpty() const { return numDeltas == numZeroDeltas; }
+	bool	isUnused() const { return isEmpty() || !dialed; }
+};
+
+/**
+	The audit results for a figure, its bones and the morphs attached to them
+**/
+struct DzMorphAuditFigure {
+	DzNode	*figure;
+	QString	label;
+	QList<DzMorphAuditEntry> morphs;
+	int		totalDeltas;
+	int		numEmpty;
+	int		numUndialed;
+	qint64	totalBytes;
+	qint64	unusedBytes;		// Bytes that could be reclaimed by removing unused morphs
+
+	DzMorphAuditFigure() : figure( NULL ), totalDeltas( 0 ), numEmpty( 0 ),
+		numUndialed( 0 ), totalBytes( 0 ), unusedBytes( 0 ) {}
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Enumerates the morph modifiers attached to figures and their bones and
+	estimates the memory used by the morph deltas.
+
+	The modifier lists, morph values and delta objects are gathered on the
+	calling (GUI) thread. Scanning the delta arrays is then fanned out across
+	cores, one job per figure; the workers never call into the morphs.
+**/
+class DzMorphAudit {
+public:
+	static QList<DzMorphAuditFigure>	auditFigures( const QList<DzNode*> &figures );
+	static DzMorphAuditFigure			auditFigure( DzNode *figure );
+
+	static QList<DzNode*>	getSceneFigures();
+	static qint64			estimateDeltaBytes( int numDeltas );
+};
+
+#endif // DAZ_MORPH_AUDIT_H
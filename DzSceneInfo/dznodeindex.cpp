@@ -0,0 +1,550 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dznodeindex.h"
+
+#include <QtCore/QRegExp>
+#include <QtCore/QStringList>
+
+#include <algorithm>
+
+#include "dznode.h"
+#include "dzscene.h"
+#include "dzscenetree.h"
+
+static const int c_gramLength = 3;
+static const int c_minCompact = 1024;		// Dead entries before compacting is considered
+
+/**
+	One term of a query. A text term with field -1 matches any field.
+**/
+struct DzNodeIndex::Term {
+	bool	range;
+	int		field;
+	QString	text;
+	bool	facets;			// Range over the facet count rather than the vertex count
+	qint64	min, max;		// Inclusive
+};
+
+/**
+	The trigram at pos, tagged with the field it came from. Each character
+	takes 16 bits, so distinct trigrams never share a key.
+**/
+quint64 DzNodeIndex::makeGram( int field, const QString &text, int pos ) {
+	return ( (quint64)field << 48 ) |
+		( (quint64)text[pos].unicode() << 32 ) |
+		( (quint64)text[pos + 1].unicode() << 16 ) |
+		(quint64)text[pos + 2].unicode();
+}
+
+/**
+	Returns false if the token is empty
+**/
+bool DzNodeIndex::parseTerm( const QString &token, Term &term ) {
+	static const QRegExp rangeExp( "^(verts|faces)(<=|>=|<|>|=)(\\d+)$" );
+	static const QRegExp fieldExp( "^(label|path|class):(.+)$" );
+
+	QString text = token.toLower();
+	term.range = false;
+	term.field = -1;
+	term.facets = false;
+	term.min = 0;
+	term.max = 0;
+
+	QRegExp exp = rangeExp;
+	if( exp.exactMatch( text ) ) {
+		QString op = exp.cap( 2 );
+		qint64 value = qMin( exp.cap( 3 ).toLongLong(), Q_INT64_C( 0x7fffffff ) );
+		term.range = true;
+		term.facets = exp.cap( 1 ) == "faces";
+		term.min = 0;
+		term.max = Q_INT64_C( 0x7fffffff );
+		if( op == "<" ) {
+			term.max = value - 1;
+		} else if( op == "<=" ) {
+			term.max = value;
+		} else if( op == ">" ) {
+			term.min = value + 1;
+		} else if( op == ">=" ) {
+			term.min = value;
+		} else {
+			term.min = term.max = value;
+		}
+		return true;
+	}
+
+	exp = fieldExp;
+	if( exp.exactMatch( text ) ) {
+		QString field = exp.cap( 1 );
+		term.field = field == "label" ? Label : field == "path" ? Path : ClassName;
+		text = exp.cap( 2 );
+	}
+	term.text = text;
+	return !text.isEmpty();
+}
+
+/**
+ **/
+DzNodeIndex::DzNodeIndex( QObject *parent ) :
+	QObject( parent ),
+	m_built( false ),
+	m_numDead( 0 )
+{
+}
+
+/**
+	Queue a node added to the scene. Its label and asset are usually set after
+	the signal, so it is read on the next sync().
+**/
+void DzNodeIndex::nodeAdded( DzNode *node ) {
+	if( m_built ) {
+		m_pending.append( node );
+	}
+}
+
+/**
+	Called before the node is deleted; only the pointer is used
+**/
+void DzNodeIndex::nodeRemoved( DzNode *node ) {
+	if( !m_built ) {
+		return;
+	}
+	m_pending.removeAll( node );
+	if( removeEntry( node ) >= 0 ) {
+		disconnect( node, 0, this, 0 );
+	}
+}
+
+/**
+	Index a renamed node again under a new id; appending keeps the postings
+	sorted, and the old entry is left dead like a removed node's
+**/
+void DzNodeIndex::nodeLabelChanged() {
+	DzNode *node = qobject_cast<DzNode*>( sender() );
+	QHash<DzNode*, int>::const_iterator it = node ? m_ids.constFind( node ) : m_ids.constEnd();
+	if( it == m_ids.constEnd() ) {
+		return;
+	}
+
+	Entry entry = m_entries[it.value()];
+	entry.fields[Label] = node->getLabel().toLower();
+	removeEntry( node );
+
+	int id = m_entries.count();
+	m_ids.insert( node, id );
+	m_entries.append( entry );
+	indexEntry( id );
+	insertRange( m_verts, entry.verts, id );
+	insertRange( m_facets, entry.facets, id );
+}
+
+/**
+	Build the index if needed, index the nodes added since the last sync, and
+	bring the counts up to date with the scene tree. tree should have been
+	synced with the scene.
+**/
+void DzNodeIndex::sync( const DzSceneTree &tree ) {
+	if( !m_built ) {
+		build( tree );
+		return;
+	}
+
+	for( int i = 0; i < m_pending.count(); i++ ) {
+		if( !m_ids.contains( m_pending[i] ) ) {
+			addEntry( m_pending[i], tree );
+			int id = m_entries.count() - 1;
+			indexEntry( id );
+			insertRange( m_verts, m_entries[id].verts, id );
+			insertRange( m_facets, m_entries[id].facets, id );
+		}
+	}
+	m_pending.clear();
+
+	if( m_numDead > c_minCompact && m_numDead > m_ids.count() ) {
+		compact();
+	}
+
+  // Geometry changes only move the node within the range arrays
+	QHash<DzNode*, int>::const_iterator it;
+	for( it = m_ids.constBegin(); it != m_ids.constEnd(); ++it ) {
+		const DzSceneTree::Item *item = tree.getItem( it.key() );
+		if( item == NULL ) {
+			continue;
+		}
+		Entry &entry = m_entries[it.value()];
+		if( entry.verts != item->own.numVerts ) {
+			removeRange( m_verts, entry.verts, it.value() );
+			entry.verts = item->own.numVerts;
+			insertRange( m_verts, entry.verts, it.value() );
+		}
+		if( entry.facets != item->own.getNumFacets() ) {
+			removeRange( m_facets, entry.facets, it.value() );
+			entry.facets = item->own.getNumFacets();
+			insertRange( m_facets, entry.facets, it.value() );
+		}
+	}
+}
+
+/**
+ **/
+void DzNodeIndex::clear() {
+	QHash<DzNode*, int>::const_iterator it;
+	for( it = m_ids.constBegin(); it != m_ids.constEnd(); ++it ) {
+		disconnect( it.key(), 0, this, 0 );
+	}
+	m_entries.clear();
+	m_ids.clear();
+	m_postings.clear();
+	m_verts.clear();
+	m_facets.clear();
+	m_pending.clear();
+	m_built = false;
+	m_numDead = 0;
+}
+
+/**
+	Index every node in scene order. Ids increase as the entries are added, so
+	the postings are built sorted by appending, and the range arrays are
+	sorted once at the end.
+**/
+void DzNodeIndex::build( const DzSceneTree &tree ) {
+	clear();
+	m_entries.reserve( dzScene->getNumNodes() );
+
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	while( nodeIter.hasNext() ) {
+		addEntry( nodeIter.next(), tree );
+	}
+
+	for( int id = 0; id < m_entries.count(); id++ ) {
+		indexEntry( id );
+	}
+	sortRanges();
+	m_built = true;
+}
+
+/**
+	Drop the dead entries and renumber the live ones in their current order
+**/
+void DzNodeIndex::compact() {
+	QVector<Entry> entries = m_entries;
+	m_entries.clear();
+	m_ids.clear();
+	m_postings.clear();
+	m_numDead = 0;
+
+	for( int i = 0; i < entries.count(); i++ ) {
+		if( entries[i].node ) {
+			m_ids.insert( entries[i].node, m_entries.count() );
+			m_entries.append( entries[i] );
+		}
+	}
+	for( int id = 0; id < m_entries.count(); id++ ) {
+		indexEntry( id );
+	}
+	sortRanges();
+}
+
+/**
+ **/
+void DzNodeIndex::addEntry( DzNode *node, const DzSceneTree &tree ) {
+	Entry entry;
+	entry.node = node;
+	entry.fields[Label] = node->getLabel().toLower();
+	entry.fields[Path] = node->getAssetFileInfo().getUri().getFilePath().toLower();
+	entry.fields[ClassName] = QString( node->className() ).toLower();
+
+	DzGeomStats stats;
+	const DzSceneTree::Item *item = tree.getItem( node );
+	if( item ) {
+		stats = item->own;
+	} else {
+		DzSceneTree::getNodeInfo( node, stats );
+	}
+	entry.verts = stats.numVerts;
+	entry.facets = stats.getNumFacets();
+
+	m_ids.insert( node, m_entries.count() );
+	m_entries.append( entry );
+	connect( node, SIGNAL(labelChanged(const QString&)), this, SLOT(nodeLabelChanged()) );
+}
+
+/**
+	Mark the node's entry dead and drop it from the range arrays. Returns
+	the entry's id, or -1 if the node was not indexed.
+**/
+int DzNodeIndex::removeEntry( DzNode *node ) {
+	QHash<DzNode*, int>::iterator it = m_ids.find( node );
+	if( it == m_ids.end() ) {
+		return -1;
+	}
+	int id = it.value();
+	Entry &entry = m_entries[id];
+	removeRange( m_verts, entry.verts, id );
+	removeRange( m_facets, entry.facets, id );
+	entry.node = NULL;
+	for( int i = 0; i < NumFields; i++ ) {
+		entry.fields[i].clear();
+	}
+	m_ids.erase( it );
+	m_numDead++;
+	return id;
+}
+
+/**
+	Add the entry to the postings. The id is the largest so far, so appending
+	keeps the postings sorted; a trigram repeated in the same string is only
+	added once.
+**/
+void DzNodeIndex::indexEntry( int id ) {
+	const Entry &entry = m_entries[id];
+	for( int field = 0; field < NumFields; field++ ) {
+		const QString &text = entry.fields[field];
+		for( int pos = 0; pos + c_gramLength <= text.length(); pos++ ) {
+			QVector<int> &ids = m_postings[makeGram( field, text, pos )];
+			if( ids.isEmpty() || ids.last() != id ) {
+				ids.append( id );
+			}
+		}
+	}
+}
+
+/**
+	Rebuild the range arrays from the live entries
+**/
+void DzNodeIndex::sortRanges() {
+	m_verts.clear();
+	m_facets.clear();
+	m_verts.reserve( m_ids.count() );
+	m_facets.reserve( m_ids.count() );
+
+	RangeKey key;
+	for( int id = 0; id < m_entries.count(); id++ ) {
+		if( m_entries[id].node == NULL ) {
+			continue;
+		}
+		key.id = id;
+		key.value = m_entries[id].verts;
+		m_verts.append( key );
+		key.value = m_entries[id].facets;
+		m_facets.append( key );
+	}
+	qSort( m_verts );
+	qSort( m_facets );
+}
+
+/**
+ **/
+void DzNodeIndex::insertRange( QVector<RangeKey> &range, int value, int id ) {
+	RangeKey key;
+	key.value = value;
+	key.id = id;
+	range.insert( qLowerBound( range.begin(), range.end(), key ), key );
+}
+
+/**
+ **/
+void DzNodeIndex::removeRange( QVector<RangeKey> &range, int value, int id ) {
+	RangeKey key;
+	key.value = value;
+	key.id = id;
+	QVector<RangeKey>::iterator it = qLowerBound( range.begin(), range.end(), key );
+	if( it != range.end() && it->value == value && it->id == id ) {
+		range.erase( it );
+	}
+}
+
+/**
+	The keys within the term's range
+**/
+void DzNodeIndex::getRangeSlice( const Term &term, QVector<RangeKey>::const_iterator &begin,
+	QVector<RangeKey>::const_iterator &end ) const {
+	const QVector<RangeKey> &range = term.facets ? m_facets : m_verts;
+	if( term.min > term.max ) {
+		begin = end = range.constEnd();
+		return;
+	}
+
+	RangeKey lower, upper;
+	lower.value = (int)term.min;
+	lower.id = -1;
+	upper.value = (int)term.max;
+	upper.id = 0x7fffffff;
+	begin = qLowerBound( range.constBegin(), range.constEnd(), lower );
+	end = qUpperBound( begin, range.constEnd(), upper );
+}
+
+/**
+	An upper bound on the number of candidates the term would supply, or -1
+	if the term cannot use the index
+**/
+int DzNodeIndex::estimate( const Term &term ) const {
+	if( term.range ) {
+		QVector<RangeKey>::const_iterator begin, end;
+		getRangeSlice( term, begin, end );
+		return end - begin;
+	}
+
+	if( term.text.length() < c_gramLength ) {
+		return -1;
+	}
+
+  // The rarest trigram in each field bounds that field's matches
+	int total = 0;
+	for( int field = 0; field < NumFields; field++ ) {
+		if( term.field >= 0 && term.field != field ) {
+			continue;
+		}
+		int fewest = -1;
+		for( int pos = 0; pos + c_gramLength <= term.text.length() && fewest != 0; pos++ ) {
+			QHash<quint64, QVector<int> >::const_iterator it =
+				m_postings.constFind( makeGram( field, term.text, pos ) );
+			int count = it == m_postings.constEnd() ? 0 : it->count();
+			if( fewest < 0 || count < fewest ) {
+				fewest = count;
+			}
+		}
+		total += fewest;
+	}
+	return total;
+}
+
+/**
+	The ids the term may match, sorted and without duplicates
+**/
+void DzNodeIndex::getCandidates( const Term &term, QVector<int> &ids ) const {
+	ids.clear();
+	if( term.range ) {
+		QVector<RangeKey>::const_iterator it, end;
+		getRangeSlice( term, it, end );
+		ids.reserve( end - it );
+		for( ; it != end; ++it ) {
+			ids.append( it->id );
+		}
+		qSort( ids );
+		return;
+	}
+
+  // The rarest trigram of each field; already sorted, so only the union
+  // over several fields needs sorting
+	int numLists = 0;
+	for( int field = 0; field < NumFields; field++ ) {
+		if( term.field >= 0 && term.field != field ) {
+			continue;
+		}
+		const QVector<int> *fewest = NULL;
+		for( int pos = 0; pos + c_gramLength <= term.text.length(); pos++ ) {
+			QHash<quint64, QVector<int> >::const_iterator it =
+				m_postings.constFind( makeGram( field, term.text, pos ) );
+			if( it == m_postings.constEnd() ) {
+				fewest = NULL;
+				break;
+			}
+			if( fewest == NULL || it->count() < fewest->count() ) {
+				fewest = &it.value();
+			}
+		}
+		if( fewest ) {
+			ids += *fewest;
+			numLists++;
+		}
+	}
+	if( numLists > 1 ) {
+		qSort( ids );
+		ids.erase( std::unique( ids.begin(), ids.end() ), ids.end() );
+	}
+}
+
+/**
+ **/
+bool DzNodeIndex::matches( const Entry &entry, const Term &term ) const {
+	if( entry.node == NULL ) {
+		return false;
+	}
+	if( term.range ) {
+		qint64 value = term.facets ? entry.facets : entry.verts;
+		return value >= term.min && value <= term.max;
+	}
+	if( term.field >= 0 ) {
+		return entry.fields[term.field].contains( term.text );
+	}
+	for( int field = 0; field < NumFields; field++ ) {
+		if( entry.fields[field].contains( term.text ) ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+	Returns the number of matching nodes. The first maxNodes of them, in
+	scene order, are appended to nodes. sync() should have been called.
+**/
+int DzNodeIndex::query( const QString &text, int maxNodes, QList<DzNode*> &nodes ) const {
+	QList<Term> terms;
+	QStringList tokens = text.split( QRegExp( "\\s+" ), QString::SkipEmptyParts );
+	for( int i = 0; i < tokens.count(); i++ ) {
+		Term term;
+		if( parseTerm( tokens[i], term ) ) {
+			terms.append( term );
+		}
+	}
+
+  // The most selective indexed term supplies the candidates
+	int driver = -1;
+	int fewest = -1;
+	for( int i = 0; i < terms.count(); i++ ) {
+		int count = estimate( terms[i] );
+		if( count >= 0 && ( fewest < 0 || count < fewest ) ) {
+			driver = i;
+			fewest = count;
+		}
+	}
+
+	QVector<int> ids;
+	if( driver >= 0 ) {
+		getCandidates( terms[driver], ids );
+		if( terms[driver].range ) {
+		  // Range candidates are exact; text candidates still need checking
+			terms.removeAt( driver );
+		}
+	} else {
+		ids.reserve( m_entries.count() );
+		for( int id = 0; id < m_entries.count(); id++ ) {
+			ids.append( id );
+		}
+	}
+
+	int numMatches = 0;
+	for( int i = 0; i < ids.count(); i++ ) {
+		const Entry &entry = m_entries[ids[i]];
+		bool match = entry.node != NULL;
+		for( int j = 0; j < terms.count() && match; j++ ) {
+			match = matches( entry, terms[j] );
+		}
+		if( match ) {
+			if( numMatches < maxNodes ) {
+				nodes.append( entry.node );
+			}
+			numMatches++;
+		}
+	}
+	return numMatches;
+}
@@ -0,0 +1,136 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_NODE_INDEX_H
+#define DAZ_NODE_INDEX_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+/****************************
+   Forward declarations
+****************************/
+class DzNode;
+class DzSceneTree;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Searchable index over the scene nodes.
+
+	Labels, asset paths and class names are lower-cased and broken into
+	trigrams; each trigram maps to the sorted ids of the nodes containing it.
+	Vertex and facet counts are kept in arrays sorted by value. A query is a
+	list of terms that must all match :
+
+		text				substring of the label, path or class name
+		label:text			substring of one field; also path: and class:
+		verts>N, faces<=N	range over the node's own counts; also >=, < and =
+
+	The term expected to match the fewest nodes supplies the candidates and
+	the other terms are checked on each candidate, so the cost follows the
+	most selective term rather than the size of the scene. Terms shorter than
+	a trigram cannot use the index and are only checked.
+
+	Nothing is built until the first query. After that, nodeAdded() and
+	nodeRemoved() keep the index current: removed nodes are marked dead and
+	left in the postings until they outnumber the live ones, and added nodes
+	are indexed on the next sync(), once their label and asset are set.
+	sync() walks every node to update the counts, so it belongs with the
+	scene tree's own sync rather than with each query. Each indexed node is
+	watched for label changes, and a renamed node is indexed again at once
+	under a new id, its old entry marked dead.
+**/
+class DzNodeIndex : public QObject {
+	Q_OBJECT
+public:
+	enum Field {
+		Label,
+		Path,
+		ClassName,
+		NumFields
+	};
+
+	DzNodeIndex( QObject *parent = NULL );
+
+	void	nodeAdded( DzNode *node );
+	void	nodeRemoved( DzNode *node );
+	void	sync( const DzSceneTree &tree );
+	void	clear();
+
+	int		query( const QString &text, int maxNodes, QList<DzNode*> &nodes ) const;
+
+	bool	isBuilt() const { return m_built; }
+	int		getNumNodes() const { return m_ids.count(); }
+	int		getNumGrams() const { return m_postings.count(); }
+
+private slots:
+
+	void	nodeLabelChanged();
+
+private:
+	struct Entry {
+		DzNode	*node;			// NULL once removed
+		QString	fields[NumFields];
+		int		verts;
+		int		facets;
+	};
+	struct RangeKey {
+		int		value;
+		int		id;
+
+		bool operator<( const RangeKey &other ) const {
+			return value < other.value || ( value == other.value && id < other.id );
+		}
+	};
+	struct Term;
+
+	static quint64	makeGram( int field, const QString &text, int pos );
+	static bool		parseTerm( const QString &token, Term &term );
+
+	void			build( const DzSceneTree &tree );
+	void			compact();
+	void			addEntry( DzNode *node, const DzSceneTree &tree );
+	int				removeEntry( DzNode *node );
+	void			indexEntry( int id );
+	void			sortRanges();
+	void			insertRange( QVector<RangeKey> &range, int value, int id );
+	void			removeRange( QVector<RangeKey> &range, int value, int id );
+	void			getRangeSlice( const Term &term, QVector<RangeKey>::const_iterator &begin,
+						QVector<RangeKey>::const_iterator &end ) const;
+	int				estimate( const Term &term ) const;
+	void			getCandidates( const Term &term, QVector<int> &ids ) const;
+	bool			matches( const Entry &entry, const Term &term ) const;
+
+	QVector<Entry>					m_entries;		// Indexed by id
+	QHash<DzNode*, int>				m_ids;			// Live nodes only
+	QHash<quint64, QVector<int> >	m_postings;		// Sorted ids per field and trigram
+	QVector<RangeKey>				m_verts;
+	QVector<RangeKey>				m_facets;
+	QList<DzNode*>					m_pending;		// Added since the last sync
+	bool							m_built;
+	int								m_numDead;
+};
+
+#endif // DAZ_NODE_INDEX_H
@@ -0,0 +1,357 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzpropertysnapshot.h"
+
+#include <string.h>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QtAlgorithms>
+
+#include "dzbone.h"
+#include "dzboolproperty.h"
+#include "dzcolorproperty.h"
+#include "dzfloatproperty.h"
+#include "dzimageproperty.h"
+#include "dzintproperty.h"
+#include "dzmodifier.h"
+#include "dznode.h"
+#include "dzobject.h"
+#include "dzskeleton.h"
+#include "dzstringproperty.h"
+#include "dztexture.h"
+
+static const quint64 c_fnvOffset = Q_UINT64_C( 0xcbf29ce484222325 );
+static const quint64 c_fnvPrime = Q_UINT64_C( 0x100000001b3 );
+
+/**
+	A property as it is read, before it is placed in its group
+**/
+struct DzSnapshotItem {
+	quint64	key;
+	quint64	bits;
+	qint32	numKeys;
+	qint32	kind;
+	QString	name;
+
+	bool operator<( const DzSnapshotItem &other ) const { return key < other.key; }
+};
+
+/**
+	An element whose properties make up one group
+**/
+struct DzSnapshotGroup {
+	quint64		key;
+	DzElement	*element;
+	QString		name;
+
+	bool operator<( const DzSnapshotGroup &other ) const { return key < other.key; }
+};
+
+/**
+	64-bit FNV-1a of the string's UTF-16 code units
+**/
+static quint64 hashString( const QString &text ) {
+	quint64 hash = c_fnvOffset;
+	const ushort *data = text.utf16();
+	for( int i = 0, n = text.length(); i < n; i++ ) {
+		hash = ( hash ^ ( data[i] & 0xff ) ) * c_fnvPrime;
+		hash = ( hash ^ ( data[i] >> 8 ) ) * c_fnvPrime;
+	}
+	return hash;
+}
+
+/**
+ **/
+static quint64 mixHash( quint64 hash, quint64 value ) {
+	return ( hash ^ value ) * c_fnvPrime;
+}
+
+/**
+ **/
+static quint64 doubleBits( double value ) {
+	quint64 bits;
+	memcpy( &bits, &value, sizeof(bits) );
+	return bits;
+}
+
+/**
+ **/
+static double bitsDouble( quint64 bits ) {
+	double value;
+	memcpy( &value, &bits, sizeof(value) );
+	return value;
+}
+
+/**
+	The value of the property as bits, its kind and its number of keys.
+	Bool is tested before int, which it may derive from.
+**/
+static void readProperty( DzProperty *prop, DzSnapshotItem &item ) {
+	item.bits = 0;
+	item.numKeys = 0;
+	item.kind = DzPropertySnapshot::Number;
+	if( DzFloatProperty *fprop = qobject_cast<DzFloatProperty*>( prop ) ) {
+		item.bits = doubleBits( fprop->getValue() );
+		item.numKeys = fprop->getNumKeys();
+	} else if( DzBoolProperty *bprop = qobject_cast<DzBoolProperty*>( prop ) ) {
+		item.bits = doubleBits( bprop->getBoolValue() ? 1.0 : 0.0 );
+	} else if( DzIntProperty *iprop = qobject_cast<DzIntProperty*>( prop ) ) {
+		item.bits = doubleBits( iprop->getValue() );
+		item.numKeys = iprop->getNumKeys();
+	} else if( DzColorProperty *cprop = qobject_cast<DzColorProperty*>( prop ) ) {
+		item.bits = cprop->getColorValue().rgba();
+		item.numKeys = cprop->getNumKeys();
+		item.kind = DzPropertySnapshot::Color;
+	} else if( DzStringProperty *sprop = qobject_cast<DzStringProperty*>( prop ) ) {
+		item.bits = hashString( sprop->getValue() );
+		item.kind = DzPropertySnapshot::Text;
+	} else if( DzImageProperty *mprop = qobject_cast<DzImageProperty*>( prop ) ) {
+		DzTexture *texture = mprop->getValue();
+		item.bits = hashString( texture ? texture->getFilename() : QString() );
+		item.kind = DzPropertySnapshot::Text;
+	} else {
+	  // Only its presence is recorded
+		item.kind = DzPropertySnapshot::Text;
+	}
+}
+
+/**
+ **/
+void DzPropertySnapshot::clear() {
+	m_node = NULL;
+	m_groups.clear();
+	m_entries.clear();
+	m_groupNames.clear();
+	m_names.clear();
+	m_captureNsecs = 0;
+}
+
+/**
+ **/
+qint64 DzPropertySnapshot::getBytes() const {
+	return (qint64)m_groups.count() * sizeof(Group) + (qint64)m_entries.count() * sizeof(Entry);
+}
+
+/**
+	Read every property of the element into a new group, sorted by key
+**/
+void DzPropertySnapshot::addGroup( DzElement *element, const QString &name ) {
+	QVector<DzSnapshotItem> items;
+	items.reserve( element->getNumProperties() + element->getNumPrivateProperties() );
+
+	DzSnapshotItem item;
+	DzProperty *prop = NULL;
+	DzPropertyListIterator propIter( element->propertyListIterator() );
+	while( propIter.hasNext() ) {
+		prop = propIter.next();
+		item.name = prop->getName();
+		item.key = hashString( item.name );
+		readProperty( prop, item );
+		items.append( item );
+	}
+	DzPropertyListIterator privPropIter( element->privatePropertyListIterator() );
+	while( privPropIter.hasNext() ) {
+		prop = privPropIter.next();
+		item.name = prop->getName();
+		item.key = hashString( item.name );
+		readProperty( prop, item );
+		items.append( item );
+	}
+	qSort( items.begin(), items.end() );
+
+	Group group;
+	group.key = hashString( name );
+	group.hash = c_fnvOffset;
+	group.begin = m_entries.count();
+	Entry entry;
+	entry.group = m_groups.count();
+	for( int i = 0; i < items.count(); i++ ) {
+		entry.key = items[i].key;
+		entry.bits = items[i].bits;
+		entry.numKeys = items[i].numKeys;
+		entry.kind = items[i].kind;
+		m_entries.append( entry );
+		m_names.append( items[i].name );
+
+		group.hash = mixHash( group.hash, entry.key );
+		group.hash = mixHash( group.hash, entry.bits );
+		group.hash = mixHash( group.hash, entry.numKeys );
+	}
+	group.end = m_entries.count();
+	m_groups.append( group );
+	m_groupNames.append( name );
+}
+
+/**
+	The node, the bones of a figure, and the modifiers on the node's object
+**/
+void DzPropertySnapshot::capture( DzNode *node ) {
+	QElapsedTimer timer;
+	timer.start();
+	clear();
+	if( node == NULL ) {
+		return;
+	}
+	m_node = node;
+
+	QVector<DzSnapshotGroup> groups;
+	DzSnapshotGroup group;
+	group.element = node;
+	group.name = node->getName();
+	groups.append( group );
+
+	if( DzSkeleton *figure = qobject_cast<DzSkeleton*>( node ) ) {
+		DzBoneList bones;
+		figure->getAllBones( bones );
+		for( int i = 0; i < bones.count(); i++ ) {
+			group.element = bones[i];
+			group.name = node->getName() + "/" + bones[i]->getName();
+			groups.append( group );
+		}
+	}
+
+	DzObject *obj = node->getObject();
+	if( obj ) {
+		for( int i = 0, n = obj->getNumModifiers(); i < n; i++ ) {
+			group.element = obj->getModifier( i );
+			group.name = "Modifiers/" + obj->getModifier( i )->getName();
+			groups.append( group );
+		}
+	}
+
+	for( int i = 0; i < groups.count(); i++ ) {
+		groups[i].key = hashString( groups[i].name );
+	}
+	qSort( groups.begin(), groups.end() );
+
+	m_groups.reserve( groups.count() );
+	for( int i = 0; i < groups.count(); i++ ) {
+		addGroup( groups[i].element, groups[i].name );
+	}
+	m_captureNsecs = timer.nsecsElapsed();
+}
+
+/**
+ **/
+QString DzPropertySnapshot::formatValue( const Entry &entry ) {
+	switch( entry.kind ) {
+	case Number:	return QString::number( bitsDouble( entry.bits ), 'g', 6 );
+	case Color:		return QString( "#%1" ).arg( (uint)entry.bits, 8, 16, QChar( '0' ) );
+	default:		return QString( "(text)" );
+	}
+}
+
+/**
+	Count the change, and keep it if there is room. before or after is NULL for
+	an added or removed property.
+**/
+void DzPropertySnapshot::addChange( DzPropertyDiff &result, DzPropertyChange::Kind kind,
+	const DzPropertySnapshot *before, int beforeEntry,
+	const DzPropertySnapshot *after, int afterEntry, int maxChanges ) {
+	switch( kind ) {
+	case DzPropertyChange::Changed:	result.numChanged++; break;
+	case DzPropertyChange::Added:	result.numAdded++; break;
+	case DzPropertyChange::Removed:	result.numRemoved++; break;
+	}
+	if( result.changes.count() >= maxChanges ) {
+		return;
+	}
+
+	DzPropertyChange change;
+	change.kind = kind;
+	if( before ) {
+		const Entry &entry = before->m_entries[beforeEntry];
+		change.group = before->m_groupNames[entry.group];
+		change.name = before->m_names[beforeEntry];
+		change.oldValue = formatValue( entry );
+		change.oldKeys = entry.numKeys;
+	}
+	if( after ) {
+		const Entry &entry = after->m_entries[afterEntry];
+		change.group = after->m_groupNames[entry.group];
+		change.name = after->m_names[afterEntry];
+		change.newValue = formatValue( entry );
+		change.newKeys = entry.numKeys;
+	}
+	result.changes.append( change );
+}
+
+/**
+	Every property of a group that is only in one of the snapshots
+**/
+void DzPropertySnapshot::addGroupChanges( DzPropertyDiff &result, DzPropertyChange::Kind kind,
+	const DzPropertySnapshot &snapshot, int group, int maxChanges ) {
+	const Group &g = snapshot.m_groups[group];
+	for( int i = g.begin; i < g.end; i++ ) {
+		if( kind == DzPropertyChange::Added ) {
+			addChange( result, kind, NULL, 0, &snapshot, i, maxChanges );
+		} else {
+			addChange( result, kind, &snapshot, i, NULL, 0, maxChanges );
+		}
+	}
+}
+
+/**
+	Merge the sorted groups, then the sorted entries of the groups whose
+	hashes differ
+**/
+DzPropertyDiff DzPropertySnapshot::diff( const DzPropertySnapshot &before, const DzPropertySnapshot &after,
+	int maxChanges ) {
+	DzPropertyDiff result;
+	int i = 0, j = 0;
+	int numBefore = before.m_groups.count();
+	int numAfter = after.m_groups.count();
+	while( i < numBefore || j < numAfter ) {
+		result.numGroups++;
+		if( j >= numAfter || ( i < numBefore && before.m_groups[i].key < after.m_groups[j].key ) ) {
+			addGroupChanges( result, DzPropertyChange::Removed, before, i++, maxChanges );
+			continue;
+		}
+		if( i >= numBefore || after.m_groups[j].key < before.m_groups[i].key ) {
+			addGroupChanges( result, DzPropertyChange::Added, after, j++, maxChanges );
+			continue;
+		}
+
+		const Group &group1 = before.m_groups[i++];
+		const Group &group2 = after.m_groups[j++];
+		if( group1.hash == group2.hash && group1.end - group1.begin == group2.end - group2.begin ) {
+			result.numGroupsSkipped++;
+			continue;
+		}
+
+		int k = group1.begin, l = group2.begin;
+		while( k < group1.end || l < group2.end ) {
+			if( l >= group2.end || ( k < group1.end && before.m_entries[k].key < after.m_entries[l].key ) ) {
+				addChange( result, DzPropertyChange::Removed, &before, k++, NULL, 0, maxChanges );
+			} else if( k >= group1.end || after.m_entries[l].key < before.m_entries[k].key ) {
+				addChange( result, DzPropertyChange::Added, NULL, 0, &after, l++, maxChanges );
+			} else {
+				const Entry &entry1 = before.m_entries[k];
+				const Entry &entry2 = after.m_entries[l];
+				if( entry1.bits != entry2.bits || entry1.numKeys != entry2.numKeys || entry1.kind != entry2.kind ) {
+					addChange( result, DzPropertyChange::Changed, &before, k, &after, l, maxChanges );
+				}
+				k++;
+				l++;
+			}
+		}
+	}
+	return result;
+}
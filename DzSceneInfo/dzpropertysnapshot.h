@@ -0,0 +1,141 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_PROPERTY_SNAPSHOT_H
+#define DAZ_PROPERTY_SNAPSHOT_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+/****************************
+   Forward declarations
+****************************/
+class DzElement;
+class DzNode;
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	A property that differs between two snapshots
+**/
+struct DzPropertyChange {
+	enum Kind { Changed, Added, Removed };
+
+	Kind	kind;
+	QString	group;
+	QString	name;
+	QString	oldValue;		// Empty for added properties
+	QString	newValue;		// Empty for removed properties
+	int		oldKeys;
+	int		newKeys;
+
+	DzPropertyChange() : kind( Changed ), oldKeys( 0 ), newKeys( 0 ) {}
+};
+
+/**
+	The differences between two snapshots. Only the first changes found are
+	kept, but all of them are counted.
+**/
+struct DzPropertyDiff {
+	int						numChanged;
+	int						numAdded;
+	int						numRemoved;
+	int						numGroups;
+	int						numGroupsSkipped;	// Groups whose hashes matched
+	QList<DzPropertyChange>	changes;			// In group and property key order
+
+	DzPropertyDiff() : numChanged( 0 ), numAdded( 0 ), numRemoved( 0 ),
+		numGroups( 0 ), numGroupsSkipped( 0 ) {}
+
+	int		getNumChanges() const { return numChanged + numAdded + numRemoved; }
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	The values of every public and private property of a node, its bones if
+	it is a figure, and the modifiers on its object.
+
+	Each element is a group. A property is stored as a 64-bit key hashed from
+	its name, its value as raw bits and its key count; the entries of a group
+	are contiguous and sorted by key, and the groups are sorted by the key of
+	their name, so a diff is a merge of two sorted arrays. Each group also
+	keeps a hash of its entries, and groups whose hash and size match are
+	skipped without looking at their entries.
+
+	Properties are read on the GUI thread, since reading a value can evaluate
+	its controllers. Text and image properties are compared by a hash of
+	their value.
+**/
+class DzPropertySnapshot {
+public:
+	enum ValueKind { Number, Color, Text };
+
+	DzPropertySnapshot() : m_node( NULL ), m_captureNsecs( 0 ) {}
+
+	void	capture( DzNode *node );
+	void	clear();
+
+	static DzPropertyDiff	diff( const DzPropertySnapshot &before, const DzPropertySnapshot &after,
+								int maxChanges );
+
+	bool	isEmpty() const { return m_node == NULL; }
+	DzNode*	getNode() const { return m_node; }
+	int		getNumGroups() const { return m_groups.count(); }
+	int		getNumProperties() const { return m_entries.count(); }
+	qint64	getCaptureNsecs() const { return m_captureNsecs; }
+	qint64	getBytes() const;
+
+private:
+	struct Entry {
+		quint64	key;
+		quint64	bits;		// The double value, the color, or a hash of the text
+		qint32	numKeys;
+		qint32	kind;
+		qint32	group;		// Index in m_groups
+	};
+	struct Group {
+		quint64	key;
+		quint64	hash;		// Of the keys, values and key counts
+		int		begin;
+		int		end;
+	};
+
+	static QString	formatValue( const Entry &entry );
+	static void		addChange( DzPropertyDiff &result, DzPropertyChange::Kind kind,
+						const DzPropertySnapshot *before, int beforeEntry,
+						const DzPropertySnapshot *after, int afterEntry, int maxChanges );
+	static void		addGroupChanges( DzPropertyDiff &result, DzPropertyChange::Kind kind,
+						const DzPropertySnapshot &snapshot, int group, int maxChanges );
+
+	void	addGroup( DzElement *element, const QString &name );
+
+	DzNode				*m_node;
+	QVector<Group>		m_groups;
+	QVector<Entry>		m_entries;
+	QVector<QString>	m_groupNames;		// Parallel to m_groups
+	QVector<QString>	m_names;			// Parallel to m_entries
+	qint64				m_captureNsecs;
+};
+
+#endif // DAZ_PROPERTY_SNAPSHOT_H
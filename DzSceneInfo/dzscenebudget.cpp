@@ -0,0 +1,305 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzscenebudget.h"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QSet>
+#include <QtCore/QSettings>
+#include <QtCore/QUrl>
+#include <QtGui/QDesktopServices>
+
+#include "dzassetgraph.h"
+#include "dzmaterial.h"
+#include "dznode.h"
+#include "dzscene.h"
+#include "dzscenetree.h"
+
+// Keys in the settings file, in Metric order
+static const char *const c_keys[DzSceneBudget::NumMetrics] = {
+	"TotalVertices",
+	"TotalFacets",
+	"FigureFacets",
+	"Lights",
+	"Materials",
+	"Textures",
+	"TextureMB"
+};
+
+/**
+ **/
+DzSceneBudget::DzSceneBudget() :
+	m_loaded( false ),
+	m_numChecked( 0 )
+{
+	for( int i = 0; i < NumMetrics; i++ ) {
+		m_limits[i] = 0;
+		m_values[i] = 0;
+		m_status[i] = Off;
+	}
+}
+
+/**
+ **/
+QString DzSceneBudget::getMetricName( int metric ) {
+	switch( metric ) {
+	case TotalVertices:		return "Total Vertices";
+	case TotalFacets:		return "Total Faces";
+	case FigureFacets:		return "Faces per Figure";
+	case Lights:			return "Lights";
+	case Materials:			return "Materials";
+	case Textures:			return "Texture Files";
+	case TextureMB:			return "Texture MB";
+	default:				return "Unknown";
+	}
+}
+
+/**
+ **/
+QString DzSceneBudget::getStatusName( Status status ) {
+	switch( status ) {
+	case Pass:		return "PASS";
+	case Warn:		return "WARN";
+	case Fail:		return "FAIL";
+	default:		return "OFF";
+	}
+}
+
+/**
+ **/
+QString DzSceneBudget::getSettingsPath() {
+	return QDesktopServices::storageLocation( QDesktopServices::DataLocation ) +
+		"/SceneInfoEx/budgets.ini";
+}
+
+/**
+	The folder of the scene file
+**/
+QString DzSceneBudget::getProjectKey() {
+	QString fileName = dzScene->getFilename();
+	if( fileName.isEmpty() ) {
+		return "Default";
+	}
+	return QFileInfo( fileName ).absolutePath();
+}
+
+/**
+	Settings groups are nested at slashes, so the folder is encoded
+**/
+QString DzSceneBudget::getGroupName( const QString &project ) {
+	return QString( QUrl::toPercentEncoding( project ) );
+}
+
+/**
+	Drop the recorded inputs so that the next evaluate() recomputes every
+	metric. The limits are kept.
+**/
+void DzSceneBudget::clear() {
+	m_inputs = Inputs();
+	m_textureSizes.clear();
+	m_numChecked = 0;
+}
+
+/**
+ **/
+void DzSceneBudget::loadLimits( const QString &project ) {
+	QSettings settings( getSettingsPath(), QSettings::IniFormat );
+	settings.beginGroup( getGroupName( project ) );
+	for( int i = 0; i < NumMetrics; i++ ) {
+		m_limits[i] = settings.value( c_keys[i], 0 ).toLongLong();
+		updateStatus( i );
+	}
+	settings.endGroup();
+
+	m_project = project;
+	m_loaded = true;
+}
+
+/**
+ **/
+void DzSceneBudget::saveLimits() const {
+	QSettings settings( getSettingsPath(), QSettings::IniFormat );
+	settings.beginGroup( getGroupName( m_project ) );
+	for( int i = 0; i < NumMetrics; i++ ) {
+		if( m_limits[i] > 0 ) {
+			settings.setValue( c_keys[i], m_limits[i] );
+		} else {
+			settings.remove( c_keys[i] );
+		}
+	}
+	settings.endGroup();
+}
+
+/**
+	Only this metric's status is re-derived; its value is unchanged
+**/
+void DzSceneBudget::setLimit( int metric, qint64 limit ) {
+	if( !m_loaded ) {
+		loadLimits( getProjectKey() );
+	}
+	m_limits[metric] = qMax( limit, Q_INT64_C( 0 ) );
+	updateStatus( metric );
+	saveLimits();
+}
+
+/**
+ **/
+void DzSceneBudget::setValue( int metric, qint64 value ) {
+	m_values[metric] = value;
+	updateStatus( metric );
+	m_numChecked++;
+}
+
+/**
+ **/
+void DzSceneBudget::updateStatus( int metric ) {
+	qint64 limit = m_limits[metric];
+	qint64 value = m_values[metric];
+	if( limit <= 0 ) {
+		m_status[metric] = Off;
+	} else if( value > limit ) {
+		m_status[metric] = Fail;
+	} else if( value > limit * getWarnFraction() ) {
+		m_status[metric] = Warn;
+	} else {
+		m_status[metric] = Pass;
+	}
+}
+
+/**
+ **/
+DzSceneBudget::Status DzSceneBudget::getWorstStatus() const {
+	Status worst = Off;
+	for( int i = 0; i < NumMetrics; i++ ) {
+		worst = qMax( worst, m_status[i] );
+	}
+	return worst;
+}
+
+/**
+	tree should have been synced with the scene
+**/
+void DzSceneBudget::evaluate( const DzSceneTree &tree ) {
+	m_numChecked = 0;
+
+  // A scene saved to another folder changes the project
+	QString project = getProjectKey();
+	if( !m_loaded || project != m_project ) {
+		loadLimits( project );
+	}
+
+	Inputs inputs;
+	inputs.numNodes = dzScene->getNumNodes();
+	inputs.numVerts = tree.getTotals().numVerts;
+	inputs.numFacets = tree.getTotals().getNumFacets();
+	inputs.numLights = dzScene->getNumLights();
+	inputs.numMaterials = DzMaterial::getNumMaterials();
+
+	if( inputs.numVerts != m_inputs.numVerts ) {
+		setValue( TotalVertices, inputs.numVerts );
+	}
+	if( inputs.numFacets != m_inputs.numFacets ) {
+		setValue( TotalFacets, inputs.numFacets );
+	}
+	if( inputs.numLights != m_inputs.numLights ) {
+		setValue( Lights, inputs.numLights );
+	}
+	if( inputs.numMaterials != m_inputs.numMaterials ) {
+		setValue( Materials, inputs.numMaterials );
+	}
+
+  // The figure sums follow the geometry and the node list
+	if( inputs.numNodes != m_inputs.numNodes ||
+		inputs.numVerts != m_inputs.numVerts ||
+		inputs.numFacets != m_inputs.numFacets ) {
+		computeFigures( tree );
+	}
+
+  // Textures follow the materials; a map swapped on an existing material
+  // is picked up on the next change to the node list, or after clear()
+	if( inputs.numNodes != m_inputs.numNodes ||
+		inputs.numMaterials != m_inputs.numMaterials ) {
+		computeTextures();
+	}
+
+	m_inputs = inputs;
+}
+
+/**
+	The largest figure by faces, summed over the figure and its bones the same
+	way as the Primary Selection section
+**/
+void DzSceneBudget::computeFigures( const DzSceneTree &tree ) {
+	qint64 largest = 0;
+	QString label;
+
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		if( !node->inherits( "DzSkeleton" ) ) {
+			continue;
+		}
+
+		DzGeomStats total = tree.getFigureTotals( node );
+		if( total.getNumFacets() > largest || label.isEmpty() ) {
+			largest = total.getNumFacets();
+			label = node->getLabel();
+		}
+	}
+
+	m_details[FigureFacets] = label;
+	setValue( FigureFacets, largest );
+}
+
+/**
+	The distinct texture files used by the materials, mapped properties
+	included. A file is stat'ed the first time it is seen.
+**/
+void DzSceneBudget::computeTextures() {
+	QSet<QString> files;
+	DzMaterial *material = NULL;
+	for( int i = 0, n = DzMaterial::getNumMaterials(); i < n; i++ ) {
+		material = DzMaterial::getMaterial( i );
+		if( material ) {
+			DzAssetGraph::getMaterialTextures( material, files );
+		}
+	}
+
+	qint64 totalBytes = 0;
+	int numMissing = 0;
+	QSet<QString>::const_iterator it;
+	for( it = files.constBegin(); it != files.constEnd(); ++it ) {
+		QHash<QString, qint64>::const_iterator size = m_textureSizes.constFind( *it );
+		if( size == m_textureSizes.constEnd() ) {
+			QFileInfo info( *it );
+			size = m_textureSizes.insert( *it, info.exists() ? info.size() : -1 );
+		}
+		if( size.value() < 0 ) {
+			numMissing++;
+		} else {
+			totalBytes += size.value();
+		}
+	}
+
+	m_details[Textures] = numMissing > 0 ? QString( "%1 missing" ).arg( numMissing ) : QString();
+	setValue( Textures, files.count() );
+	setValue( TextureMB, ( totalBytes + 1024 * 1024 - 1 ) / ( 1024 * 1024 ) );
+}
@@ -0,0 +1,122 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_SCENE_BUDGET_H
+#define DAZ_SCENE_BUDGET_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+/****************************
+   Forward declarations
+****************************/
+class DzSceneTree;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Limits on the scene's complexity, checked against the pane's statistics.
+
+	A metric passes below getWarnFraction() of its limit, warns up to the
+	limit and fails above it; a limit of 0 turns the check off. The limits
+	are stored per project, which is the folder of the current scene file,
+	in SceneInfoEx/budgets.ini under the application data folder. Unsaved
+	scenes use the "Default" project.
+
+	evaluate() first reads the cheap inputs : the scene tree totals and the
+	node, light and material counts. Only the metrics whose inputs changed
+	are recomputed, so the per-figure sums and the texture files are only
+	walked after the scene changed, and texture files are only stat'ed the
+	first time they are seen.
+**/
+class DzSceneBudget {
+public:
+	enum Metric {
+		TotalVertices,
+		TotalFacets,
+		FigureFacets,		// Largest figure, bones included
+		Lights,
+		Materials,
+		Textures,
+		TextureMB,			// Distinct texture files on disk
+		NumMetrics
+	};
+
+	enum Status {
+		Off,
+		Pass,
+		Warn,
+		Fail
+	};
+
+	DzSceneBudget();
+
+	static QString	getMetricName( int metric );
+	static QString	getStatusName( Status status );
+	static double	getWarnFraction() { return 0.9; }
+
+	void	evaluate( const DzSceneTree &tree );
+	void	clear();
+
+	qint64	getLimit( int metric ) const { return m_limits[metric]; }
+	void	setLimit( int metric, qint64 limit );
+
+	const QString&	getProject() const { return m_project; }		// Scene folder, or "Default"
+	Status			getStatus( int metric ) const { return m_status[metric]; }
+	Status			getWorstStatus() const;
+	qint64			getValue( int metric ) const { return m_values[metric]; }
+	const QString&	getDetail( int metric ) const { return m_details[metric]; }
+	int				getNumChecked() const { return m_numChecked; }		// Metrics recomputed by the last evaluate()
+
+private:
+	struct Inputs {
+		int		numNodes;
+		int		numVerts;
+		int		numFacets;
+		int		numLights;
+		int		numMaterials;
+
+		Inputs() : numNodes( -1 ), numVerts( -1 ), numFacets( -1 ), numLights( -1 ), numMaterials( -1 ) {}
+	};
+
+	static QString	getSettingsPath();
+	static QString	getProjectKey();
+	static QString	getGroupName( const QString &project );
+
+	void	loadLimits( const QString &project );
+	void	saveLimits() const;
+	void	setValue( int metric, qint64 value );
+	void	updateStatus( int metric );
+	void	computeFigures( const DzSceneTree &tree );
+	void	computeTextures();
+
+	QString					m_project;
+	bool					m_loaded;
+	qint64					m_limits[NumMetrics];
+	qint64					m_values[NumMetrics];
+	QString					m_details[NumMetrics];
+	Status					m_status[NumMetrics];
+	Inputs					m_inputs;			// As of the last evaluate()
+	QHash<QString, qint64>	m_textureSizes;		// Bytes per texture file, -1 if missing
+	int						m_numChecked;
+};
+
+#endif // DAZ_SCENE_BUDGET_H
@@ -0,0 +1,199 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzscenestats.h"
+
+#include "dzcamera.h"
+#include "dzlight.h"
+#include "dzmaterial.h"
+#include "dznode.h"
+#include "dzscene.h"
+#include "dztexture.h"
+
+/**
+	The geometry counts as a map
+**/
+static QVariantMap geomStatsToMap( const DzGeomStats &stats ) {
+	QVariantMap map;
+	map["vertices"] = stats.numVerts;
+	map["triangles"] = stats.numTris;
+	map["quads"] = stats.numQuads;
+	map["faces"] = stats.getNumFacets();
+	map["materials"] = stats.numMaterials;
+	map["strands"] = stats.numStrands;
+	map["segments"] = stats.numSegments;
+	map["controlPoints"] = stats.numControlPoints;
+	map["tessellatedPrimitives"] = stats.numTessPrims;
+	return map;
+}
+
+/**
+ **/
+static QString getTextureFile( DzTexture *texture ) {
+	return texture ? texture->getFilename() : QString();
+}
+
+/**
+ **/
+DzSceneInfoStats::DzSceneInfoStats() {
+  // Nodes are about to be deleted, so drop the cached stats
+	connect( dzScene, SIGNAL(sceneClearStarting()), this, SLOT(invalidate()) );
+	connect( dzScene, SIGNAL(sceneLoadStarting()), this, SLOT(invalidate()) );
+}
+
+/**
+ **/
+void DzSceneInfoStats::invalidate() {
+	m_tree.clear();
+}
+
+/**
+ **/
+void DzSceneInfoStats::sync() {
+	m_tree.sync();
+}
+
+/**
+	Returns a map with an entry for each of the requested sections : "scene",
+	"nodes", "selected" and "materials"
+**/
+QVariantMap DzSceneInfoStats::getStats( const QStringList &sections ) {
+	QVariantMap map;
+	if( sections.contains( "scene" ) ) {
+		map["scene"] = getSceneInfo();
+	}
+	if( sections.contains( "nodes" ) ) {
+		map["nodes"] = getNodes();
+	}
+	if( sections.contains( "selected" ) ) {
+		map["selected"] = getSelectedNode();
+	}
+	if( sections.contains( "materials" ) ) {
+		map["materials"] = getMaterials();
+	}
+	return map;
+}
+
+/**
+	The scene item counts and the geometry totals, with the totals of the
+	nodes visible in render under "renderVisible"
+**/
+QVariantMap DzSceneInfoStats::getSceneInfo() {
+	sync();
+
+	QVariantMap map = geomStatsToMap( m_tree.getTotals() );
+	map["nodes"] = dzScene->getNumNodes();
+	map["lights"] = dzScene->getNumLights();
+	map["cameras"] = dzScene->getNumCameras();
+	map["wsModifiers"] = dzScene->getNumWSModifiers();
+	map["estimatedBytes"] = m_tree.getTotals().getEstimatedBytes();
+	map["renderVisible"] = geomStatsToMap( m_tree.getVisibleTotals() );
+	return map;
+}
+
+/**
+	One map per node, in scene order, with the node's own and subtree counts.
+	The id is the node's element ID, which is not reused for another node.
+**/
+QVariantList DzSceneInfoStats::getNodes() {
+	sync();
+
+	QVariantList list;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		const DzSceneTree::Item *item = m_tree.getItem( node );
+
+		QVariantMap map = geomStatsToMap( item ? item->own : DzGeomStats() );
+		map["id"] = (qulonglong)node->getElementID();
+		map["name"] = node->objectName();
+		map["label"] = node->getLabel();
+		map["className"] = QString( node->className() );
+		map["filePath"] = node->getAssetFileInfo().getUri().getFilePath();
+		map["parent"] = item && item->parent ? item->parent->getLabel() : QString();
+		map["subtree"] = geomStatsToMap( item ? item->subtree : DzGeomStats() );
+		list.append( map );
+	}
+	return list;
+}
+
+/**
+	Same numbers as the Primary Selection section of the pane. For a figure the
+	counts include all of its bones.
+**/
+QVariantMap DzSceneInfoStats::getNodeInfo( DzNode *node ) {
+	QVariantMap map;
+	if( node == NULL ) {
+		return map;
+	}
+	sync();
+
+	DzGeomStats total = m_tree.getFigureTotals( node );
+	const DzSceneTree::Item *item = m_tree.getItem( node );
+
+	map = geomStatsToMap( total );
+	map["name"] = node->objectName();
+	map["label"] = node->getLabel();
+	map["className"] = QString( node->className() );
+	map["assetId"] = node->getAssetId();
+	map["assetType"] = node->getAssetType();
+	map["dataItems"] = node->getNumDataItems();
+	map["elementChildren"] = node->getNumElementChildren();
+	map["nodeChildren"] = node->getNumNodeChildren();
+	map["properties"] = node->getNumProperties();
+	map["privateProperties"] = node->getNumPrivateProperties();
+	map["source"] = node->getSource().getFilePath();
+	map["filePath"] = node->getAssetFileInfo().getUri().getFilePath();
+	map["subtree"] = geomStatsToMap( item ? item->subtree : total );
+	return map;
+}
+
+/**
+	Returns an empty map if nothing is selected
+**/
+QVariantMap DzSceneInfoStats::getSelectedNode() {
+	return getNodeInfo( dzScene->getPrimarySelection() );
+}
+
+/**
+	One map per material, with its texture files and diffuse color
+**/
+QVariantList DzSceneInfoStats::getMaterials() {
+	QVariantList list;
+	DzMaterial *material = NULL;
+	for( int i = 0, n = DzMaterial::getNumMaterials(); i < n; i++ ) {
+		material = DzMaterial::getMaterial( i );
+		if( material == NULL ) {
+			continue;
+		}
+
+		QVariantMap map;
+		map["name"] = material->getName();
+		map["index"] = material->getIndex();
+		map["className"] = QString( material->className() );
+		map["colorMap"] = getTextureFile( material->getColorMap() );
+		map["opacityMap"] = getTextureFile( material->getOpacityMap() );
+		map["bakedMap"] = getTextureFile( material->getBakedMap() );
+		map["diffuseColor"] = material->getDiffuseColor().name();
+		list.append( map );
+	}
+	return list;
+}
@@ -0,0 +1,74 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_SCENE_STATS_H
+#define DAZ_SCENE_STATS_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+
+#include "dzscenetree.h"
+
+/****************************
+   Forward declarations
+****************************/
+class DzNode;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Script access to the scene statistics shown by the pane, as maps and lists
+	instead of HTML.
+
+	Each section is computed only when it is asked for. The geometry counts come
+	from a DzSceneTree that is brought up to date incrementally on each call, so
+	repeated queries against the same scene only rescan what changed.
+
+	From DAZ Script:
+	@code
+	var oStats = new DzSceneInfoStats();
+	var oScene = oStats.getSceneInfo();
+	print( oScene.vertices, oScene.faces );
+	@endcode
+**/
+class DzSceneInfoStats : public QObject {
+	Q_OBJECT
+public:
+	DzSceneInfoStats();
+
+public slots:
+
+	QVariantMap		getStats( const QStringList &sections );
+	QVariantMap		getSceneInfo();
+	QVariantList	getNodes();
+	QVariantMap		getNodeInfo( DzNode *node );
+	QVariantMap		getSelectedNode();
+	QVariantList	getMaterials();
+	void			invalidate();
+
+private:
+	void			sync();
+
+	DzSceneTree		m_tree;
+};
+
+#endif // DAZ_SCENE_STATS_H
@@ -0,0 +1,493 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzscenetree.h"
+
+#include <QtCore/QSet>
+
+#include "dzbone.h"
+#include "dzfacegroup.h"
+#include "dzfacetmesh.h"
+#include "dzgeomcounter.h"
+#include "dzobject.h"
+#include "dzscene.h"
+#include "dzshape.h"
+#include "dzskeleton.h"
+#include "dzstatscache.h"
+
+// Estimated memory of a vertex (position and normal)
+static const int c_vertexBytes = 2 * sizeof(DzPnt3);
+
+/*****************************
+DzGeomStats
+*****************************/
+
+/**
+	Rough memory used by the vertex and facet arrays
+**/
+qint64 DzGeomStats::getEstimatedBytes() const {
+	return (qint64)numVerts * c_vertexBytes + (qint64)getNumFacets() * sizeof(DzFacet);
+}
+
+/**
+ **/
+DzGeomStats& DzGeomStats::operator+=( const DzGeomStats &other ) {
+	numVerts += other.numVerts;
+	numTris += other.numTris;
+	numQuads += other.numQuads;
+	numMaterials += other.numMaterials;
+	numStrands += other.numStrands;
+	numSegments += other.numSegments;
+	numControlPoints += other.numControlPoints;
+	numTessPrims += other.numTessPrims;
+	return *this;
+}
+
+/**
+ **/
+DzGeomStats& DzGeomStats::operator-=( const DzGeomStats &other ) {
+	numVerts -= other.numVerts;
+	numTris -= other.numTris;
+	numQuads -= other.numQuads;
+	numMaterials -= other.numMaterials;
+	numStrands -= other.numStrands;
+	numSegments -= other.numSegments;
+	numControlPoints -= other.numControlPoints;
+	numTessPrims -= other.numTessPrims;
+	return *this;
+}
+
+/**
+ **/
+DzGeomStats DzGeomStats::operator-( const DzGeomStats &other ) const {
+	DzGeomStats result = *this;
+	result -= other;
+	return result;
+}
+
+/*****************************
+DzSceneTree
+*****************************/
+
+/**
+ **/
+void DzSceneTree::getNodeInfo( const DzNode *node, DzGeomStats &stats ) {
+  // Collect information about the node's geometry
+	DzObject	*obj = node->getObject();
+	DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
+	DzGeometry	*geom = shape ? shape->getGeometry() : NULL;
+	stats = DzGeomStats();
+
+	if( shape == NULL || geom == NULL ) {
+		return;	// No geometry for the node
+	}
+
+	stats.numVerts = geom->getNumVertices();
+	stats.numMaterials = shape->getNumMaterials();
+
+  // Facets, strands, ... depending on the type of geometry
+	DzGeomCounters::count( geom, stats );
+}
+
+/**
+	Returns true if the node itself is shown in renders; the ancestors are
+	not checked
+**/
+bool DzSceneTree::isRenderVisible( const DzNode *node ) {
+	return node->isVisible() && node->isVisibleInRender();
+}
+
+/**
+	Compute the node's own stats, and remember what they were computed from
+**/
+void DzSceneTree::scanNode( DzNode *node, Item &item ) {
+	DzObject	*obj = node->getObject();
+	DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
+	DzGeometry	*geom = shape ? shape->getGeometry() : NULL;
+	DzFacetMesh	*mesh = qobject_cast<DzFacetMesh*>( geom );
+	item.geom = geom;
+	item.geomVerts = geom ? geom->getNumVertices() : 0;
+	item.geomFacets = mesh ? mesh->getNumFacets() : 0;
+	item.geomMaterials = shape ? shape->getNumMaterials() : 0;
+
+	if( m_cache == NULL || geom == NULL ) {
+		getNodeInfo( node, item.own );
+		return;
+	}
+
+  // Use the stored stats if the asset and its geometry are unchanged
+	DzStatsCache::Entry entry;
+	if( m_cache->find( node, entry ) &&
+		entry.matches( item.geomVerts, item.geomFacets, item.geomMaterials ) ) {
+		item.own = entry.stats;
+		return;
+	}
+
+	getNodeInfo( node, item.own );
+	entry = DzStatsCache::Entry();
+	entry.stats = item.own;
+	entry.geomVerts = item.geomVerts;
+	entry.geomFacets = item.geomFacets;
+	entry.geomMaterials = item.geomMaterials;
+	m_cache->insert( node, entry );
+}
+
+/**
+	Cheap check for a node whose geometry changed since it was scanned
+**/
+bool DzSceneTree::isStale( DzNode *node, const Item &item ) const {
+	DzObject	*obj = node->getObject();
+	DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
+	DzGeometry	*geom = shape ? shape->getGeometry() : NULL;
+	if( geom != item.geom ) {
+		return true;
+	}
+	if( geom == NULL ) {
+		return false;
+	}
+
+	DzFacetMesh	*mesh = qobject_cast<DzFacetMesh*>( geom );
+	return geom->getNumVertices() != item.geomVerts ||
+		( mesh ? mesh->getNumFacets() : 0 ) != item.geomFacets ||
+		shape->getNumMaterials() != item.geomMaterials;
+}
+
+/**
+	Add or subtract delta from the subtree stats of from and all its ancestors
+**/
+void DzSceneTree::propagate( DzNode *from, const DzGeomStats &delta, bool add ) {
+	DzNode *node = from;
+	while( node ) {
+		QHash<const DzNode*, Item>::iterator it = m_items.find( node );
+		if( it == m_items.end() ) {
+			break;
+		}
+		if( add ) {
+			it->subtree += delta;
+		} else {
+			it->subtree -= delta;
+		}
+		node = it->parent;
+	}
+}
+
+/**
+ **/
+void DzSceneTree::clear() {
+	m_items.clear();
+	m_totals = DzGeomStats();
+	m_visibleTotals = DzGeomStats();
+}
+
+/**
+ **/
+void DzSceneTree::rebuild() {
+	clear();
+
+  // Scan every node once
+	QList<DzNode*> nodes;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		Item &item = m_items[node];
+		scanNode( node, item );
+		m_totals += item.own;
+		nodes.append( node );
+	}
+
+  // Order the nodes parents first, starting from the roots
+	QList<DzNode*> order;
+	QList<DzNode*> stack;
+	for( int i = 0; i < nodes.count(); i++ ) {
+		DzNode *parent = nodes[i]->getNodeParent();
+		if( parent == NULL || !m_items.contains( parent ) ) {
+			stack.append( nodes[i] );
+		}
+	}
+	while( !stack.isEmpty() ) {
+		node = stack.takeLast();
+		order.append( node );
+		for( int i = 0, n = node->getNumNodeChildren(); i < n; i++ ) {
+			DzNode *child = node->getNodeChild( i );
+			QHash<const DzNode*, Item>::iterator it = m_items.find( child );
+			if( it != m_items.end() ) {
+				it->parent = node;
+				stack.append( child );
+			}
+		}
+	}
+
+  // Post-order aggregation : walking the order backwards visits every child
+  // before its parent
+	for( int i = order.count() - 1; i >= 0; i-- ) {
+		Item &item = m_items[order[i]];
+		item.subtree += item.own;
+		if( item.parent ) {
+			m_items[item.parent].subtree += item.subtree;
+		}
+	}
+
+  // Parents first, so each node can inherit its parent's visibility
+	for( int i = 0; i < order.count(); i++ ) {
+		Item &item = m_items[order[i]];
+		item.visible = isRenderVisible( order[i] ) &&
+			( item.parent == NULL || m_items[item.parent].visible );
+		if( item.visible ) {
+			m_visibleTotals += item.own;
+		}
+	}
+	syncHiddenParts( order );
+}
+
+/**
+ **/
+void DzSceneTree::sync() {
+	if( m_items.isEmpty() ) {
+		rebuild();
+		return;
+	}
+
+	QList<DzNode*> nodes;
+	QSet<const DzNode*> present;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		nodes.append( node );
+		present.insert( node );
+	}
+
+  // Removed nodes take their whole subtree out of their ancestors' totals;
+  // any surviving children are detached and re-attached below
+	QList<const DzNode*> removed;
+	QHash<const DzNode*, Item>::iterator it;
+	for( it = m_items.begin(); it != m_items.end(); ++it ) {
+		if( !present.contains( it.key() ) ) {
+			removed.append( it.key() );
+		}
+	}
+	for( int i = 0; i < removed.count(); i++ ) {
+		Item item = m_items.take( removed[i] );
+		propagate( item.parent, item.subtree, false );
+		m_totals -= item.own;
+		if( item.visible ) {
+			m_visibleTotals -= item.own - item.hidden;
+		}
+	}
+	if( !removed.isEmpty() ) {
+		for( it = m_items.begin(); it != m_items.end(); ++it ) {
+			if( it->parent && !m_items.contains( it->parent ) ) {
+				it->parent = NULL;
+			}
+		}
+	}
+
+  // Added nodes start out detached
+	for( int i = 0; i < nodes.count(); i++ ) {
+		node = nodes[i];
+		if( !m_items.contains( node ) ) {
+			Item &item = m_items[node];
+			scanNode( node, item );
+			item.subtree = item.own;
+			m_totals += item.own;
+		}
+	}
+
+  // Re-attach nodes whose parent changed, and rescan nodes whose geometry changed
+	for( int i = 0; i < nodes.count(); i++ ) {
+		node = nodes[i];
+		Item &item = m_items[node];
+
+		DzNode *parent = node->getNodeParent();
+		if( parent && !m_items.contains( parent ) ) {
+			parent = NULL;
+		}
+		if( parent != item.parent ) {
+			propagate( item.parent, item.subtree, false );
+			item.parent = parent;
+			propagate( item.parent, item.subtree, true );
+		}
+
+		if( isStale( node, item ) ) {
+			updateNode( node );
+		}
+	}
+
+	syncVisibility( nodes );
+}
+
+/**
+	Recompute the visibility of every node, and move the nodes whose visibility
+	changed in or out of the visible totals
+**/
+void DzSceneTree::syncVisibility( const QList<DzNode*> &nodes ) {
+	QHash<const DzNode*, bool> resolved;
+	QList<DzNode*> chain;
+	for( int i = 0; i < nodes.count(); i++ ) {
+	  // Walk up to a resolved ancestor or a root, then resolve back down
+		DzNode *node = nodes[i];
+		while( node && !resolved.contains( node ) ) {
+			chain.append( node );
+			node = m_items[node].parent;
+		}
+		bool visible = node ? resolved[node] : true;
+		while( !chain.isEmpty() ) {
+			node = chain.takeLast();
+			Item &item = m_items[node];
+			visible = visible && isRenderVisible( node );
+			resolved.insert( node, visible );
+
+			if( visible != item.visible ) {
+				item.visible = visible;
+				if( visible ) {
+					m_visibleTotals += item.own - item.hidden;
+				} else {
+					m_visibleTotals -= item.own - item.hidden;
+				}
+			}
+		}
+	}
+	syncHiddenParts( nodes );
+}
+
+/**
+	Recount the hidden parts of each figure among the nodes. Bones have their
+	visibility resolved already; a bone is hidden when it or a bone above it
+	is hidden while the figure itself is visible.
+**/
+void DzSceneTree::syncHiddenParts( const QList<DzNode*> &nodes ) {
+	for( int i = 0; i < nodes.count(); i++ ) {
+		DzSkeleton *skeleton = qobject_cast<DzSkeleton*>( nodes[i] );
+		if( skeleton == NULL ) {
+			continue;
+		}
+		Item &item = m_items[skeleton];
+
+		DzGeomStats hidden;
+		DzObject	*obj = skeleton->getObject();
+		DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
+		DzFacetMesh	*mesh = shape ? qobject_cast<DzFacetMesh*>( shape->getGeometry() ) : NULL;
+		if( mesh && item.visible ) {
+			const DzFacet *facets = mesh->getFacetsPtr();
+			int numFacets = mesh->getNumFacets();
+			DzBoneList bones;
+			skeleton->getAllBones( bones );
+			for( int j = 0, n = bones.count(); j < n; j++ ) {
+				const Item *bone = getItem( bones[j] );
+				DzFaceGroup *group = bone && !bone->visible ? mesh->findFaceGroup( bones[j]->getName() ) : NULL;
+				if( group == NULL ) {
+					continue;
+				}
+				const int *indices = group->getIndicesPtr();
+				for( int k = 0, m = group->count(); k < m; k++ ) {
+					if( indices[k] < 0 || indices[k] >= numFacets ) {
+						continue;
+					}
+					if( facets[indices[k]].isQuad() ) {
+						hidden.numQuads++;
+					} else {
+						hidden.numTris++;
+					}
+				}
+			}
+		}
+
+		if( item.visible ) {
+			m_visibleTotals += item.hidden;
+			m_visibleTotals -= hidden;
+		}
+		item.hidden = hidden;
+	}
+}
+
+/**
+	Rescan a single node and adjust only it and its ancestors
+**/
+void DzSceneTree::updateNode( DzNode *node ) {
+	QHash<const DzNode*, Item>::iterator it = m_items.find( node );
+	if( it == m_items.end() ) {
+		return;
+	}
+
+	DzGeomStats old = it->own;
+	scanNode( node, *it );
+	DzGeomStats delta = it->own - old;
+	m_totals += delta;
+	if( it->visible ) {
+		m_visibleTotals += delta;
+	}
+	propagate( node, delta, true );
+}
+
+/**
+ **/
+const DzSceneTree::Item* DzSceneTree::getItem( const DzNode *node ) const {
+	QHash<const DzNode*, Item>::const_iterator it = m_items.find( node );
+	return it != m_items.end() ? &it.value() : NULL;
+}
+
+/**
+	The node's own stats and, for a figure, those of all its bones, as the
+	Primary Selection section shows them. Nodes the tree does not hold are
+	scanned.
+**/
+DzGeomStats DzSceneTree::getFigureTotals( const DzNode *node ) const {
+	DzGeomStats total;
+	const Item *item = getItem( node );
+	if( item ) {
+		total = item->own;
+	} else {
+		getNodeInfo( node, total );
+	}
+
+	if( node->inherits( "DzSkeleton" ) ) {
+		DzBoneList bones;
+		DzGeomStats stats;
+		((DzSkeleton*)node)->getAllBones( bones );
+		for( int i = 0, n = bones.count(); i < n; i++ ) {
+			item = getItem( bones[i] );
+			if( item ) {
+				stats = item->own;
+			} else {
+				getNodeInfo( bones[i], stats );
+			}
+			total += stats;
+		}
+	}
+	return total;
+}
+
+/**
+	Returns the nodes without a parent, in scene order
+**/
+QList<DzNode*> DzSceneTree::getRoots() const {
+	QList<DzNode*> roots;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		const Item *item = getItem( node );
+		if( item && item->parent == NULL ) {
+			roots.append( node );
+		}
+	}
+	return roots;
+}
@@ -0,0 +1,140 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_SCENE_TREE_H
+#define DAZ_SCENE_TREE_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+#include <QtCore/QList>
+
+/****************************
+   Forward declarations
+****************************/
+class DzGeometry;
+class DzNode;
+class DzStatsCache;
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	Geometry counts for a node, or summed over several nodes
+**/
+struct DzGeomStats {
+	int		numVerts;
+	int		numTris;
+	int		numQuads;
+	int		numMaterials;
+
+	// Strand and curve geometry
+	int		numStrands;
+	int		numSegments;
+	int		numControlPoints;
+	qint64	numTessPrims;		// Estimated primitives after tessellation
+
+	DzGeomStats() : numVerts( 0 ), numTris( 0 ), numQuads( 0 ), numMaterials( 0 ),
+		numStrands( 0 ), numSegments( 0 ), numControlPoints( 0 ), numTessPrims( 0 ) {}
+
+	int		getNumFacets() const { return numTris + numQuads; }
+	qint64	getEstimatedBytes() const;
+
+	DzGeomStats&	operator+=( const DzGeomStats &other );
+	DzGeomStats&	operator-=( const DzGeomStats &other );
+	DzGeomStats		operator-( const DzGeomStats &other ) const;
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Caches the geometry stats of every node in the scene along with the totals
+	of each node's subtree (the node and all of its node children).
+
+	rebuild() computes the subtree totals in a single post-order pass over the
+	node hierarchy. sync() brings the cache up to date with the scene: only added,
+	removed, re-parented or re-shaped nodes are scanned, and only the ancestors
+	of those nodes have their subtree totals adjusted.
+
+	Alongside the scene totals it keeps the totals of the nodes the renderer will
+	see : visible, visible in render, and with every ancestor visible as well.
+	Visibility is checked on every sync() without touching the geometry; a node
+	whose visibility changed only moves its cached stats in or out of the
+	render-visible totals.
+
+	A figure's geometry belongs to the figure node, not to its bones, so a
+	hidden bone (figure part) removes the facets of the figure's face group
+	of the same name from the render-visible totals. Only facets are taken
+	out; the vertices that a hidden group shares with the rest of the mesh
+	stay counted, so the render-visible vertex count of a partly hidden
+	figure is an upper bound.
+
+	If a DzStatsCache is set, nodes loaded from unchanged asset files take
+	their stats from it instead of being scanned.
+**/
+class DzSceneTree {
+public:
+	struct Item {
+		DzNode				*parent;	// NULL for roots and detached nodes
+		DzGeomStats			own;
+		DzGeomStats			subtree;
+		bool				visible;	// The node and its ancestors are visible in render
+		DzGeomStats			hidden;		// Facets of a figure's hidden parts, out of own
+
+		// The geometry the own stats were computed from
+		const DzGeometry	*geom;
+		int					geomVerts;
+		int					geomFacets;
+		int					geomMaterials;
+
+		Item() : parent( NULL ), visible( false ), geom( NULL ), geomVerts( 0 ), geomFacets( 0 ), geomMaterials( 0 ) {}
+	};
+
+	DzSceneTree() : m_cache( NULL ) {}
+
+	static void		getNodeInfo( const DzNode *node, DzGeomStats &stats );
+	static bool		isRenderVisible( const DzNode *node );
+
+	void			rebuild();
+	void			sync();
+	void			updateNode( DzNode *node );
+	void			clear();
+	void			setStatsCache( DzStatsCache *cache ) { m_cache = cache; }
+
+	bool				isEmpty() const { return m_items.isEmpty(); }
+	const Item*			getItem( const DzNode *node ) const;
+	const DzGeomStats&	getTotals() const { return m_totals; }
+	const DzGeomStats&	getVisibleTotals() const { return m_visibleTotals; }
+	DzGeomStats			getFigureTotals( const DzNode *node ) const;
+	QList<DzNode*>		getRoots() const;
+
+private:
+	void			scanNode( DzNode *node, Item &item );
+	bool			isStale( DzNode *node, const Item &item ) const;
+	void			propagate( DzNode *from, const DzGeomStats &delta, bool add );
+	void			syncVisibility( const QList<DzNode*> &nodes );
+	void			syncHiddenParts( const QList<DzNode*> &nodes );
+
+	QHash<const DzNode*, Item>	m_items;
+	DzGeomStats					m_totals;
+	DzGeomStats					m_visibleTotals;
+	DzStatsCache				*m_cache;
+};
+
+#endif // DAZ_SCENE_TREE_H
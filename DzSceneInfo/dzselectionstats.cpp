@@ -0,0 +1,190 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzselectionstats.h"
+
+#include <QtCore/QSet>
+
+#include "dzbone.h"
+#include "dzfacetmesh.h"
+#include "dzinstancenode.h"
+#include "dzobject.h"
+#include "dzscene.h"
+#include "dzshape.h"
+#include "dzskeleton.h"
+
+/**
+ **/
+static bool sameStats( const DzGeomStats &stats1, const DzGeomStats &stats2 ) {
+	return stats1.numVerts == stats2.numVerts &&
+		stats1.numTris == stats2.numTris &&
+		stats1.numQuads == stats2.numQuads &&
+		stats1.numMaterials == stats2.numMaterials &&
+		stats1.numStrands == stats2.numStrands &&
+		stats1.numSegments == stats2.numSegments &&
+		stats1.numControlPoints == stats2.numControlPoints &&
+		stats1.numTessPrims == stats2.numTessPrims;
+}
+
+/**
+	The geometry and stats a member contributes. An instance uses its target's.
+**/
+void DzSelectionStats::resolve( DzNode *node, const DzSceneTree &tree, Member &member ) {
+	DzNode *source = node;
+	member.instance = false;
+	if( DzInstanceNode *instance = qobject_cast<DzInstanceNode*>( node ) ) {
+		if( instance->getTarget() ) {
+			source = instance->getTarget();
+			member.instance = true;
+		}
+	}
+
+	DzObject	*obj = source->getObject();
+	DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
+	member.geom = shape ? shape->getGeometry() : NULL;
+
+	const DzSceneTree::Item *item = tree.getItem( source );
+	if( item ) {
+		member.stats = item->own;
+	} else {
+		DzSceneTree::getNodeInfo( source, member.stats );
+	}
+}
+
+/**
+ **/
+void DzSelectionStats::addMember( DzNode *node, const Member &member ) {
+	m_members.insert( node, member );
+	m_renderTotals += member.stats;
+	if( member.instance ) {
+		m_numInstances++;
+	}
+	if( member.geom == NULL ) {
+		return;
+	}
+
+	QHash<const DzGeometry*, GeomRef>::iterator it = m_geoms.find( member.geom );
+	if( it == m_geoms.end() ) {
+		GeomRef ref;
+		ref.refs = 1;
+		ref.stats = member.stats;
+		m_geoms.insert( member.geom, ref );
+		m_uniqueTotals += member.stats;
+	} else {
+		it->refs++;
+
+	  // The geometry changed while other members still use it, so its refs
+	  // never reached 0; the newest stats replace the ones counted
+		if( !sameStats( it->stats, member.stats ) ) {
+			m_uniqueTotals -= it->stats;
+			m_uniqueTotals += member.stats;
+			it->stats = member.stats;
+		}
+	}
+}
+
+/**
+	The caller removes the member from m_members
+**/
+void DzSelectionStats::removeMember( const Member &member ) {
+	m_renderTotals -= member.stats;
+	if( member.instance ) {
+		m_numInstances--;
+	}
+	if( member.geom == NULL ) {
+		return;
+	}
+
+	QHash<const DzGeometry*, GeomRef>::iterator it = m_geoms.find( member.geom );
+	if( it != m_geoms.end() && --it->refs == 0 ) {
+		m_uniqueTotals -= it->stats;
+		m_geoms.erase( it );
+	}
+}
+
+/**
+ **/
+void DzSelectionStats::clear() {
+	m_members.clear();
+	m_geoms.clear();
+	m_renderTotals = DzGeomStats();
+	m_uniqueTotals = DzGeomStats();
+	m_numSelected = 0;
+	m_numBones = 0;
+	m_numInstances = 0;
+	m_numChanged = 0;
+}
+
+/**
+	Bring the totals up to date with the current selection. tree should have
+	been synced with the scene.
+**/
+void DzSelectionStats::update( const DzSceneTree &tree ) {
+  // The selected nodes and the bones of selected figures
+	QSet<DzNode*> wanted;
+	m_numSelected = dzScene->getNumSelectedNodes();
+	for( int i = 0; i < m_numSelected; i++ ) {
+		DzNode *node = dzScene->getSelectedNode( i );
+		wanted.insert( node );
+		if( DzSkeleton *figure = qobject_cast<DzSkeleton*>( node ) ) {
+			DzBoneList bones;
+			figure->getAllBones( bones );
+			for( int j = 0; j < bones.count(); j++ ) {
+				wanted.insert( bones[j] );
+			}
+		}
+	}
+
+	m_numChanged = 0;
+	m_numBones = 0;
+
+  // Drop the nodes that left the selection
+	QHash<DzNode*, Member>::iterator it = m_members.begin();
+	while( it != m_members.end() ) {
+		if( wanted.contains( it.key() ) ) {
+			++it;
+		} else {
+			removeMember( it.value() );
+			it = m_members.erase( it );
+			m_numChanged++;
+		}
+	}
+
+  // Add the new ones, and refresh the ones whose stats or geometry changed
+	QSet<DzNode*>::const_iterator node;
+	for( node = wanted.constBegin(); node != wanted.constEnd(); ++node ) {
+		if( qobject_cast<DzBone*>( *node ) ) {
+			m_numBones++;
+		}
+
+		Member member;
+		resolve( *node, tree, member );
+		it = m_members.find( *node );
+		if( it != m_members.end() ) {
+			if( it->geom == member.geom && sameStats( it->stats, member.stats ) ) {
+				continue;
+			}
+			removeMember( it.value() );
+			m_members.erase( it );
+		}
+		addMember( *node, member );
+		m_numChanged++;
+	}
+}
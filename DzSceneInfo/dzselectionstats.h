@@ -0,0 +1,92 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_SELECTION_STATS_H
+#define DAZ_SELECTION_STATS_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+
+#include "dzscenetree.h"
+
+/****************************
+   Forward declarations
+****************************/
+class DzGeometry;
+class DzNode;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Totals for every selected node, and the bones of selected figures.
+
+	Geometry is counted once per member for rendering, and once per distinct
+	geometry for memory, so instances and nodes sharing a shape's geometry
+	only add to the render totals. An instance counts the geometry of its
+	target.
+
+	The members and the geometry they use are kept between updates; update()
+	only adds and removes the nodes that entered or left the selection, and
+	adjusts those whose cached stats changed. The node stats come from the
+	scene tree, so no geometry is read here.
+**/
+class DzSelectionStats {
+public:
+	DzSelectionStats() : m_numSelected( 0 ), m_numBones( 0 ), m_numInstances( 0 ), m_numChanged( 0 ) {}
+
+	void	update( const DzSceneTree &tree );
+	void	clear();
+
+	int		getNumMembers() const { return m_members.count(); }
+	int		getNumSelected() const { return m_numSelected; }
+	int		getNumBones() const { return m_numBones; }
+	int		getNumInstances() const { return m_numInstances; }
+	int		getNumGeometries() const { return m_geoms.count(); }
+	int		getNumChanged() const { return m_numChanged; }		// Members touched by the last update
+
+	const DzGeomStats&	getRenderTotals() const { return m_renderTotals; }
+	const DzGeomStats&	getUniqueTotals() const { return m_uniqueTotals; }
+
+private:
+	struct Member {
+		const DzGeometry	*geom;
+		DzGeomStats			stats;
+		bool				instance;
+	};
+	struct GeomRef {
+		int			refs;
+		DzGeomStats	stats;
+	};
+
+	static void	resolve( DzNode *node, const DzSceneTree &tree, Member &member );
+	void		addMember( DzNode *node, const Member &member );
+	void		removeMember( const Member &member );
+
+	QHash<DzNode*, Member>				m_members;
+	QHash<const DzGeometry*, GeomRef>	m_geoms;		// Geometry used by the members
+	DzGeomStats							m_renderTotals;	// Per member
+	DzGeomStats							m_uniqueTotals;	// Per distinct geometry
+	int									m_numSelected;
+	int									m_numBones;
+	int									m_numInstances;
+	int									m_numChanged;
+};
+
+#endif // DAZ_SELECTION_STATS_H
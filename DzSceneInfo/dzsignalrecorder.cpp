@@ -0,0 +1,153 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzsignalrecorder.h"
+
+#include <string.h>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QtAlgorithms>
+
+/**
+ **/
+static bool compareBurstCounts( const DzSignalRecorder::Burst &burst1, const DzSignalRecorder::Burst &burst2 ) {
+	return burst1.count > burst2.count;
+}
+
+/**
+ **/
+QString DzSignalRecorder::getTypeName( int type ) {
+	switch( type ) {
+	case NodeListChanged:			return "Node List Changed";
+	case PrimarySelectionChanged:	return "Primary Selection Changed";
+	case SelectionListChanged:		return "Selection List Changed";
+	case VisibilityChanged:			return "Visibility Changed";
+	case CameraMoved:				return "Camera Moved";
+	case LoadOrClearStarting:		return "Load/Clear Starting";
+	case SceneLoaded:				return "Scene Loaded";
+	case SceneCleared:				return "Scene Cleared";
+	case NodeAdded:					return "Node Added";
+	case NodeRemoved:				return "Node Removed";
+	default:						return "Unknown";
+	}
+}
+
+/**
+	A copy of the records in the ring, oldest first. The head is read before
+	and after the copy; any record the producer may have overwritten in between
+	is dropped from the front.
+**/
+QVector<DzSignalRecorder::Record> DzSignalRecorder::getRecords( int *numOverwritten ) const {
+	QAtomicInt &head = const_cast<QAtomicInt&>( m_head );
+	int last = head.fetchAndAddAcquire( 0 );
+	int first = qMax( last - int( c_capacity ), 0 );
+
+	QVector<Record> records( last - first );
+	for( int i = first; i < last; i++ ) {
+		records[i - first] = m_ring[i & ( c_capacity - 1 )];
+	}
+
+  // The slot of the record being written when the copy ended is unsafe too.
+  // An acquire read would let the copy's loads move after it; the ordered
+  // read is a full barrier, so it sees every overwrite the copy could have.
+	int valid = qMax( first, head.fetchAndAddOrdered( 0 ) - int( c_capacity ) + 1 );
+	if( valid > first ) {
+		records.remove( 0, qMin( valid - first, records.count() ) );
+	}
+	if( numOverwritten ) {
+		*numOverwritten = valid;
+	}
+	return records;
+}
+
+/**
+	Rates, handler time per signal type, and the largest bursts
+**/
+DzSignalRecorder::Report DzSignalRecorder::analyze( int maxBursts ) const {
+	Report report;
+	QVector<Record> records = getRecords( &report.numOverwritten );
+	int n = records.count();
+	report.numRecords = n;
+	if( n == 0 ) {
+		return report;
+	}
+
+	report.seconds = ( now() - records[0].time ) / 1.0e9;
+	report.perSecond = report.seconds > 0 ? n / report.seconds : 0.0;
+
+	Burst burst;
+	int i, j = 0;
+	for( i = 0; i < n; i++ ) {
+		const Record &rec = records[i];
+		TypeStats &type = report.types[rec.type];
+		type.count++;
+		type.totalNsecs += rec.nsecs;
+		type.maxNsecs = qMax( type.maxNsecs, qint64( rec.nsecs ) );
+
+	  // The signals within one second before this one
+		while( rec.time - records[j].time >= 1000000000 ) {
+			j++;
+		}
+		report.peakPerSecond = qMax( report.peakPerSecond, i - j + 1 );
+
+	  // Close the current burst at the first long gap
+		if( i == 0 || rec.time - burst.end > getBurstGap() ) {
+			if( i > 0 && burst.count > 1 ) {
+				report.bursts.append( burst );
+			}
+			memset( &burst, 0, sizeof(burst) );
+			burst.start = rec.time;
+		}
+		burst.end = qMax( burst.end, rec.time + rec.nsecs );
+		burst.count++;
+		burst.handlerNsecs += rec.nsecs;
+		burst.counts[rec.type]++;
+	}
+	if( burst.count > 1 ) {
+		report.bursts.append( burst );
+	}
+
+	qSort( report.bursts.begin(), report.bursts.end(), compareBurstCounts );
+	while( report.bursts.count() > maxBursts ) {
+		report.bursts.removeLast();
+	}
+	return report;
+}
+
+/**
+	Write the records in the ring to a CSV file
+**/
+bool DzSignalRecorder::exportCsv( const QString &fileName ) const {
+	QFile file( fileName );
+	if( !file.open( QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text ) ) {
+		return false;
+	}
+
+	QVector<Record> records = getRecords();
+	QTextStream out( &file );
+	out << "Time ms,Signal,Handler us,Deferred\n";
+	for( int i = 0; i < records.count(); i++ ) {
+		out << QString::number( records[i].time / 1.0e6, 'f', 3 ) << ","
+			<< getTypeName( records[i].type ) << ","
+			<< QString::number( records[i].nsecs / 1.0e3, 'f', 1 ) << ","
+			<< ( records[i].flags & Deferred ? 1 : 0 ) << "\n";
+	}
+	return out.status() == QTextStream::Ok;
+}
@@ -0,0 +1,199 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_SIGNAL_RECORDER_H
+#define DAZ_SIGNAL_RECORDER_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QAtomicInt>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+/****************************
+   Forward declarations
+****************************/
+class DzSignalScope;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Records each scene signal the pane handles : when it arrived and how long
+	the pane spent on it.
+
+	The records go into a fixed-size ring that is written by a single
+	producer (the GUI thread) without locks; a record is a few stores and a
+	release of the head counter. Once the ring is full the oldest records are
+	overwritten. Readers take a snapshot and drop any record the producer
+	overwrote while it was being copied, seqlock style : the head is read
+	before the copy with acquire ordering and after it with a full barrier,
+	so the copy cannot be reordered past the second read. A snapshot may
+	therefore be taken from any thread.
+
+	A handler that returns early because the pane is hidden calls
+	markDeferred(); the whole handler, from the start of its outermost
+	DzSignalScope, is then counted as deferred.
+**/
+class DzSignalRecorder {
+public:
+	enum Type {
+		NodeListChanged,
+		PrimarySelectionChanged,
+		SelectionListChanged,
+		VisibilityChanged,
+		CameraMoved,
+		LoadOrClearStarting,
+		SceneLoaded,
+		SceneCleared,
+		NodeAdded,
+		NodeRemoved,
+		NumTypes
+	};
+
+	enum Flag {
+		Deferred = 0x1		// The handler returned early while the pane was hidden
+	};
+
+	struct Record {
+		qint64	time;		// nsecs since the recorder was created
+		qint32	nsecs;		// Time spent handling the signal
+		qint16	type;
+		qint16	flags;
+	};
+
+	struct TypeStats {
+		int		count;
+		qint64	totalNsecs;
+		qint64	maxNsecs;
+
+		TypeStats() : count( 0 ), totalNsecs( 0 ), maxNsecs( 0 ) {}
+	};
+
+	/**
+		A run of signals with no gap longer than getBurstGap()
+	**/
+	struct Burst {
+		qint64	start;
+		qint64	end;
+		int		count;
+		qint64	handlerNsecs;
+		int		counts[NumTypes];
+	};
+
+	struct Report {
+		int				numRecords;			// In the snapshot
+		int				numOverwritten;		// Recorded but no longer in the ring
+		double			seconds;			// From the first record in the snapshot to now
+		double			perSecond;
+		int				peakPerSecond;		// Most signals within any one second
+		TypeStats		types[NumTypes];
+		QList<Burst>	bursts;				// Largest first
+
+		Report() : numRecords( 0 ), numOverwritten( 0 ), seconds( 0 ), perSecond( 0 ),
+			peakPerSecond( 0 ) {}
+	};
+
+	DzSignalRecorder() : m_head( 0 ), m_scope( NULL ), m_numDeferred( 0 ), m_deferredNsecs( 0 ) { m_clock.start(); }
+
+	/** Returns the start time to pass to record() once the signal is handled **/
+	qint64	now() const { return m_clock.nsecsElapsed(); }
+	void	record( Type type, qint64 start, int flags = 0 ) {
+		qint64 end = m_clock.nsecsElapsed();
+		int head = m_head;
+		Record &rec = m_ring[head & ( c_capacity - 1 )];
+		rec.time = start;
+		rec.nsecs = qint32( qMin( end - start, qint64( 0x7fffffff ) ) );
+		rec.type = type;
+		rec.flags = flags;
+		m_head.fetchAndStoreRelease( head + 1 );
+		if( flags & Deferred ) {
+			m_numDeferred++;
+			m_deferredNsecs += end - start;
+		}
+	}
+
+	void	markDeferred();
+
+	// Deferred handlers since the recorder was created, and their total time
+	int		getNumDeferred() const { return m_numDeferred; }
+	qint64	getDeferredNsecs() const { return m_deferredNsecs; }
+
+	QVector<Record>	getRecords( int *numOverwritten = NULL ) const;
+	Report			analyze( int maxBursts ) const;
+	bool			exportCsv( const QString &fileName ) const;
+
+	static int		getCapacity() { return c_capacity; }
+	static QString	getTypeName( int type );
+	static qint64	getBurstGap() { return 50 * 1000000; }	// nsecs
+
+private:
+	friend class DzSignalScope;
+
+	enum { c_capacity = 4096 };	// A power of two
+
+	Record			m_ring[c_capacity];
+	QAtomicInt		m_head;		// Records written; the next slot is m_head % c_capacity
+	QElapsedTimer	m_clock;
+	DzSignalScope	*m_scope;	// Outermost open scope; producer thread only
+	int				m_numDeferred;
+	qint64			m_deferredNsecs;
+};
+
+/**
+	Records a signal of the given type when it goes out of scope
+**/
+class DzSignalScope {
+public:
+	DzSignalScope( DzSignalRecorder &recorder, DzSignalRecorder::Type type ) :
+		m_recorder( recorder ), m_type( type ), m_start( recorder.now() ), m_flags( 0 ) {
+		if( m_recorder.m_scope == NULL ) {
+			m_recorder.m_scope = this;
+		}
+	}
+	~DzSignalScope() {
+		if( m_recorder.m_scope == this ) {
+			m_recorder.m_scope = NULL;
+		}
+		m_recorder.record( m_type, m_start, m_flags );
+	}
+
+private:
+	friend class DzSignalRecorder;
+
+	DzSignalRecorder		&m_recorder;
+	DzSignalRecorder::Type	m_type;
+	qint64					m_start;
+	int						m_flags;
+};
+
+/**
+	Flag the handler in progress as deferred. Outside of any scope there is
+	no handler to time, so only the count goes up.
+**/
+inline void DzSignalRecorder::markDeferred() {
+	if( m_scope ) {
+		m_scope->m_flags |= Deferred;
+	} else {
+		m_numDeferred++;
+	}
+}
+
+#endif // DAZ_SIGNAL_RECORDER_H
@@ -0,0 +1,206 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzskinanalysis.h"
+
+#include <QtCore/QList>
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QtConcurrentMap>
+
+#include "dzbone.h"
+#include "dzbonebinding.h"
+#include "dzfacetmesh.h"
+#include "dzobject.h"
+#include "dzshape.h"
+#include "dzskeleton.h"
+#include "dzskinbinding.h"
+#include "dzweightmap.h"
+
+// Weight map value of a full weight
+static const int c_fullWeight = 65535;
+// Vertices per reduction job
+static const int c_chunkVerts = 16384;
+
+/**
+	The weights of one bone, and the vertices they influence
+**/
+struct DzSkinBoneJob {
+	const unsigned short	*weights;
+	int						numWeights;
+	unsigned short			pruneValue;
+	QVector<int>			verts;			// Non-zero weights, in vertex order
+	QVector<int>			negligible;		// Non-zero weights below pruneValue
+};
+
+/**
+	A range of vertices whose influences are counted by one job
+**/
+struct DzSkinVertexChunk {
+	int							begin;
+	int							end;
+	const QList<DzSkinBoneJob>	*bones;
+	QVector<int>				influences;
+	int							maxInfluences;
+	int							numPrunable;
+};
+
+/**
+	Runs on a worker thread
+**/
+static void scanBone( DzSkinBoneJob &job ) {
+	for( int i = 0; i < job.numWeights; i++ ) {
+		unsigned short weight = job.weights[i];
+		if( weight == 0 ) {
+			continue;
+		}
+		job.verts.append( i );
+		if( weight < job.pruneValue ) {
+			job.negligible.append( i );
+		}
+	}
+}
+
+/**
+	Runs on a worker thread : counts the bones influencing each vertex of the
+	chunk. The vertex lists are sorted, so each bone's share of the chunk is
+	found with a binary search.
+**/
+static void reduceChunk( DzSkinVertexChunk &chunk ) {
+	int size = chunk.end - chunk.begin;
+	QVector<int> counts( size, 0 );
+	QVector<bool> prunable( size, false );
+
+	for( int i = 0; i < chunk.bones->count(); i++ ) {
+		const DzSkinBoneJob &bone = chunk.bones->at( i );
+		const int *v = qLowerBound( bone.verts.constBegin(), bone.verts.constEnd(), chunk.begin );
+		for( ; v != bone.verts.constEnd() && *v < chunk.end; ++v ) {
+			counts[*v - chunk.begin]++;
+		}
+		v = qLowerBound( bone.negligible.constBegin(), bone.negligible.constEnd(), chunk.begin );
+		for( ; v != bone.negligible.constEnd() && *v < chunk.end; ++v ) {
+			prunable[*v - chunk.begin] = true;
+		}
+	}
+
+	int maxBucket = DzSkinAnalysis::getMaxBucket();
+	chunk.influences.fill( 0, maxBucket + 1 );
+	chunk.maxInfluences = 0;
+	chunk.numPrunable = 0;
+	for( int i = 0; i < size; i++ ) {
+		chunk.influences[qMin( counts[i], maxBucket )]++;
+		chunk.maxInfluences = qMax( chunk.maxInfluences, counts[i] );
+		if( prunable[i] ) {
+			chunk.numPrunable++;
+		}
+	}
+}
+
+/**
+	The weight maps are read on the calling (GUI) thread; only the arrays are
+	handed to the worker threads
+**/
+void DzSkinAnalysis::compute( DzSkinBinding *binding, int numVerts, DzSkinStats &stats ) {
+	stats = DzSkinStats();
+	stats.numBindings = binding->getNumBoneBindings();
+
+	QList<DzSkinBoneJob> bones;
+	QStringList names;
+	for( int i = 0; i < stats.numBindings; i++ ) {
+		DzBoneBinding *boneBinding = binding->getBoneBinding( i );
+		DzWeightMapPtr weights = boneBinding ? boneBinding->getWeights() : DzWeightMapPtr();
+		DzBone *bone = boneBinding ? boneBinding->getBone() : NULL;
+
+		DzSkinBoneJob job;
+		job.weights = weights ? weights->getWeights() : NULL;
+		job.numWeights = job.weights ? weights->getNumWeights() : 0;
+		job.pruneValue = (unsigned short)( getPruneWeight() * c_fullWeight );
+		bones.append( job );
+		names.append( bone ? bone->getLabel() : QString( "Binding %1" ).arg( i ) );
+
+		stats.numWeights += job.numWeights;
+		stats.weightBytes += job.numWeights * (qint64)sizeof(unsigned short);
+		numVerts = qMax( numVerts, job.numWeights );
+	}
+	stats.numVerts = numVerts;
+
+	QtConcurrent::blockingMap( bones, scanBone );
+	for( int i = 0; i < bones.count(); i++ ) {
+		stats.numEntries += bones[i].verts.count();
+		stats.numNegligible += bones[i].negligible.count();
+		if( bones[i].verts.isEmpty() ) {
+			stats.unweightedBones.append( names[i] );
+		}
+	}
+
+  // Reduce the influences by vertex range
+	QVector<DzSkinVertexChunk> chunks;
+	for( int begin = 0; begin < numVerts; begin += c_chunkVerts ) {
+		DzSkinVertexChunk chunk;
+		chunk.begin = begin;
+		chunk.end = qMin( begin + c_chunkVerts, numVerts );
+		chunk.bones = &bones;
+		chunks.append( chunk );
+	}
+	QtConcurrent::blockingMap( chunks, reduceChunk );
+
+	stats.influences.fill( 0, getMaxBucket() + 1 );
+	for( int i = 0; i < chunks.count(); i++ ) {
+		const DzSkinVertexChunk &chunk = chunks[i];
+		for( int j = 0; j < chunk.influences.count(); j++ ) {
+			stats.influences[j] += chunk.influences[j];
+		}
+		stats.maxInfluences = qMax( stats.maxInfluences, chunk.maxInfluences );
+		stats.numPrunableVerts += chunk.numPrunable;
+	}
+}
+
+/**
+	The skinning stats of the figure, or NULL if it has no skin binding. The
+	cached stats are used while the figure keeps the same binding, number of
+	bound bones and vertex count.
+**/
+const DzSkinStats* DzSkinAnalysis::analyze( DzSkeleton *figure ) {
+	DzSkinBinding *binding = figure ? figure->getSkinBinding() : NULL;
+	if( binding == NULL ) {
+		return NULL;
+	}
+
+	DzObject	*obj = figure->getObject();
+	DzShape		*shape = obj ? obj->getCurrentShape() : NULL;
+	DzGeometry	*geom = shape ? shape->getGeometry() : NULL;
+	int numVerts = geom ? geom->getNumVertices() : 0;
+	int numBindings = binding->getNumBoneBindings();
+
+	QHash<const DzSkeleton*, Entry>::iterator it = m_entries.find( figure );
+	if( it != m_entries.end() &&
+		it->binding == binding &&
+		it->numBindings == numBindings &&
+		it->numVerts == numVerts ) {
+		return &it->stats;
+	}
+
+	Entry &entry = m_entries[figure];
+	entry.binding = binding;
+	entry.numBindings = numBindings;
+	entry.numVerts = numVerts;
+	compute( binding, numVerts, entry.stats );
+	m_numAnalyzed++;
+	return &entry.stats;
+}
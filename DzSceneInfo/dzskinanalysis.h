@@ -0,0 +1,94 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_SKIN_ANALYSIS_H
+#define DAZ_SKIN_ANALYSIS_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+/****************************
+   Forward declarations
+****************************/
+class DzSkeleton;
+class DzSkinBinding;
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	The skinning cost of a figure
+**/
+struct DzSkinStats {
+	int				numVerts;
+	int				numBindings;			// Bones bound to the skin
+	QVector<int>	influences;				// Vertices by number of influencing bones
+	int				maxInfluences;
+	qint64			numWeights;				// Weight map values stored
+	qint64			numEntries;				// Non-zero weights
+	qint64			weightBytes;
+	QStringList		unweightedBones;		// Bound bones with no non-zero weight
+	qint64			numNegligible;			// Non-zero weights below the prune threshold
+	int				numPrunableVerts;		// Vertices with at least one negligible weight
+
+	DzSkinStats() : numVerts( 0 ), numBindings( 0 ), maxInfluences( 0 ), numWeights( 0 ),
+		numEntries( 0 ), weightBytes( 0 ), numNegligible( 0 ), numPrunableVerts( 0 ) {}
+
+	double	getMeanInfluences() const { return numVerts ? double( numEntries ) / numVerts : 0.0; }
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Analyzes the weight maps of a figure's skin binding.
+
+	The weight maps are scanned in parallel, one job per bone, and each job
+	keeps the vertices its bone influences. The per-vertex influence counts are
+	then reduced in parallel over vertex ranges, so no two jobs write the same
+	counter. Results are cached per figure until its binding changes.
+**/
+class DzSkinAnalysis {
+public:
+	DzSkinAnalysis() : m_numAnalyzed( 0 ) {}
+
+	const DzSkinStats*	analyze( DzSkeleton *figure );
+	void				clear() { m_entries.clear(); }
+
+	int				getNumAnalyzed() const { return m_numAnalyzed; }
+	static double	getPruneWeight() { return 0.01; }
+	static int		getMaxBucket() { return 8; }	// Last histogram bucket counts this many or more
+
+private:
+	struct Entry {
+		const DzSkinBinding	*binding;
+		int					numBindings;
+		int					numVerts;
+		DzSkinStats			stats;
+	};
+
+	static void		compute( DzSkinBinding *binding, int numVerts, DzSkinStats &stats );
+
+	QHash<const DzSkeleton*, Entry>	m_entries;
+	int								m_numAnalyzed;	// Figures computed, not read from the cache
+};
+
+#endif // DAZ_SKIN_ANALYSIS_H
@@ -0,0 +1,466 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzstatscache.h"
+
+#include <string.h>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtGui/QDesktopServices>
+
+#include "dzapp.h"
+#include "dzcontentmgr.h"
+#include "dznode.h"
+
+#if defined( Q_OS_WIN )
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*****************************
+Local definitions
+*****************************/
+static const char c_magic[4] = { 'D', 'Z', 'S', 'C' };
+static const quint32 c_version = 1;
+// Files smaller than this are not compacted
+static const qint64 c_compactMinBytes = 256 * 1024;
+
+/**
+	The start of the cache file. Values are in the native byte order.
+**/
+struct DzStatsCacheHeader {
+	char	magic[4];
+	quint32	version;
+	quint32	headerSize;
+	quint32	recordHeaderSize;
+};
+
+/**
+	The fixed part of a record. It is followed by the histogram, the key and
+	padding to a multiple of 8 bytes.
+**/
+struct DzStatsCacheRecord {
+	quint32	size;				// Whole record, padding included
+	quint32	checksum;			// Of everything after this field
+	qint64	modified;			// Asset file stamp
+	qint64	fileSize;
+	qint64	numTessPrims;
+	qint32	keyLength;
+	qint32	numHistogram;		// -1 if the histogram was not stored
+	qint32	geomVerts;
+	qint32	geomFacets;
+	qint32	geomMaterials;
+	qint32	numVerts;
+	qint32	numTris;
+	qint32	numQuads;
+	qint32	numMaterials;
+	qint32	numStrands;
+	qint32	numSegments;
+	qint32	numControlPoints;
+};
+
+/**
+	32-bit FNV-1a
+**/
+static quint32 checksum( const uchar *data, qint64 size ) {
+	quint32 hash = 2166136261u;
+	for( qint64 i = 0; i < size; i++ ) {
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+	Append the data to the file in one write through a handle opened for
+	appending only, so the system places it at the end of the file as it is
+	then, whatever other instances appended since this one last looked.
+	QFile cannot do this; its Append mode only seeks to the end on open.
+**/
+static bool appendToFile( const QString &path, const QByteArray &data ) {
+#if defined( Q_OS_WIN )
+	HANDLE handle = CreateFileW( (const wchar_t*)QDir::toNativeSeparators( path ).utf16(), FILE_APPEND_DATA,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( handle == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+	DWORD written = 0;
+	bool ok = WriteFile( handle, data.constData(), data.size(), &written, NULL ) && written == (DWORD)data.size();
+	CloseHandle( handle );
+	return ok;
+#else
+	int fd = ::open( QFile::encodeName( path ).constData(), O_WRONLY | O_APPEND );
+	if( fd < 0 ) {
+		return false;
+	}
+	bool ok = ::write( fd, data.constData(), data.size() ) == data.size();
+	::close( fd );
+	return ok;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////
+// DzStatsCache
+///////////////////////////////////////////////////////////////////////
+
+/**
+ **/
+DzStatsCache::DzStatsCache() :
+	m_path( getDefaultPath() ),
+	m_opened( false ),
+	m_map( NULL ),
+	m_mapSize( 0 ),
+	m_scanned( 0 ),
+	m_liveBytes( 0 ),
+	m_numHits( 0 ),
+	m_numMisses( 0 )
+{
+}
+
+/**
+ **/
+DzStatsCache::~DzStatsCache() {
+	close();
+}
+
+/**
+ **/
+QString DzStatsCache::getDefaultPath() {
+	return QDesktopServices::storageLocation( QDesktopServices::DataLocation ) +
+		"/SceneInfoEx/statscache.bin";
+}
+
+/**
+	Open and index the file the first time the cache is used. Returns false
+	if the file could not be opened; the cache then always misses.
+**/
+bool DzStatsCache::open() {
+	if( m_opened ) {
+		return m_file.isOpen();
+	}
+	m_opened = true;
+
+	QDir().mkpath( QFileInfo( m_path ).absolutePath() );
+	m_file.setFileName( m_path );
+	if( !m_file.open( QIODevice::ReadWrite ) ) {
+		return false;
+	}
+
+  // Start over if the file is not a cache of this version
+	DzStatsCacheHeader header;
+	bool valid = m_file.read( (char*)&header, sizeof(header) ) == sizeof(header) &&
+		memcmp( header.magic, c_magic, sizeof(c_magic) ) == 0 &&
+		header.version == c_version &&
+		header.headerSize == sizeof(DzStatsCacheHeader) &&
+		header.recordHeaderSize == sizeof(DzStatsCacheRecord);
+	if( !valid ) {
+		memcpy( header.magic, c_magic, sizeof(c_magic) );
+		header.version = c_version;
+		header.headerSize = sizeof(DzStatsCacheHeader);
+		header.recordHeaderSize = sizeof(DzStatsCacheRecord);
+		if( !m_file.resize( 0 ) || m_file.write( (const char*)&header, sizeof(header) ) != sizeof(header) ) {
+			m_file.close();
+			return false;
+		}
+		m_file.flush();
+	}
+
+	map();
+	m_scanned = sizeof(DzStatsCacheHeader);
+	index( m_scanned );
+
+	if( m_mapSize > c_compactMinBytes &&
+		m_liveBytes * 2 < m_mapSize - (qint64)sizeof(DzStatsCacheHeader) ) {
+		compact();
+	}
+	return m_file.isOpen();
+}
+
+/**
+	Map the whole file, replacing the previous mapping
+**/
+void DzStatsCache::map() {
+	if( m_map ) {
+		m_file.unmap( m_map );
+		m_map = NULL;
+	}
+	m_mapSize = m_file.size();
+	if( m_mapSize > 0 ) {
+		m_map = m_file.map( 0, m_mapSize );
+	}
+	if( m_map == NULL ) {
+		m_mapSize = 0;
+	}
+}
+
+/**
+	Add the records from offset on to the index. A later record for a key
+	replaces the earlier one. Scanning stops at a record whose size does not
+	fit, which is where another instance may still be writing.
+**/
+void DzStatsCache::index( qint64 offset ) {
+	DzStatsCacheRecord record;
+	while( offset + (qint64)sizeof(record) <= m_mapSize ) {
+		const uchar *data = m_map + offset;
+		memcpy( &record, data, sizeof(record) );
+		if( record.size < sizeof(record) || record.size % 8 != 0 || offset + record.size > m_mapSize ) {
+			break;
+		}
+
+		qint64 keyOffset = sizeof(record) +
+			qMax( record.numHistogram, 0 ) * (qint64)sizeof(DzMaterialFacetCounts);
+		bool valid = record.keyLength > 0 && record.numHistogram >= -1 &&
+			keyOffset + record.keyLength <= record.size &&
+			checksum( data + 8, record.size - 8 ) == record.checksum;
+		if( valid ) {
+			QByteArray key( (const char*)data + keyOffset, record.keyLength );
+			QHash<QByteArray, qint64>::iterator it = m_index.find( key );
+			if( it != m_index.end() ) {
+				m_liveBytes -= ( (const DzStatsCacheRecord*)( m_map + it.value() ) )->size;
+				it.value() = offset;
+			} else {
+				m_index.insert( key, offset );
+			}
+			m_liveBytes += record.size;
+		}
+		offset += record.size;
+	}
+	m_scanned = offset;
+}
+
+/**
+	Copy the live records to a new file and replace the old one with it. If
+	another instance holds the old file open it cannot be replaced, and the
+	compaction is left for a later session.
+**/
+void DzStatsCache::compact() {
+	QString tmpPath = m_path + ".tmp";
+	QFile out( tmpPath );
+	if( !out.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+		return;
+	}
+	bool ok = out.write( (const char*)m_map, sizeof(DzStatsCacheHeader) ) == sizeof(DzStatsCacheHeader);
+	QHash<QByteArray, qint64>::const_iterator it;
+	for( it = m_index.constBegin(); ok && it != m_index.constEnd(); ++it ) {
+		const uchar *data = m_map + it.value();
+		qint64 size = ( (const DzStatsCacheRecord*)data )->size;
+		ok = out.write( (const char*)data, size ) == size;
+	}
+	out.close();
+
+	m_file.unmap( m_map );
+	m_map = NULL;
+	m_file.close();
+	if( !ok || !QFile::remove( m_path ) ) {
+		QFile::remove( tmpPath );
+	} else {
+		QFile::rename( tmpPath, m_path );
+	}
+
+	m_index.clear();
+	m_liveBytes = 0;
+	if( m_file.open( QIODevice::ReadWrite ) ) {
+		map();
+		index( sizeof(DzStatsCacheHeader) );
+	}
+}
+
+/**
+	Write the pending records and close the file
+**/
+void DzStatsCache::close() {
+	flush();
+	if( m_map ) {
+		m_file.unmap( m_map );
+		m_map = NULL;
+	}
+	m_file.close();
+	m_mapSize = 0;
+	m_scanned = 0;
+	m_liveBytes = 0;
+	m_index.clear();
+	m_opened = false;
+}
+
+/**
+	Append the pending records in a single write, then map and index them
+	along with anything other instances appended in the meantime. The write
+	does not go through m_file, whose position is not moved by theirs.
+**/
+void DzStatsCache::flush() {
+	if( m_pending.isEmpty() || !open() ) {
+		return;
+	}
+
+	QByteArray data;
+	QHash<QByteArray, QByteArray>::const_iterator it;
+	for( it = m_pending.constBegin(); it != m_pending.constEnd(); ++it ) {
+		data.append( it.value() );
+	}
+	m_pending.clear();
+
+	appendToFile( m_path, data );
+	map();
+	index( m_scanned );
+}
+
+/**
+	The key and asset file stamp for a node. Returns false if the node was
+	not loaded from an asset file that still exists. The files are only
+	looked at once until forgetFiles() is called.
+**/
+bool DzStatsCache::getKey( const DzNode *node, QByteArray &key, Stamp &stamp ) {
+	DzUri uri = node->getAssetFileInfo().getUri();
+	QString relPath = uri.getFilePath();
+	if( relPath.isEmpty() ) {
+		return false;
+	}
+
+	QHash<QString, Stamp>::const_iterator it = m_stamps.find( relPath );
+	if( it == m_stamps.end() ) {
+		QString path = dzApp->getContentMgr()->getAbsolutePath( relPath, true );
+		QFileInfo info( path );
+		Stamp newStamp;
+		newStamp.exists = !path.isEmpty() && info.exists();
+		newStamp.modified = newStamp.exists ? info.lastModified().toMSecsSinceEpoch() : 0;
+		newStamp.size = newStamp.exists ? info.size() : 0;
+		it = m_stamps.insert( relPath, newStamp );
+	}
+	stamp = it.value();
+	key = uri.toString().toUtf8();
+	return stamp.exists;
+}
+
+/**
+	Read the record at data into entry, if it was written for the same file
+	stamp
+**/
+bool DzStatsCache::readRecord( const uchar *data, const Stamp &stamp, Entry &entry ) const {
+	DzStatsCacheRecord record;
+	memcpy( &record, data, sizeof(record) );
+	if( record.modified != stamp.modified || record.fileSize != stamp.size ) {
+		return false;
+	}
+
+	entry.stats.numVerts = record.numVerts;
+	entry.stats.numTris = record.numTris;
+	entry.stats.numQuads = record.numQuads;
+	entry.stats.numMaterials = record.numMaterials;
+	entry.stats.numStrands = record.numStrands;
+	entry.stats.numSegments = record.numSegments;
+	entry.stats.numControlPoints = record.numControlPoints;
+	entry.stats.numTessPrims = record.numTessPrims;
+	entry.geomVerts = record.geomVerts;
+	entry.geomFacets = record.geomFacets;
+	entry.geomMaterials = record.geomMaterials;
+	entry.hasHistogram = record.numHistogram >= 0;
+	entry.histogram.resize( qMax( record.numHistogram, 0 ) );
+	if( record.numHistogram > 0 ) {
+		memcpy( entry.histogram.data(), data + sizeof(record),
+			record.numHistogram * sizeof(DzMaterialFacetCounts) );
+	}
+	return true;
+}
+
+/**
+	Serialize a record, padded and with its checksum filled in
+**/
+QByteArray DzStatsCache::writeRecord( const QByteArray &key, const Stamp &stamp, const Entry &entry ) {
+	DzStatsCacheRecord record;
+	int numHistogram = entry.hasHistogram ? entry.histogram.count() : -1;
+	qint64 histogramBytes = qMax( numHistogram, 0 ) * (qint64)sizeof(DzMaterialFacetCounts);
+	qint64 size = sizeof(record) + histogramBytes + key.size();
+	size = ( size + 7 ) & ~(qint64)7;
+
+	record.size = size;
+	record.checksum = 0;
+	record.modified = stamp.modified;
+	record.fileSize = stamp.size;
+	record.numTessPrims = entry.stats.numTessPrims;
+	record.keyLength = key.size();
+	record.numHistogram = numHistogram;
+	record.geomVerts = entry.geomVerts;
+	record.geomFacets = entry.geomFacets;
+	record.geomMaterials = entry.geomMaterials;
+	record.numVerts = entry.stats.numVerts;
+	record.numTris = entry.stats.numTris;
+	record.numQuads = entry.stats.numQuads;
+	record.numMaterials = entry.stats.numMaterials;
+	record.numStrands = entry.stats.numStrands;
+	record.numSegments = entry.stats.numSegments;
+	record.numControlPoints = entry.stats.numControlPoints;
+
+	QByteArray data( size, '\0' );
+	uchar *out = (uchar*)data.data();
+	memcpy( out, &record, sizeof(record) );
+	if( histogramBytes > 0 ) {
+		memcpy( out + sizeof(record), entry.histogram.constData(), histogramBytes );
+	}
+	memcpy( out + sizeof(record) + histogramBytes, key.constData(), key.size() );
+
+	record.checksum = checksum( out + 8, size - 8 );
+	memcpy( out + 4, &record.checksum, sizeof(record.checksum) );
+	return data;
+}
+
+/**
+	Look up the stats stored for the node's asset. The caller still has to
+	check that the geometry counts match.
+**/
+bool DzStatsCache::find( const DzNode *node, Entry &entry ) {
+	QByteArray key;
+	Stamp stamp;
+	if( !getKey( node, key, stamp ) || !open() ) {
+		return false;
+	}
+
+	bool found = false;
+	QHash<QByteArray, QByteArray>::const_iterator pending = m_pending.find( key );
+	if( pending != m_pending.end() ) {
+		found = readRecord( (const uchar*)pending.value().constData(), stamp, entry );
+	} else {
+		QHash<QByteArray, qint64>::const_iterator it = m_index.find( key );
+		if( it != m_index.end() ) {
+			found = readRecord( m_map + it.value(), stamp, entry );
+		}
+	}
+
+	if( found ) {
+		m_numHits++;
+	} else {
+		m_numMisses++;
+	}
+	return found;
+}
+
+/**
+	Store the stats for the node's asset. The record is written by the next
+	flush().
+**/
+void DzStatsCache::insert( const DzNode *node, const Entry &entry ) {
+	QByteArray key;
+	Stamp stamp;
+	if( getKey( node, key, stamp ) ) {
+		m_pending.insert( key, writeRecord( key, stamp, entry ) );
+	}
+}
@@ -0,0 +1,125 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_STATS_CACHE_H
+#define DAZ_STATS_CACHE_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "dzmaterialhistogram.h"
+#include "dzscenetree.h"
+
+/****************************
+   Forward declarations
+****************************/
+class DzNode;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Keeps the geometry stats of asset nodes on disk between sessions.
+
+	Records are keyed by the node's asset URI and are only used while the
+	asset file has the modification time and size it had when the record was
+	written, and while the node's geometry still has the same vertex, facet
+	and material counts. Morphs do not change the counts; grafts and other
+	topology edits do, and make the record miss.
+
+	The file is memory-mapped read-only and only ever appended to, so several
+	instances can read it at once. Records are appended with one write each
+	flush through an append-only handle, so instances writing at the same
+	time do not overwrite each other's records. Each record carries a
+	checksum and damaged or partly written records are skipped. When more
+	than half the file is superseded records the live ones are copied to a
+	new file on open; that, and starting a file over, assume no other
+	instance is writing at the time.
+**/
+class DzStatsCache {
+public:
+	/**
+		What is stored for a node
+	**/
+	struct Entry {
+		DzGeomStats						stats;
+		int								geomVerts;		// Counts the stats were computed from
+		int								geomFacets;
+		int								geomMaterials;
+		bool							hasHistogram;
+		QVector<DzMaterialFacetCounts>	histogram;
+
+		Entry() : geomVerts( 0 ), geomFacets( 0 ), geomMaterials( 0 ), hasHistogram( false ) {}
+
+		bool	matches( int verts, int facets, int materials ) const {
+			return verts == geomVerts && facets == geomFacets && materials == geomMaterials;
+		}
+	};
+
+	DzStatsCache();
+	~DzStatsCache();
+
+	bool	find( const DzNode *node, Entry &entry );
+	void	insert( const DzNode *node, const Entry &entry );
+	void	flush();
+	void	close();
+	void	forgetFiles() { m_stamps.clear(); }
+
+	QString	getPath() const { return m_path; }
+	qint64	getFileSize() const { return m_mapSize; }
+	int		getNumRecords() const { return m_index.count(); }
+	int		getNumHits() const { return m_numHits; }
+	int		getNumMisses() const { return m_numMisses; }
+
+	static QString	getDefaultPath();
+
+private:
+	struct Stamp {
+		bool	exists;
+		qint64	modified;		// msecs since the epoch
+		qint64	size;
+	};
+
+	bool			open();
+	void			map();
+	void			index( qint64 from );
+	void			compact();
+	bool			getKey( const DzNode *node, QByteArray &key, Stamp &stamp );
+	bool			readRecord( const uchar *data, const Stamp &stamp, Entry &entry ) const;
+	static QByteArray	writeRecord( const QByteArray &key, const Stamp &stamp, const Entry &entry );
+
+	QString						m_path;
+	QFile						m_file;
+	bool						m_opened;		// open() was tried
+	uchar						*m_map;
+	qint64						m_mapSize;
+	qint64						m_scanned;		// End of the last good record found
+	qint64						m_liveBytes;	// Bytes of the records in m_index
+	QHash<QByteArray, qint64>	m_index;		// Key to record offset in the file
+	QHash<QByteArray, QByteArray>	m_pending;	// Records not yet appended
+	QHash<QString, Stamp>		m_stamps;		// Asset file to stamp, for this scene
+	int							m_numHits;
+	int							m_numMisses;
+};
+
+#endif // DAZ_STATS_CACHE_H
@@ -0,0 +1,515 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzstatsserver.h"
+
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QtEndian>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+#include "dznode.h"
+#include "dzscene.h"
+
+// Requests are single words; anything longer is a broken client
+static const quint32 c_maxRequestBytes = 1024;
+
+/**
+	Append value to out as JSON
+**/
+static void writeJson( const QVariant &value, QByteArray &out ) {
+	switch( value.type() ) {
+	case QVariant::Invalid:
+		out += "null";
+		break;
+	case QVariant::Bool:
+		out += value.toBool() ? "true" : "false";
+		break;
+	case QVariant::Int:
+	case QVariant::LongLong:
+		out += QByteArray::number( value.toLongLong() );
+		break;
+	case QVariant::UInt:
+	case QVariant::ULongLong:
+		out += QByteArray::number( value.toULongLong() );
+		break;
+	case QVariant::Double:
+		out += QByteArray::number( value.toDouble(), 'g', 15 );
+		break;
+	case QVariant::Map: {
+			const QVariantMap map = value.toMap();
+			out += '{';
+			QVariantMap::const_iterator it;
+			for( it = map.constBegin(); it != map.constEnd(); ++it ) {
+				if( it != map.constBegin() ) {
+					out += ',';
+				}
+				writeJson( it.key(), out );
+				out += ':';
+				writeJson( it.value(), out );
+			}
+			out += '}';
+		}
+		break;
+	case QVariant::List:
+	case QVariant::StringList: {
+			const QVariantList list = value.toList();
+			out += '[';
+			for( int i = 0; i < list.count(); i++ ) {
+				if( i > 0 ) {
+					out += ',';
+				}
+				writeJson( list[i], out );
+			}
+			out += ']';
+		}
+		break;
+	default: {
+			const QByteArray str = value.toString().toUtf8();
+			out += '"';
+			for( int i = 0; i < str.size(); i++ ) {
+				uchar c = str[i];
+				if( c == '"' || c == '\\' ) {
+					out += '\\';
+					out += c;
+				} else if( c < 0x20 ) {
+					out += QString( "\\u%1" ).arg( c, 4, 16, QChar( '0' ) ).toLatin1();
+				} else {
+					out += c;
+				}
+			}
+			out += '"';
+		}
+		break;
+	}
+}
+
+/**
+	A length-prefixed JSON frame for map, with its type member set
+**/
+static QByteArray encodeFrame( const QString &type, QVariantMap map ) {
+	map["type"] = type;
+
+	QByteArray frame( 4, '\0' );
+	writeJson( map, frame );
+	qToBigEndian<quint32>( frame.size() - 4, (uchar*)frame.data() );
+	return frame;
+}
+
+/*****************************
+DzStatsServerWorker
+*****************************/
+
+/**
+ **/
+DzStatsServerWorker::DzStatsServerWorker( const QString &name ) :
+	m_name( name ),
+	m_server( NULL ),
+	m_hasSnapshot( false )
+{
+}
+
+/**
+ **/
+DzStatsServerWorker::~DzStatsServerWorker() {
+	stop();
+}
+
+/**
+	Called on the worker thread, so the server and its sockets belong to it
+**/
+void DzStatsServerWorker::start() {
+	if( m_server ) {
+		return;
+	}
+
+  // A server that crashed can leave its socket file behind
+	QLocalServer::removeServer( m_name );
+
+	m_server = new QLocalServer( this );
+	connect( m_server, SIGNAL(newConnection()), this, SLOT(newConnection()) );
+	if( !m_server->listen( m_name ) ) {
+		qWarning( "Scene Info Ex : stats server could not listen on %s : %s",
+			qPrintable( m_name ), qPrintable( m_server->errorString() ) );
+	}
+}
+
+/**
+ **/
+void DzStatsServerWorker::stop() {
+	QHash<QLocalSocket*, Client>::iterator it;
+	for( it = m_clients.begin(); it != m_clients.end(); ++it ) {
+		it.key()->disconnect( this );
+		it.key()->abort();
+		delete it.key();
+	}
+	m_clients.clear();
+	m_waiting.clear();
+
+	delete m_server;
+	m_server = NULL;
+}
+
+/**
+ **/
+void DzStatsServerWorker::newConnection() {
+	while( m_server->hasPendingConnections() ) {
+		QLocalSocket *socket = m_server->nextPendingConnection();
+		m_clients.insert( socket, Client() );
+		connect( socket, SIGNAL(readyRead()), this, SLOT(readClient()) );
+		connect( socket, SIGNAL(disconnected()), this, SLOT(clientDisconnected()) );
+	}
+	emit clientsChanged( m_clients.count() );
+}
+
+/**
+ **/
+void DzStatsServerWorker::clientDisconnected() {
+	QLocalSocket *socket = qobject_cast<QLocalSocket*>( sender() );
+	if( m_clients.remove( socket ) == 0 ) {
+		return;
+	}
+	m_waiting.removeAll( socket );
+	socket->deleteLater();
+	emit clientsChanged( m_clients.count() );
+}
+
+/**
+	Split whatever has arrived into complete requests
+**/
+void DzStatsServerWorker::readClient() {
+	QLocalSocket *socket = qobject_cast<QLocalSocket*>( sender() );
+	QHash<QLocalSocket*, Client>::iterator it = m_clients.find( socket );
+	if( it == m_clients.end() ) {
+		return;
+	}
+
+	it->buffer += socket->readAll();
+	processRequests( socket, it.value() );
+}
+
+/**
+	Answer every complete request in the client's buffer. Before the first
+	snapshot there is nothing to answer with, so the requests are kept.
+**/
+void DzStatsServerWorker::processRequests( QLocalSocket *socket, Client &client ) {
+	if( !m_hasSnapshot ) {
+		if( !m_waiting.contains( socket ) ) {
+			m_waiting.append( socket );
+		}
+		return;
+	}
+
+	while( client.buffer.size() >= 4 ) {
+		quint32 length = qFromBigEndian<quint32>( (const uchar*)client.buffer.constData() );
+		if( length > c_maxRequestBytes ) {
+			socket->abort();
+			return;
+		}
+		if( (quint32)client.buffer.size() < 4 + length ) {
+			break;
+		}
+		QByteArray command = client.buffer.mid( 4, length ).trimmed();
+		client.buffer.remove( 0, 4 + length );
+		handleRequest( socket, client, command );
+	}
+}
+
+/**
+ **/
+void DzStatsServerWorker::handleRequest( QLocalSocket *socket, Client &client, const QByteArray &command ) {
+	if( command == "totals" ) {
+		sendFrame( socket, m_totalsFrame );
+	} else if( command == "nodes" ) {
+		sendFrame( socket, m_nodesFrame );
+	} else if( command == "materials" ) {
+		sendFrame( socket, m_materialsFrame );
+	} else if( command == "snapshot" ) {
+		sendFrame( socket, m_totalsFrame );
+		sendFrame( socket, m_nodesFrame );
+		sendFrame( socket, m_materialsFrame );
+	} else if( command == "subscribe" || command == "unsubscribe" ) {
+		client.subscribed = command == "subscribe";
+		QVariantMap map;
+		map["subscribed"] = client.subscribed;
+		sendFrame( socket, encodeFrame( "ack", map ) );
+	} else {
+		QVariantMap map;
+		map["message"] = QString( "Unknown request : %1" ).arg( QString::fromUtf8( command ) );
+		sendFrame( socket, encodeFrame( "error", map ) );
+	}
+}
+
+/**
+	Queue the frame on the socket; the write completes from the event loop
+**/
+void DzStatsServerWorker::sendFrame( QLocalSocket *socket, const QByteArray &frame ) {
+	if( socket->state() == QLocalSocket::ConnectedState ) {
+		socket->write( frame );
+	}
+}
+
+/**
+	Take a new snapshot, and push the delta to the subscribers
+**/
+void DzStatsServerWorker::publish( const QVariantMap &snapshot, const QVariantMap &delta ) {
+	if( snapshot.contains( "totals" ) ) {
+		m_totalsFrame = encodeFrame( "totals", snapshot["totals"].toMap() );
+		QVariantMap nodes;
+		nodes["nodes"] = snapshot["nodes"];
+		m_nodesFrame = encodeFrame( "nodes", nodes );
+		QVariantMap materials;
+		materials["materials"] = snapshot["materials"];
+		m_materialsFrame = encodeFrame( "materials", materials );
+		m_hasSnapshot = true;
+	}
+
+	if( !delta.isEmpty() ) {
+		QByteArray frame = encodeFrame( "delta", delta );
+		QHash<QLocalSocket*, Client>::const_iterator it;
+		for( it = m_clients.constBegin(); it != m_clients.constEnd(); ++it ) {
+			if( it->subscribed ) {
+				sendFrame( it.key(), frame );
+			}
+		}
+	}
+
+  // Answer the requests that arrived before the first snapshot
+	if( m_hasSnapshot ) {
+		QList<QLocalSocket*> waiting = m_waiting;
+		m_waiting.clear();
+		for( int i = 0; i < waiting.count(); i++ ) {
+			QHash<QLocalSocket*, Client>::iterator it = m_clients.find( waiting[i] );
+			if( it != m_clients.end() ) {
+				processRequests( it.key(), it.value() );
+			}
+		}
+	}
+}
+
+/*****************************
+DzStatsServer
+*****************************/
+
+/**
+ **/
+DzStatsServer::DzStatsServer( QObject *parent ) :
+	QObject( parent ),
+	m_thread( NULL ),
+	m_worker( NULL ),
+	m_numClients( 0 ),
+	m_pending( false ),
+	m_loading( false )
+{
+}
+
+/**
+ **/
+DzStatsServer::~DzStatsServer() {
+	stop();
+}
+
+/**
+ **/
+QString DzStatsServer::getDefaultName() {
+	return "DzSceneInfoEx";
+}
+
+/**
+	Start listening on the worker thread. Returns false if already running.
+**/
+bool DzStatsServer::start( const QString &name ) {
+	if( m_thread ) {
+		return false;
+	}
+
+	m_name = name;
+	m_thread = new QThread( this );
+	m_worker = new DzStatsServerWorker( name );
+	m_worker->moveToThread( m_thread );
+	connect( m_worker, SIGNAL(clientsChanged(int)), this, SLOT(clientsChanged(int)) );
+	connect( this, SIGNAL(published(const QVariantMap&, const QVariantMap&)),
+	  m_worker, SLOT(publish(const QVariantMap&, const QVariantMap&)) );
+	m_thread->start();
+	QMetaObject::invokeMethod( m_worker, "start", Qt::QueuedConnection );
+
+	connect( dzScene, SIGNAL(nodeListChanged()), this, SLOT(nodeListChanged()) );
+	connect( dzScene, SIGNAL(primarySelectionChanged(DzNode*)), this, SLOT(selectionChanged(DzNode*)) );
+	connect( dzScene, SIGNAL(sceneLoadStarting()), this, SLOT(loadStarting()) );
+	connect( dzScene, SIGNAL(sceneClearStarting()), this, SLOT(loadStarting()) );
+	connect( dzScene, SIGNAL(sceneLoaded()), this, SLOT(loadFinished()) );
+	connect( dzScene, SIGNAL(sceneCleared()), this, SLOT(loadFinished()) );
+	return true;
+}
+
+/**
+ **/
+void DzStatsServer::stop() {
+	if( m_thread == NULL ) {
+		return;
+	}
+	dzScene->disconnect( this );
+
+  // Close the sockets on the thread that owns them, then wind down
+	QMetaObject::invokeMethod( m_worker, "stop", Qt::BlockingQueuedConnection );
+	m_thread->quit();
+	m_thread->wait();
+	delete m_worker;
+	delete m_thread;
+	m_worker = NULL;
+	m_thread = NULL;
+
+	m_numClients = 0;
+	m_pending = false;
+	m_loading = false;
+	m_lastNodes.clear();
+	m_materials.clear();
+}
+
+/**
+ **/
+void DzStatsServer::nodeListChanged() {
+	schedule( "nodeListChanged" );
+}
+
+/**
+ **/
+void DzStatsServer::selectionChanged( DzNode *node ) {
+	Q_UNUSED( node );
+	schedule( "primarySelectionChanged" );
+}
+
+/**
+	Hold the publishes while the scene is loaded or cleared; the node and
+	selection signals it sends describe a half-built scene
+**/
+void DzStatsServer::loadStarting() {
+	m_loading = true;
+}
+
+/**
+	Publish once for the whole load
+**/
+void DzStatsServer::loadFinished() {
+	if( !m_loading ) {
+		return;
+	}
+	m_loading = false;
+	m_reason.clear();
+	schedule( "sceneLoaded" );
+}
+
+/**
+	The first client gets a snapshot right away; the scene is not read at all
+	while nobody is connected
+**/
+void DzStatsServer::clientsChanged( int numClients ) {
+	bool first = m_numClients == 0 && numClients > 0;
+	m_numClients = numClients;
+	if( first ) {
+		m_lastNodes.clear();
+		schedule( "connected" );
+	}
+}
+
+/**
+	Collapse a burst of scene signals into one publish from the event loop
+**/
+void DzStatsServer::schedule( const QString &reason ) {
+	if( m_numClients == 0 || m_loading ) {
+		return;
+	}
+	if( !m_reason.split( ',', QString::SkipEmptyParts ).contains( reason ) ) {
+		m_reason += m_reason.isEmpty() ? reason : "," + reason;
+	}
+	if( !m_pending ) {
+		m_pending = true;
+		QTimer::singleShot( 0, this, SLOT(publish()) );
+	}
+}
+
+/**
+	Gather the scene data and hand it to the worker, along with what changed
+	since the last publish
+**/
+void DzStatsServer::publish() {
+	m_pending = false;
+	if( m_worker == NULL || m_numClients == 0 || m_loading ) {
+	  // A publish queued before a load started is replaced by the one after it
+		m_reason.clear();
+		return;
+	}
+
+  // A selection change alone leaves the totals, node rows and materials of
+  // the last publish as they were, so only the selected node is sent
+	if( m_reason == "primarySelectionChanged" && !m_lastNodes.isEmpty() ) {
+		QVariantMap delta;
+		delta["reason"] = m_reason;
+		delta["selected"] = m_stats.getSelectedNode();
+		m_reason.clear();
+		emit published( QVariantMap(), delta );
+		return;
+	}
+
+	QVariantMap totals = m_stats.getSceneInfo();
+	QVariantList nodes = m_stats.getNodes();
+	m_materials = m_stats.getMaterials();
+
+	QVariantMap snapshot;
+	snapshot["totals"] = totals;
+	snapshot["nodes"] = nodes;
+	snapshot["materials"] = m_materials;
+
+  // Node rows that were added, removed or changed
+	QVariantList added, changed, removed;
+	QHash<qulonglong, QVariantMap> current;
+	for( int i = 0; i < nodes.count(); i++ ) {
+		QVariantMap row = nodes[i].toMap();
+		qulonglong id = row["id"].toULongLong();
+		current.insert( id, row );
+
+		QHash<qulonglong, QVariantMap>::const_iterator it = m_lastNodes.find( id );
+		if( it == m_lastNodes.constEnd() ) {
+			added.append( row );
+		} else if( it.value() != row ) {
+			changed.append( row );
+		}
+	}
+	QHash<qulonglong, QVariantMap>::const_iterator it;
+	for( it = m_lastNodes.constBegin(); it != m_lastNodes.constEnd(); ++it ) {
+		if( !current.contains( it.key() ) ) {
+			removed.append( it.key() );
+		}
+	}
+	m_lastNodes = current;
+
+	QVariantMap delta;
+	delta["reason"] = m_reason;
+	delta["totals"] = totals;
+	delta["added"] = added;
+	delta["changed"] = changed;
+	delta["removed"] = removed;
+	delta["selected"] = m_stats.getSelectedNode();
+	m_reason.clear();
+
+	emit published( snapshot, delta );
+}
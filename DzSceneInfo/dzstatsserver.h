@@ -0,0 +1,153 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_STATS_SERVER_H
+#define DAZ_STATS_SERVER_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QVariant>
+
+#include "dzscenestats.h"
+
+/****************************
+   Forward declarations
+****************************/
+class QLocalServer;
+class QLocalSocket;
+class QThread;
+class DzNode;
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	The socket side of DzStatsServer. Lives on its own thread and never touches
+	the scene : it answers requests from the last snapshot it was given, and
+	pushes deltas to subscribed clients.
+
+	Every frame is a 32-bit big-endian length followed by that many bytes.
+	Requests are a single command word : "totals", "nodes", "materials",
+	"snapshot", "subscribe" or "unsubscribe". Replies and pushed deltas are
+	UTF-8 JSON objects with a "type" member. A delta for a selection change
+	only has the "reason" and "selected" members.
+**/
+class DzStatsServerWorker : public QObject {
+	Q_OBJECT
+public:
+	DzStatsServerWorker( const QString &name );
+	~DzStatsServerWorker();
+
+public slots:
+
+	void	start();
+	void	stop();
+	void	publish( const QVariantMap &snapshot, const QVariantMap &delta );
+
+signals:
+
+	void	clientsChanged( int numClients );
+
+private slots:
+
+	void	newConnection();
+	void	readClient();
+	void	clientDisconnected();
+
+private:
+	struct Client {
+		QByteArray	buffer;		// Bytes of an incomplete request
+		bool		subscribed;
+
+		Client() : subscribed( false ) {}
+	};
+
+	void	processRequests( QLocalSocket *socket, Client &client );
+	void	handleRequest( QLocalSocket *socket, Client &client, const QByteArray &command );
+	void	sendFrame( QLocalSocket *socket, const QByteArray &frame );
+
+	QString							m_name;
+	QLocalServer					*m_server;
+	QHash<QLocalSocket*, Client>	m_clients;
+	QList<QLocalSocket*>			m_waiting;		// Asked before the first snapshot
+
+	// Encoded once per snapshot and shared by every reply
+	bool							m_hasSnapshot;
+	QByteArray						m_totalsFrame;
+	QByteArray						m_nodesFrame;
+	QByteArray						m_materialsFrame;
+};
+
+/**
+	Optional local socket endpoint (a named pipe on Windows) serving the scene
+	totals, node rows and materials to external tools.
+
+	Scene data is gathered on the GUI thread through DzSceneInfoStats, only while
+	clients are connected, and only once per burst of scene signals. Nothing is
+	published while a scene is loading or clearing; a single publish follows
+	once it has finished. A change of the primary selection alone only sends
+	the selected node, without walking the node rows. Encoding and all socket
+	I/O happen on a worker thread, so slow or numerous clients never block the
+	GUI.
+**/
+class DzStatsServer : public QObject {
+	Q_OBJECT
+public:
+	DzStatsServer( QObject *parent = NULL );
+	~DzStatsServer();
+
+	static QString	getDefaultName();
+
+	bool	start( const QString &name );
+	void	stop();
+	bool	isRunning() const { return m_thread != NULL; }
+	QString	getName() const { return m_name; }
+	int		getNumClients() const { return m_numClients; }
+
+signals:
+
+	void	published( const QVariantMap &snapshot, const QVariantMap &delta );
+
+private slots:
+
+	void	nodeListChanged();
+	void	selectionChanged( DzNode *node );
+	void	loadStarting();
+	void	loadFinished();
+	void	clientsChanged( int numClients );
+	void	publish();
+
+private:
+	void	schedule( const QString &reason );
+
+	QString					m_name;
+	QThread					*m_thread;
+	DzStatsServerWorker		*m_worker;
+	int						m_numClients;
+	bool					m_pending;
+	bool					m_loading;		// Between sceneLoadStarting() and sceneLoaded()
+	QString					m_reason;
+	DzSceneInfoStats		m_stats;
+	QHash<qulonglong, QVariantMap>	m_lastNodes;	// By node id, for the deltas
+	QVariantList			m_materials;
+};
+
+#endif // DAZ_STATS_SERVER_H
@@ -0,0 +1,325 @@
+/**********************************************************************
+Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+This file is part of the DAZ Studio SDK.
+
+This file may be used only in accordance with the DAZ Studio SDK
+license provided with the DAZ Studio SDK.
+
+The contents of this file may not be disclosed to third parties,
+copied or duplicated in any form, in whole or in part, without the
+prior written permission of DAZ 3D, Inc, except as explicitly
+allowed in the DAZ Studio SDK license.
+
+See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+information about the DAZ Studio SDK.
+**********************************************************************/
+
+/*****************************
+Include files
+*****************************/
+#include "dzvertexcache.h"
+
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QtConcurrentMap>
+
+#include "dzfacetmesh.h"
+#include "dznode.h"
+#include "dzobject.h"
+#include "dzscene.h"
+#include "dzscenetree.h"
+#include "dzshape.h"
+
+/**
+	One mesh to analyze; only the facet array is read on the worker thread
+**/
+struct DzVertexCacheJob {
+	const DzFacetMesh	*mesh;
+	const DzFacet		*facets;
+	int					numFacets;
+	int					numVerts;
+	DzVertexCacheStats	stats;
+};
+
+/**
+ **/
+static bool compareExcess( const DzVertexCacheAnalysis::Entry &entry1, const DzVertexCacheAnalysis::Entry &entry2 ) {
+	if( entry1.getExcessMisses() != entry2.getExcessMisses() ) {
+		return entry1.getExcessMisses() > entry2.getExcessMisses();
+	}
+	return entry1.stats.fifoMisses > entry2.stats.fifoMisses;
+}
+
+/**
+	The triangle stream of the facets; quads are split along their first
+	diagonal, and facets with indices out of range are dropped
+**/
+static void triangulate( const DzFacet *facets, int numFacets, int numVerts, QVector<int> &indices ) {
+	indices.resize( numFacets * 6 );
+	int *out = indices.data();
+	for( int i = 0; i < numFacets; i++ ) {
+		const DzFacet &facet = facets[i];
+		int a = facet.m_vertIdx[0];
+		int b = facet.m_vertIdx[1];
+		int c = facet.m_vertIdx[2];
+		if( (unsigned)a >= (unsigned)numVerts || (unsigned)b >= (unsigned)numVerts ||
+			(unsigned)c >= (unsigned)numVerts ) {
+			continue;
+		}
+		*out++ = a;
+		*out++ = b;
+		*out++ = c;
+
+		int d = facet.m_vertIdx[3];
+		if( facet.isQuad() && (unsigned)d < (unsigned)numVerts ) {
+			*out++ = a;
+			*out++ = c;
+			*out++ = d;
+		}
+	}
+	indices.resize( out - indices.data() );
+}
+
+/**
+	A FIFO cache of cacheSize entries. A vertex is cached while fewer than
+	cacheSize misses have happened since its own, so the cache is a time stamp
+	per vertex. Also counts the vertices used.
+**/
+static qint64 simulateFifo( const QVector<int> &indices, int numVerts, int cacheSize, int &numUsed ) {
+	QVector<int> stamps( numVerts, 0 );
+	int *stamp = stamps.data();
+	int time = cacheSize + 1;
+	numUsed = 0;
+	for( int i = 0, n = indices.count(); i < n; i++ ) {
+		int v = indices[i];
+		if( time - stamp[v] > cacheSize ) {
+			if( stamp[v] == 0 ) {
+				numUsed++;
+			}
+			stamp[v] = time++;
+		}
+	}
+	return time - ( cacheSize + 1 );
+}
+
+/**
+	An LRU cache of cacheSize entries, most recent first
+**/
+static qint64 simulateLru( const QVector<int> &indices, int cacheSize ) {
+	QVector<int> entries( cacheSize );
+	int *cache = entries.data();
+	int numCached = 0;
+	qint64 numMisses = 0;
+	for( int i = 0, n = indices.count(); i < n; i++ ) {
+		int v = indices[i];
+		int j = 0;
+		while( j < numCached && cache[j] != v ) {
+			j++;
+		}
+		if( j == numCached ) {
+			numMisses++;
+			if( numCached < cacheSize ) {
+				numCached++;
+			}
+			j = numCached - 1;
+		}
+		for( ; j > 0; j-- ) {
+			cache[j] = cache[j - 1];
+		}
+		cache[0] = v;
+	}
+	return numMisses;
+}
+
+/**
+	Reorder the triangles with Tipsify and return the FIFO misses of the new
+	order, which its own cache simulation counts. The new order itself is
+	not kept.
+**/
+static qint64 simulateTipsify( const QVector<int> &indices, int numVerts, int cacheSize ) {
+	int numTris = indices.count() / 3;
+	if( numTris == 0 ) {
+		return 0;
+	}
+	const int *tris = indices.constData();
+
+  // The triangles around each vertex
+	QVector<int> offsets( numVerts + 1, 0 );
+	for( int i = 0; i < numTris * 3; i++ ) {
+		offsets[tris[i] + 1]++;
+	}
+	for( int v = 0; v < numVerts; v++ ) {
+		offsets[v + 1] += offsets[v];
+	}
+	QVector<int> adjacency( numTris * 3 );
+	QVector<int> live( numVerts );
+	for( int v = 0; v < numVerts; v++ ) {
+		live[v] = offsets[v];
+	}
+	for( int i = 0; i < numTris * 3; i++ ) {
+		adjacency[live[tris[i]]++] = i / 3;
+	}
+	for( int v = 0; v < numVerts; v++ ) {
+		live[v] = offsets[v + 1] - offsets[v];
+	}
+
+	QVector<int> stamps( numVerts, 0 );
+	QVector<char> emitted( numTris, 0 );
+	QVector<int> deadEnds( numTris * 3 );		// Each emitted corner is pushed once
+	QVector<int> candidates;
+	int numDeadEnds = 0;
+	int time = cacheSize + 1;
+	int cursor = 0;
+	int fan = 0;
+	while( fan >= 0 ) {
+	  // Emit the triangles around the fanning vertex
+		int numCandidates = 0;
+		int numAround = offsets[fan + 1] - offsets[fan];
+		if( candidates.count() < numAround * 3 ) {
+			candidates.resize( numAround * 3 );
+		}
+		for( int a = offsets[fan]; a < offsets[fan + 1]; a++ ) {
+			int t = adjacency[a];
+			if( emitted[t] ) {
+				continue;
+			}
+			for( int c = 0; c < 3; c++ ) {
+				int v = tris[t * 3 + c];
+				deadEnds[numDeadEnds++] = v;
+				candidates[numCandidates++] = v;
+				live[v]--;
+				if( time - stamps[v] > cacheSize ) {
+					stamps[v] = time++;
+				}
+			}
+			emitted[t] = 1;
+		}
+
+	  // Fan next around the candidate that will still be cached after its
+	  // remaining triangles are emitted, preferring the oldest
+		int next = -1;
+		int best = -1;
+		for( int i = 0; i < numCandidates; i++ ) {
+			int v = candidates[i];
+			if( live[v] <= 0 ) {
+				continue;
+			}
+			int priority = 0;
+			if( time - stamps[v] + 2 * live[v] <= cacheSize ) {
+				priority = time - stamps[v];
+			}
+			if( priority > best ) {
+				best = priority;
+				next = v;
+			}
+		}
+
+	  // Otherwise back up to a recent vertex with triangles left, or scan
+		while( next < 0 && numDeadEnds > 0 ) {
+			int v = deadEnds[--numDeadEnds];
+			if( live[v] > 0 ) {
+				next = v;
+			}
+		}
+		while( next < 0 && cursor < numVerts ) {
+			if( live[cursor] > 0 ) {
+				next = cursor;
+			}
+			cursor++;
+		}
+		fan = next;
+	}
+	return time - ( cacheSize + 1 );
+}
+
+/**
+ **/
+static void analyzeMesh( DzVertexCacheJob &job ) {
+	QVector<int> indices;
+	triangulate( job.facets, job.numFacets, job.numVerts, indices );
+
+	DzVertexCacheStats &stats = job.stats;
+	stats.numTris = indices.count() / 3;
+	stats.fifoMisses = simulateFifo( indices, job.numVerts, DzVertexCacheAnalysis::getFifoSize(), stats.numVerts );
+	stats.lruMisses = simulateLru( indices, DzVertexCacheAnalysis::getLruSize() );
+	stats.optimizedMisses = qMin( stats.fifoMisses,
+		simulateTipsify( indices, job.numVerts, DzVertexCacheAnalysis::getFifoSize() ) );
+}
+
+/**
+	tree should have been synced with the scene
+**/
+DzVertexCacheAnalysis::Report DzVertexCacheAnalysis::analyze( const DzSceneTree &tree ) {
+	Report report;
+
+  // The render-visible facet meshes; a mesh shared by several nodes, or
+  // unchanged since the last analysis, is not analyzed again
+	QList<DzVertexCacheJob> jobs;
+	QHash<const DzFacetMesh*, int> jobIndex;
+	QList<int> entryJobs;			// Index in jobs of each entry, or -1
+	QHash<const DzFacetMesh*, CacheEntry> entries;
+	DzNodeListIterator nodeIter( dzScene->nodeListIterator() );
+	DzNode *node = NULL;
+	while( nodeIter.hasNext() ) {
+		node = nodeIter.next();
+		const DzSceneTree::Item *item = tree.getItem( node );
+		if( item == NULL || !item->visible || item->own.getNumFacets() == 0 ) {
+			continue;
+		}
+		DzObject *obj = node->getObject();
+		DzShape *shape = obj ? obj->getCurrentShape() : NULL;
+		DzFacetMesh *mesh = shape ? qobject_cast<DzFacetMesh*>( shape->getGeometry() ) : NULL;
+		if( mesh == NULL ) {
+			continue;
+		}
+
+		Entry entry;
+		entry.node = node;
+		int numVerts = mesh->getNumVertices();
+		int numFacets = mesh->getNumFacets();
+		QHash<const DzFacetMesh*, CacheEntry>::const_iterator cached = m_entries.constFind( mesh );
+		if( cached != m_entries.constEnd() && cached->numVerts == numVerts && cached->numFacets == numFacets ) {
+			entry.stats = cached->stats;
+			entries.insert( mesh, cached.value() );
+			entryJobs.append( -1 );
+		} else if( jobIndex.contains( mesh ) ) {
+			entryJobs.append( jobIndex.value( mesh ) );
+		} else {
+			DzVertexCacheJob job;
+			job.mesh = mesh;
+			job.facets = mesh->getFacetsPtr();
+			job.numFacets = numFacets;
+			job.numVerts = numVerts;
+			jobIndex.insert( mesh, jobs.count() );
+			entryJobs.append( jobs.count() );
+			jobs.append( job );
+		}
+		report.entries.append( entry );
+	}
+
+	QtConcurrent::blockingMap( jobs, analyzeMesh );
+
+	for( int i = 0; i < jobs.count(); i++ ) {
+		CacheEntry cached;
+		cached.numVerts = jobs[i].numVerts;
+		cached.numFacets = jobs[i].numFacets;
+		cached.stats = jobs[i].stats;
+		entries.insert( jobs[i].mesh, cached );
+	}
+	for( int i = 0; i < report.entries.count(); i++ ) {
+		Entry &entry = report.entries[i];
+		if( entryJobs[i] >= 0 ) {
+			entry.stats = jobs[entryJobs[i]].stats;
+		}
+		report.numTris += entry.stats.numTris;
+		report.fifoMisses += entry.stats.fifoMisses;
+		report.optimizedMisses += entry.stats.optimizedMisses;
+	}
+	m_entries = entries;
+
+	report.numNodes = report.entries.count();
+	report.numAnalyzed = jobs.count();
+	qSort( report.entries.begin(), report.entries.end(), compareExcess );
+	return report;
+}
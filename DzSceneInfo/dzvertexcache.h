@@ -0,0 +1,117 @@
+/**********************************************************************
+	Copyright (C) 2002-2012 DAZ 3D, Inc. All Rights Reserved.
+
+	This file is part of the DAZ Studio SDK.
+
+	This file may be used only in accordance with the DAZ Studio SDK
+	license provided with the DAZ Studio SDK.
+
+	The contents of this file may not be disclosed to third parties,
+	copied or duplicated in any form, in whole or in part, without the
+	prior written permission of DAZ 3D, Inc, except as explicitly
+	allowed in the DAZ Studio SDK license.
+
+	See http://www.daz3d.com to contact DAZ 3D, Inc or for more
+	information about the DAZ Studio SDK.
+**********************************************************************/
+
+#ifndef DAZ_VERTEX_CACHE_H
+#define DAZ_VERTEX_CACHE_H
+
+/*****************************
+   Include files
+*****************************/
+#include <QtCore/QHash>
+#include <QtCore/QList>
+
+/****************************
+   Forward declarations
+****************************/
+class DzFacetMesh;
+class DzNode;
+class DzSceneTree;
+
+/*****************************
+   Struct definitions
+*****************************/
+/**
+	How well a mesh's facet order reuses the post-transform vertex cache.
+	Quads are split into two triangles, as they are when drawn.
+**/
+struct DzVertexCacheStats {
+	int		numTris;
+	int		numVerts;			// Vertices used by the facets
+	qint64	fifoMisses;			// getFifoSize() entry FIFO cache
+	qint64	lruMisses;			// getLruSize() entry LRU cache
+	qint64	optimizedMisses;	// FIFO cache, after reordering
+
+	DzVertexCacheStats() : numTris( 0 ), numVerts( 0 ), fifoMisses( 0 ), lruMisses( 0 ), optimizedMisses( 0 ) {}
+
+	// Average cache miss ratio : vertices transformed per triangle
+	double	getAcmr() const { return numTris ? double( fifoMisses ) / numTris : 0.0; }
+	double	getLruAcmr() const { return numTris ? double( lruMisses ) / numTris : 0.0; }
+	double	getOptimizedAcmr() const { return numTris ? double( optimizedMisses ) / numTris : 0.0; }
+	// Average transform to vertex ratio; 1 is ideal
+	double	getAtvr() const { return numVerts ? double( fifoMisses ) / numVerts : 0.0; }
+	// Fraction of the vertex transforms that reordering would save
+	double	getGain() const { return fifoMisses ? 1.0 - double( optimizedMisses ) / fifoMisses : 0.0; }
+};
+
+/*****************************
+   Class definitions
+*****************************/
+/**
+	Simulates the post-transform vertex cache over the facet order of each
+	render-visible facet mesh.
+
+	A FIFO and an LRU cache are simulated over the triangle stream. To
+	estimate what reordering would gain, the triangles are also reordered
+	with Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for
+	Vertex Locality and Reduced Overdraw", 2007), whose own FIFO simulation
+	gives the misses of the new order; a mesh already better than that gains
+	nothing. All three run in linear time.
+
+	The meshes are analyzed in parallel and the results are cached per mesh
+	until its vertex or facet count changes, so instanced nodes share one
+	analysis.
+**/
+class DzVertexCacheAnalysis {
+public:
+	struct Entry {
+		DzNode				*node;
+		DzVertexCacheStats	stats;
+
+		Entry() : node( NULL ) {}
+
+		// Vertex transforms that reordering would save
+		qint64	getExcessMisses() const { return stats.fifoMisses - stats.optimizedMisses; }
+	};
+
+	struct Report {
+		int				numNodes;
+		int				numAnalyzed;		// Meshes computed, not read from the cache
+		qint64			numTris;
+		qint64			fifoMisses;
+		qint64			optimizedMisses;
+		QList<Entry>	entries;			// Most excess misses first
+
+		Report() : numNodes( 0 ), numAnalyzed( 0 ), numTris( 0 ), fifoMisses( 0 ), optimizedMisses( 0 ) {}
+	};
+
+	Report	analyze( const DzSceneTree &tree );
+	void	clear() { m_entries.clear(); }
+
+	static int	getFifoSize() { return 16; }
+	static int	getLruSize() { return 32; }
+
+private:
+	struct CacheEntry {
+		int					numVerts;
+		int					numFacets;
+		DzVertexCacheStats	stats;
+	};
+
+	QHash<const DzFacetMesh*, CacheEntry>	m_entries;
+};
+
+#endif // DAZ_VERTEX_CACHE_H
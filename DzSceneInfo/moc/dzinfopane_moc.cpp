@@ -1,7 +1,7 @@
 /****************************************************************************
 ** Meta object code from reading C++ file 'dzinfopane.h'
 **
-** Created: Thu Mar 9 20:45:36 2017
+** Created: Sun Oct 18 22:31:07 2026
 **      by: The Qt Meta Object Compiler version 63 (Qt 4.8.1)
 **
 ** WARNING! All changes made in this file will be lost!
@@ -84,7 +84,7 @@ static const uint qt_meta_data_DzSceneInfoPaneEx[] = {
        6,       // revision
        0,       // classname
        0,    0, // classinfo
-       5,   14, // methods
+      16,   14, // methods
        0,    0, // properties
        0,    0, // enums/sets
        0,    0, // constructors
@@ -95,16 +95,33 @@ static const uint qt_meta_data_DzSceneInfoPaneEx[] = {
       19,   18,   18,   18, 0x0a,
       34,   29,   18,   18, 0x08,
       55,   18,   18,   18, 0x08,
-      70,   18,   18,   18, 0x08,
-      87,   18,   18,   18, 0x08,
+      73,   29,   18,   18, 0x08,
+     106,   18,   18,   18, 0x08,
+     129,   18,   18,   18, 0x08,
+     149,   29,   18,   18, 0x08,
+     168,   29,   18,   18, 0x08,
+     189,   18,   18,   18, 0x08,
+     204,   18,   18,   18, 0x08,
+     221,   18,   18,   18, 0x08,
+     240,   18,   18,   18, 0x08,
+     260,   18,   18,   18, 0x08,
+     275,   18,   18,   18, 0x08,
+     289,   18,   18,   18, 0x08,
+     305,   18,   18,   18, 0x08,
 
        0        // eod
 };
 
 static const char qt_meta_stringdata_DzSceneInfoPaneEx[] = {
     "DzSceneInfoPaneEx\0\0refresh()\0node\0"
-    "refreshInfo(DzNode*)\0blockRefresh()\0"
-    "unblockRefresh()\0showContextMenu(QPoint)\0"
+    "refreshInfo(DzNode*)\0nodeListChanged()\0"
+    "primarySelectionChanged(DzNode*)\0"
+    "selectionListChanged()\0visibilityChanged()\0"
+    "nodeAdded(DzNode*)\0nodeRemoved(DzNode*)\0"
+    "blockRefresh()\0unblockRefresh()\0"
+    "unblockAfterLoad()\0unblockAfterClear()\0"
+    "sampleMemory()\0cameraMoved()\0"
+    "filterChanged()\0showContextMenu(QPoint)\0"
 };
 
 void DzSceneInfoPaneEx::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
@@ -115,9 +132,20 @@ void DzSceneInfoPaneEx::qt_static_metacall(QObject *_o, QMetaObject::Call _c, in
         switch (_id) {
         case 0: _t->refresh(); break;
         case 1: _t->refreshInfo((*reinterpret_cast< DzNode*(*)>(_a[1]))); break;
-        case 2: _t->blockRefresh(); break;
-        case 3: _t->unblockRefresh(); break;
-        case 4: _t->showContextMenu((*reinterpret_cast< const QPoint(*)>(_a[1]))); break;
+        case 2: _t->nodeListChanged(); break;
+        case 3: _t->primarySelectionChanged((*reinterpret_cast< DzNode*(*)>(_a[1]))); break;
+        case 4: _t->selectionListChanged(); break;
+        case 5: _t->visibilityChanged(); break;
+        case 6: _t->nodeAdded((*reinterpret_cast< DzNode*(*)>(_a[1]))); break;
+        case 7: _t->nodeRemoved((*reinterpret_cast< DzNode*(*)>(_a[1]))); break;
+        case 8: _t->blockRefresh(); break;
+        case 9: _t->unblockRefresh(); break;
+        case 10: _t->unblockAfterLoad(); break;
+        case 11: _t->unblockAfterClear(); break;
+        case 12: _t->sampleMemory(); break;
+        case 13: _t->cameraMoved(); break;
+        case 14: _t->filterChanged(); break;
+        case 15: _t->showContextMenu((*reinterpret_cast< const QPoint(*)>(_a[1]))); break;
         default: ;
         }
     }
@@ -155,9 +183,9 @@ int DzSceneInfoPaneEx::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
     if (_id < 0)
         return _id;
     if (_c == QMetaObject::InvokeMetaMethod) {
-        if (_id < 5)
+        if (_id < 16)
             qt_static_metacall(this, _c, _id, _a);
-        _id -= 5;
+        _id -= 16;
     }
     return _id;
 }
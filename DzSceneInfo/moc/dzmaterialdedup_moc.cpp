@@ -0,0 +1,96 @@
+/****************************************************************************
+** Meta object code from reading C++ file 'dzmaterialdedup.h'
+**
+** Created: Sun Oct 18 20:41:19 2026
+**      by: The Qt Meta Object Compiler version 63 (Qt 4.8.1)
+**
+** WARNING! All changes made in this file will be lost!
+*****************************************************************************/
+
+#include "../dzmaterialdedup.h"
+#if !defined(Q_MOC_OUTPUT_REVISION)
+#error "The header file 'dzmaterialdedup.h' doesn't include <QObject>."
+#elif Q_MOC_OUTPUT_REVISION != 63
+#error "This file was generated using the moc from 4.8.1. It"
+#error "cannot be used with the include files from this version of Qt."
+#error "(The moc has changed too much.)"
+#endif
+
+QT_BEGIN_MOC_NAMESPACE
+static const uint qt_meta_data_DzMaterialDedup[] = {
+
+ // content:
+       6,       // revision
+       0,       // classname
+       0,    0, // classinfo
+       2,   14, // methods
+       0,    0, // properties
+       0,    0, // enums/sets
+       0,    0, // constructors
+       0,       // flags
+       0,       // signalCount
+
+ // slots: signature, parameters, type, tag, flags
+      17,   16,   16,   16, 0x08,
+      39,   35,   16,   16, 0x08,
+
+       0        // eod
+};
+
+static const char qt_meta_stringdata_DzMaterialDedup[] = {
+    "DzMaterialDedup\0\0propertyChanged()\0"
+    "obj\0materialDestroyed(QObject*)\0"
+};
+
+void DzMaterialDedup::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
+{
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        Q_ASSERT(staticMetaObject.cast(_o));
+        DzMaterialDedup *_t = static_cast<DzMaterialDedup *>(_o);
+        switch (_id) {
+        case 0: _t->propertyChanged(); break;
+        case 1: _t->materialDestroyed((*reinterpret_cast< QObject*(*)>(_a[1]))); break;
+        default: ;
+        }
+    }
+}
+
+const QMetaObjectExtraData DzMaterialDedup::staticMetaObjectExtraData = {
+    0,  qt_static_metacall 
+};
+
+const QMetaObject DzMaterialDedup::staticMetaObject = {
+    { &QObject::staticMetaObject, qt_meta_stringdata_DzMaterialDedup,
+      qt_meta_data_DzMaterialDedup, &staticMetaObjectExtraData }
+};
+
+#ifdef Q_NO_DATA_RELOCATION
+const QMetaObject &DzMaterialDedup::getStaticMetaObject() { return staticMetaObject; }
+#endif //Q_NO_DATA_RELOCATION
+
+const QMetaObject *DzMaterialDedup::metaObject() const
+{
+    return QObject::d_ptr->metaObject ? QObject::d_ptr->metaObject : &staticMetaObject;
+}
+
+void *DzMaterialDedup::qt_metacast(const char *_clname)
+{
+    if (!_clname) return 0;
+    if (!strcmp(_clname, qt_meta_stringdata_DzMaterialDedup))
+        return static_cast<void*>(const_cast< DzMaterialDedup*>(this));
+    return QObject::qt_metacast(_clname);
+}
+
+int DzMaterialDedup::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
+{
+    _id = QObject::qt_metacall(_c, _id, _a);
+    if (_id < 0)
+        return _id;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        if (_id < 2)
+            qt_static_metacall(this, _c, _id, _a);
+        _id -= 2;
+    }
+    return _id;
+}
+QT_END_MOC_NAMESPACE
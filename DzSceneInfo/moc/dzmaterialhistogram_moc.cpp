@@ -0,0 +1,98 @@
+/****************************************************************************
+** Meta object code from reading C++ file 'dzmaterialhistogram.h'
+**
+** Created: Sun Oct 18 21:05:12 2026
+**      by: The Qt Meta Object Compiler version 63 (Qt 4.8.1)
+**
+** WARNING! All changes made in this file will be lost!
+*****************************************************************************/
+
+#include "../dzmaterialhistogram.h"
+#if !defined(Q_MOC_OUTPUT_REVISION)
+#error "The header file 'dzmaterialhistogram.h' doesn't include <QObject>."
+#elif Q_MOC_OUTPUT_REVISION != 63
+#error "This file was generated using the moc from 4.8.1. It"
+#error "cannot be used with the include files from this version of Qt."
+#error "(The moc has changed too much.)"
+#endif
+
+QT_BEGIN_MOC_NAMESPACE
+static const uint qt_meta_data_DzMaterialHistogramCache[] = {
+
+ // content:
+       6,       // revision
+       0,       // classname
+       0,    0, // classinfo
+       3,   14, // methods
+       0,    0, // properties
+       0,    0, // enums/sets
+       0,    0, // constructors
+       0,       // flags
+       0,       // signalCount
+
+ // slots: signature, parameters, type, tag, flags
+      26,   25,   25,   25, 0x08,
+      41,   25,   25,   25, 0x08,
+      63,   59,   25,   25, 0x08,
+
+       0        // eod
+};
+
+static const char qt_meta_stringdata_DzMaterialHistogramCache[] = {
+    "DzMaterialHistogramCache\0\0shapeChanged()\0"
+    "geometryChanged()\0obj\0shapeDestroyed(QObject*)\0"
+};
+
+void DzMaterialHistogramCache::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
+{
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        Q_ASSERT(staticMetaObject.cast(_o));
+        DzMaterialHistogramCache *_t = static_cast<DzMaterialHistogramCache *>(_o);
+        switch (_id) {
+        case 0: _t->shapeChanged(); break;
+        case 1: _t->geometryChanged(); break;
+        case 2: _t->shapeDestroyed((*reinterpret_cast< QObject*(*)>(_a[1]))); break;
+        default: ;
+        }
+    }
+}
+
+const QMetaObjectExtraData DzMaterialHistogramCache::staticMetaObjectExtraData = {
+    0,  qt_static_metacall 
+};
+
+const QMetaObject DzMaterialHistogramCache::staticMetaObject = {
+    { &QObject::staticMetaObject, qt_meta_stringdata_DzMaterialHistogramCache,
+      qt_meta_data_DzMaterialHistogramCache, &staticMetaObjectExtraData }
+};
+
+#ifdef Q_NO_DATA_RELOCATION
+const QMetaObject &DzMaterialHistogramCache::getStaticMetaObject() { return staticMetaObject; }
+#endif //Q_NO_DATA_RELOCATION
+
+const QMetaObject *DzMaterialHistogramCache::metaObject() const
+{
+    return QObject::d_ptr->metaObject ? QObject::d_ptr->metaObject : &staticMetaObject;
+}
+
+void *DzMaterialHistogramCache::qt_metacast(const char *_clname)
+{
+    if (!_clname) return 0;
+    if (!strcmp(_clname, qt_meta_stringdata_DzMaterialHistogramCache))
+        return static_cast<void*>(const_cast< DzMaterialHistogramCache*>(this));
+    return QObject::qt_metacast(_clname);
+}
+
+int DzMaterialHistogramCache::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
+{
+    _id = QObject::qt_metacall(_c, _id, _a);
+    if (_id < 0)
+        return _id;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        if (_id < 3)
+            qt_static_metacall(this, _c, _id, _a);
+        _id -= 3;
+    }
+    return _id;
+}
+QT_END_MOC_NAMESPACE
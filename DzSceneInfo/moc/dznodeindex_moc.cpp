@@ -0,0 +1,93 @@
+/****************************************************************************
+** Meta object code from reading C++ file 'dznodeindex.h'
+**
+** Created: Sun Oct 18 21:00:30 2026
+**      by: The Qt Meta Object Compiler version 63 (Qt 4.8.1)
+**
+** WARNING! All changes made in this file will be lost!
+*****************************************************************************/
+
+#include "../dznodeindex.h"
+#if !defined(Q_MOC_OUTPUT_REVISION)
+#error "The header file 'dznodeindex.h' doesn't include <QObject>."
+#elif Q_MOC_OUTPUT_REVISION != 63
+#error "This file was generated using the moc from 4.8.1. It"
+#error "cannot be used with the include files from this version of Qt."
+#error "(The moc has changed too much.)"
+#endif
+
+QT_BEGIN_MOC_NAMESPACE
+static const uint qt_meta_data_DzNodeIndex[] = {
+
+ // content:
+       6,       // revision
+       0,       // classname
+       0,    0, // classinfo
+       1,   14, // methods
+       0,    0, // properties
+       0,    0, // enums/sets
+       0,    0, // constructors
+       0,       // flags
+       0,       // signalCount
+
+ // slots: signature, parameters, type, tag, flags
+      13,   12,   12,   12, 0x08,
+
+       0        // eod
+};
+
+static const char qt_meta_stringdata_DzNodeIndex[] = {
+    "DzNodeIndex\0\0nodeLabelChanged()\0"
+};
+
+void DzNodeIndex::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
+{
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        Q_ASSERT(staticMetaObject.cast(_o));
+        DzNodeIndex *_t = static_cast<DzNodeIndex *>(_o);
+        switch (_id) {
+        case 0: _t->nodeLabelChanged(); break;
+        default: ;
+        }
+    }
+}
+
+const QMetaObjectExtraData DzNodeIndex::staticMetaObjectExtraData = {
+    0,  qt_static_metacall 
+};
+
+const QMetaObject DzNodeIndex::staticMetaObject = {
+    { &QObject::staticMetaObject, qt_meta_stringdata_DzNodeIndex,
+      qt_meta_data_DzNodeIndex, &staticMetaObjectExtraData }
+};
+
+#ifdef Q_NO_DATA_RELOCATION
+const QMetaObject &DzNodeIndex::getStaticMetaObject() { return staticMetaObject; }
+#endif //Q_NO_DATA_RELOCATION
+
+const QMetaObject *DzNodeIndex::metaObject() const
+{
+    return QObject::d_ptr->metaObject ? QObject::d_ptr->metaObject : &staticMetaObject;
+}
+
+void *DzNodeIndex::qt_metacast(const char *_clname)
+{
+    if (!_clname) return 0;
+    if (!strcmp(_clname, qt_meta_stringdata_DzNodeIndex))
+        return static_cast<void*>(const_cast< DzNodeIndex*>(this));
+    return QObject::qt_metacast(_clname);
+}
+
+int DzNodeIndex::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
+{
+    _id = QObject::qt_metacall(_c, _id, _a);
+    if (_id < 0)
+        return _id;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        if (_id < 1)
+            qt_static_metacall(this, _c, _id, _a);
+        _id -= 1;
+    }
+    return _id;
+}
+QT_END_MOC_NAMESPACE
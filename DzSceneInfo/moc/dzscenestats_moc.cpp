@@ -0,0 +1,115 @@
+/****************************************************************************
+** Meta object code from reading C++ file 'dzscenestats.h'
+**
+** Created: Sun Oct 18 21:05:37 2026
+**      by: The Qt Meta Object Compiler version 63 (Qt 4.8.1)
+**
+** WARNING! All changes made in this file will be lost!
+*****************************************************************************/
+
+#include "../dzscenestats.h"
+#if !defined(Q_MOC_OUTPUT_REVISION)
+#error "The header file 'dzscenestats.h' doesn't include <QObject>."
+#elif Q_MOC_OUTPUT_REVISION != 63
+#error "This file was generated using the moc from 4.8.1. It"
+#error "cannot be used with the include files from this version of Qt."
+#error "(The moc has changed too much.)"
+#endif
+
+QT_BEGIN_MOC_NAMESPACE
+static const uint qt_meta_data_DzSceneInfoStats[] = {
+
+ // content:
+       6,       // revision
+       0,       // classname
+       0,    0, // classinfo
+       7,   14, // methods
+       0,    0, // properties
+       0,    0, // enums/sets
+       0,    0, // constructors
+       0,       // flags
+       0,       // signalCount
+
+ // slots: signature, parameters, type, tag, flags
+      39,   30,   18,   17, 0x0a,
+      61,   17,   18,   17, 0x0a,
+      89,   17,   76,   17, 0x0a,
+     105,  100,   18,   17, 0x0a,
+     126,   17,   18,   17, 0x0a,
+     144,   17,   76,   17, 0x0a,
+     159,   17,   17,   17, 0x0a,
+
+       0        // eod
+};
+
+static const char qt_meta_stringdata_DzSceneInfoStats[] = {
+    "DzSceneInfoStats\0\0QVariantMap\0sections\0"
+    "getStats(QStringList)\0getSceneInfo()\0"
+    "QVariantList\0getNodes()\0node\0"
+    "getNodeInfo(DzNode*)\0getSelectedNode()\0"
+    "getMaterials()\0invalidate()\0"
+};
+
+void DzSceneInfoStats::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
+{
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        Q_ASSERT(staticMetaObject.cast(_o));
+        DzSceneInfoStats *_t = static_cast<DzSceneInfoStats *>(_o);
+        switch (_id) {
+        case 0: { QVariantMap _r = _t->getStats((*reinterpret_cast< const QStringList(*)>(_a[1])));
+            if (_a[0]) *reinterpret_cast< QVariantMap*>(_a[0]) = _r; }  break;
+        case 1: { QVariantMap _r = _t->getSceneInfo();
+            if (_a[0]) *reinterpret_cast< QVariantMap*>(_a[0]) = _r; }  break;
+        case 2: { QVariantList _r = _t->getNodes();
+            if (_a[0]) *reinterpret_cast< QVariantList*>(_a[0]) = _r; }  break;
+        case 3: { QVariantMap _r = _t->getNodeInfo((*reinterpret_cast< DzNode*(*)>(_a[1])));
+            if (_a[0]) *reinterpret_cast< QVariantMap*>(_a[0]) = _r; }  break;
+        case 4: { QVariantMap _r = _t->getSelectedNode();
+            if (_a[0]) *reinterpret_cast< QVariantMap*>(_a[0]) = _r; }  break;
+        case 5: { QVariantList _r = _t->getMaterials();
+            if (_a[0]) *reinterpret_cast< QVariantList*>(_a[0]) = _r; }  break;
+        case 6: _t->invalidate(); break;
+        default: ;
+        }
+    }
+}
+
+const QMetaObjectExtraData DzSceneInfoStats::staticMetaObjectExtraData = {
+    0,  qt_static_metacall 
+};
+
+const QMetaObject DzSceneInfoStats::staticMetaObject = {
+    { &QObject::staticMetaObject, qt_meta_stringdata_DzSceneInfoStats,
+      qt_meta_data_DzSceneInfoStats, &staticMetaObjectExtraData }
+};
+
+#ifdef Q_NO_DATA_RELOCATION
+const QMetaObject &DzSceneInfoStats::getStaticMetaObject() { return staticMetaObject; }
+#endif //Q_NO_DATA_RELOCATION
+
+const QMetaObject *DzSceneInfoStats::metaObject() const
+{
+    return QObject::d_ptr->metaObject ? QObject::d_ptr->metaObject : &staticMetaObject;
+}
+
+void *DzSceneInfoStats::qt_metacast(const char *_clname)
+{
+    if (!_clname) return 0;
+    if (!strcmp(_clname, qt_meta_stringdata_DzSceneInfoStats))
+        return static_cast<void*>(const_cast< DzSceneInfoStats*>(this));
+    return QObject::qt_metacast(_clname);
+}
+
+int DzSceneInfoStats::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
+{
+    _id = QObject::qt_metacall(_c, _id, _a);
+    if (_id < 0)
+        return _id;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        if (_id < 7)
+            qt_static_metacall(this, _c, _id, _a);
+        _id -= 7;
+    }
+    return _id;
+}
+QT_END_MOC_NAMESPACE
@@ -0,0 +1,216 @@
+/****************************************************************************
+** Meta object code from reading C++ file 'dzstatsserver.h'
+**
+** Created: Sun Oct 18 21:32:50 2026
+**      by: The Qt Meta Object Compiler version 63 (Qt 4.8.1)
+**
+** WARNING! All changes made in this file will be lost!
+*****************************************************************************/
+
+#include "../dzstatsserver.h"
+#if !defined(Q_MOC_OUTPUT_REVISION)
+#error "The header file 'dzstatsserver.h' doesn't include <QObject>."
+#elif Q_MOC_OUTPUT_REVISION != 63
+#error "This file was generated using the moc from 4.8.1. It"
+#error "cannot be used with the include files from this version of Qt."
+#error "(The moc has changed too much.)"
+#endif
+
+QT_BEGIN_MOC_NAMESPACE
+static const uint qt_meta_data_DzStatsServerWorker[] = {
+
+ // content:
+       6,       // revision
+       0,       // classname
+       0,    0, // classinfo
+       7,   14, // methods
+       0,    0, // properties
+       0,    0, // enums/sets
+       0,    0, // constructors
+       0,       // flags
+       1,       // signalCount
+
+ // signals: signature, parameters, type, tag, flags
+      32,   21,   20,   20, 0x05,
+
+ // slots: signature, parameters, type, tag, flags
+      52,   20,   20,   20, 0x0a,
+      60,   20,   20,   20, 0x0a,
+      82,   67,   20,   20, 0x0a,
+     115,   20,   20,   20, 0x08,
+     131,   20,   20,   20, 0x08,
+     144,   20,   20,   20, 0x08,
+
+       0        // eod
+};
+
+static const char qt_meta_stringdata_DzStatsServerWorker[] = {
+    "DzStatsServerWorker\0\0numClients\0"
+    "clientsChanged(int)\0start()\0stop()\0"
+    "snapshot,delta\0publish(QVariantMap,QVariantMap)\0"
+    "newConnection()\0readClient()\0"
+    "clientDisconnected()\0"
+};
+
+void DzStatsServerWorker::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
+{
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        Q_ASSERT(staticMetaObject.cast(_o));
+        DzStatsServerWorker *_t = static_cast<DzStatsServerWorker *>(_o);
+        switch (_id) {
+        case 0: _t->clientsChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
+        case 1: _t->start(); break;
+        case 2: _t->stop(); break;
+        case 3: _t->publish((*reinterpret_cast< const QVariantMap(*)>(_a[1])), (*reinterpret_cast< const QVariantMap(*)>(_a[2]))); break;
+        case 4: _t->newConnection(); break;
+        case 5: _t->readClient(); break;
+        case 6: _t->clientDisconnected(); break;
+        default: ;
+        }
+    }
+}
+
+const QMetaObjectExtraData DzStatsServerWorker::staticMetaObjectExtraData = {
+    0,  qt_static_metacall 
+};
+
+const QMetaObject DzStatsServerWorker::staticMetaObject = {
+    { &QObject::staticMetaObject, qt_meta_stringdata_DzStatsServerWorker,
+      qt_meta_data_DzStatsServerWorker, &staticMetaObjectExtraData }
+};
+
+#ifdef Q_NO_DATA_RELOCATION
+const QMetaObject &DzStatsServerWorker::getStaticMetaObject() { return staticMetaObject; }
+#endif //Q_NO_DATA_RELOCATION
+
+const QMetaObject *DzStatsServerWorker::metaObject() const
+{
+    return QObject::d_ptr->metaObject ? QObject::d_ptr->metaObject : &staticMetaObject;
+}
+
+void *DzStatsServerWorker::qt_metacast(const char *_clname)
+{
+    if (!_clname) return 0;
+    if (!strcmp(_clname, qt_meta_stringdata_DzStatsServerWorker))
+        return static_cast<void*>(const_cast< DzStatsServerWorker*>(this));
+    return QObject::qt_metacast(_clname);
+}
+
+int DzStatsServerWorker::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
+{
+    _id = QObject::qt_metacall(_c, _id, _a);
+    if (_id < 0)
+        return _id;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        if (_id < 7)
+            qt_static_metacall(this, _c, _id, _a);
+        _id -= 7;
+    }
+    return _id;
+}
+
+// SIGNAL 0
+void DzStatsServerWorker::clientsChanged(int _t1)
+{
+    void *_a[] = { 0, const_cast<void*>(reinterpret_cast<const void*>(&_t1)) };
+    QMetaObject::activate(this, &staticMetaObject, 0, _a);
+}
+static const uint qt_meta_data_DzStatsServer[] = {
+
+ // content:
+       6,       // revision
+       0,       // classname
+       0,    0, // classinfo
+       7,   14, // methods
+       0,    0, // properties
+       0,    0, // enums/sets
+       0,    0, // constructors
+       0,       // flags
+       1,       // signalCount
+
+ // signals: signature, parameters, type, tag, flags
+      30,   15,   14,   14, 0x05,
+
+ // slots: signature, parameters, type, tag, flags
+      65,   14,   14,   14, 0x08,
+      88,   83,   14,   14, 0x08,
+     114,   14,   14,   14, 0x08,
+     129,   14,   14,   14, 0x08,
+     155,  144,   14,   14, 0x08,
+     175,   14,   14,   14, 0x08,
+
+       0        // eod
+};
+
+static const char qt_meta_stringdata_DzStatsServer[] = {
+    "DzStatsServer\0\0snapshot,delta\0"
+    "published(QVariantMap,QVariantMap)\0"
+    "nodeListChanged()\0node\0selectionChanged(DzNode*)\0"
+    "loadStarting()\0loadFinished()\0numClients\0"
+    "clientsChanged(int)\0publish()\0"
+};
+
+void DzStatsServer::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
+{
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        Q_ASSERT(staticMetaObject.cast(_o));
+        DzStatsServer *_t = static_cast<DzStatsServer *>(_o);
+        switch (_id) {
+        case 0: _t->published((*reinterpret_cast< const QVariantMap(*)>(_a[1])), (*reinterpret_cast< const QVariantMap(*)>(_a[2]))); break;
+        case 1: _t->nodeListChanged(); break;
+        case 2: _t->selectionChanged((*reinterpret_cast< DzNode*(*)>(_a[1]))); break;
+        case 3: _t->loadStarting(); break;
+        case 4: _t->loadFinished(); break;
+        case 5: _t->clientsChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
+        case 6: _t->publish(); break;
+        default: ;
+        }
+    }
+}
+
+const QMetaObjectExtraData DzStatsServer::staticMetaObjectExtraData = {
+    0,  qt_static_metacall 
+};
+
+const QMetaObject DzStatsServer::staticMetaObject = {
+    { &QObject::staticMetaObject, qt_meta_stringdata_DzStatsServer,
+      qt_meta_data_DzStatsServer, &staticMetaObjectExtraData }
+};
+
+#ifdef Q_NO_DATA_RELOCATION
+const QMetaObject &DzStatsServer::getStaticMetaObject() { return staticMetaObject; }
+#endif //Q_NO_DATA_RELOCATION
+
+const QMetaObject *DzStatsServer::metaObject() const
+{
+    return QObject::d_ptr->metaObject ? QObject::d_ptr->metaObject : &staticMetaObject;
+}
+
+void *DzStatsServer::qt_metacast(const char *_clname)
+{
+    if (!_clname) return 0;
+    if (!strcmp(_clname, qt_meta_stringdata_DzStatsServer))
+        return static_cast<void*>(const_cast< DzStatsServer*>(this));
+    return QObject::qt_metacast(_clname);
+}
+
+int DzStatsServer::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
+{
+    _id = QObject::qt_metacall(_c, _id, _a);
+    if (_id < 0)
+        return _id;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        if (_id < 7)
+            qt_static_metacall(this, _c, _id, _a);
+        _id -= 7;
+    }
+    return _id;
+}
+
+// SIGNAL 0
+void DzStatsServer::published(const QVariantMap & _t1, const QVariantMap & _t2)
+{
+    void *_a[] = { 0, const_cast<void*>(reinterpret_cast<const void*>(&_t1)), const_cast<void*>(reinterpret_cast<const void*>(&_t2)) };
+    QMetaObject::activate(this, &staticMetaObject, 0, _a);
+}
+QT_END_MOC_NAMESPACE
@@ -22,6 +22,7 @@ Include files
 
 #include "version.h"
 #include "dzinfopane.h"
+#include "dzscenestats.h"
 
 /*****************************
 Plugin Definition
@@ -35,8 +36,11 @@ DZ_PLUGIN_DESCRIPTION(
 					  "This plug-in provides a simple HTML-based display of "
 					  "extended information about the scene contents and the "
 					  "current selection. The pane updates itself whenever "
-					  "the scene or primary selection is changed."
+					  "the scene or primary selection is changed. The same "
+					  "statistics are available to scripts as structured data "
+					  "through the DzSceneInfoStats class."
 					  );
 
 DZ_PLUGIN_CLASS_GUID( DzSceneInfoPaneEx, 1FE6448D-CFE1-483e-8389-127E9017180B );
 DZ_PLUGIN_CLASS_GUID( DzSceneInfoPaneExAction, D2303DBE-9FD8-4507-AB4A-4C732E2B3886 );
+DZ_PLUGIN_CLASS_GUID( DzSceneInfoStats, 6A6E4B7A-68AA-4890-B95B-245F61D84ACD );